@@ -0,0 +1,388 @@
+#include "billiards_core.h"
+
+#include <game/Ball.hpp>
+#include <game/Physics.hpp>
+#include <game/Scenario.hpp>
+#include <game/ShotDataset.hpp>
+#include <game/ShotCache.hpp>
+#include <game/ShotSimulator.hpp>
+#include <game/Table.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct bc_table
+{
+    explicit bc_table(const bc_table_desc &desc)
+        : desc(desc), physics(desc.width, desc.height, desc.friction)
+    {
+        geometry.width = desc.width;
+        geometry.height = desc.height;
+        geometry.pocketRadius = desc.pocket_radius;
+    }
+
+    bc_table_desc desc;
+    TableGeometry geometry;
+    Physics physics;
+    std::vector<Ball> balls;
+};
+
+struct bc_dataset
+{
+    ShotDatasetWriter writer;
+};
+
+namespace
+{
+    ShotParams ToShotParams(const bc_shot &shot)
+    {
+        float degrees = std::fmod(shot.angle_deg, 360.0f);
+        if (degrees < 0.0f)
+            degrees += 360.0f;
+
+        ShotParams params;
+        params.angle = static_cast<int32_t>(std::lround(degrees * 100.0f)) % 36000;
+        params.power = static_cast<int32_t>(std::lround(std::clamp(shot.power, 0.0f, 1.0f) * 256.0f));
+        params.offsetX = static_cast<int32_t>(std::lround(std::clamp(shot.offset_x, -0.8f, 0.8f) * 256.0f));
+        params.offsetY = static_cast<int32_t>(std::lround(std::clamp(shot.offset_y, -0.8f, 0.8f) * 256.0f));
+        return params;
+    }
+
+    bool AnyMoving(const std::vector<Ball> &balls)
+    {
+        return std::any_of(balls.begin(), balls.end(), [](const Ball &ball)
+                           { return ball.isMoving(); });
+    }
+
+    // fn(i) для i из [0, count), раздаётся потокам из общего счётчика
+    template <typename Fn>
+    int ParallelFor(uint32_t count, uint32_t threads, Fn &&fn)
+    {
+        std::atomic<uint32_t> next{0};
+        std::atomic<bool> failed{false};
+        auto worker = [&]()
+        {
+            try
+            {
+                for (uint32_t i = next++; i < count; i = next++)
+                    fn(i);
+            }
+            catch (...)
+            {
+                failed = true;
+            }
+        };
+
+        uint32_t threadCount = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+        threadCount = std::max(1u, std::min(threadCount, count));
+        try
+        {
+            std::vector<std::thread> pool;
+            for (uint32_t t = 1; t < threadCount; ++t)
+                pool.emplace_back(worker);
+            worker();
+            for (auto &thread : pool)
+                thread.join();
+        }
+        catch (...)
+        {
+            return BC_ERROR_INTERNAL;
+        }
+        return failed ? BC_ERROR_INTERNAL : BC_OK;
+    }
+}
+
+extern "C" {
+
+uint32_t bc_version(void)
+{
+    return BC_VERSION;
+}
+
+void bc_table_desc_default(bc_table_desc *desc)
+{
+    if (!desc)
+        return;
+
+    const TableGeometry geometry;
+    desc->width = geometry.width;
+    desc->height = geometry.height;
+    desc->pocket_radius = geometry.pocketRadius;
+    desc->friction = 0.1f;
+    desc->ball_radius = 0.05f;
+    desc->ball_mass = 1.0f;
+    desc->max_force = Cue().getMaxForce();
+}
+
+bc_table *bc_table_create(const bc_table_desc *desc)
+{
+    bc_table_desc values;
+    if (desc)
+        values = *desc;
+    else
+        bc_table_desc_default(&values);
+
+    if (values.width <= 0.0f || values.height <= 0.0f || values.ball_radius <= 0.0f || values.ball_mass <= 0.0f)
+        return nullptr;
+
+    try
+    {
+        // Владение передаётся вызывающему только после успешной расстановки
+        auto table = std::make_unique<bc_table>(values);
+        table->balls = RackBalls(values.ball_radius, values.ball_mass);
+        return table.release();
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+void bc_table_destroy(bc_table *table)
+{
+    delete table;
+}
+
+int bc_table_rack(bc_table *table)
+{
+    if (!table)
+        return BC_ERROR_INVALID_ARGUMENT;
+
+    try
+    {
+        table->balls = RackBalls(table->desc.ball_radius, table->desc.ball_mass);
+        table->physics.ResetContacts();
+    }
+    catch (...)
+    {
+        return BC_ERROR_INTERNAL;
+    }
+    return BC_OK;
+}
+
+int bc_table_set_balls(bc_table *table, const float *positions, uint32_t count)
+{
+    if (!table || (!positions && count > 0) || count > BC_MAX_BALLS)
+        return BC_ERROR_INVALID_ARGUMENT;
+
+    try
+    {
+        table->balls.clear();
+        table->balls.reserve(count);
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            const glm::vec3 position(positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2]);
+            table->balls.emplace_back(position, table->desc.ball_radius, table->desc.ball_mass);
+        }
+        table->physics.ResetContacts();
+    }
+    catch (...)
+    {
+        return BC_ERROR_INTERNAL;
+    }
+    return BC_OK;
+}
+
+uint32_t bc_table_ball_count(const bc_table *table)
+{
+    return table ? static_cast<uint32_t>(table->balls.size()) : 0;
+}
+
+int bc_table_shoot(bc_table *table, const bc_shot *shot)
+{
+    if (!table || !shot || table->balls.empty() || IsPocketed(table->balls[0]))
+        return BC_ERROR_INVALID_ARGUMENT;
+    if (AnyMoving(table->balls))
+        return BC_ERROR_BALLS_MOVING;
+
+    ShotSimulator::ApplyShot(table->balls[0], ToShotParams(*shot), table->desc.max_force);
+    return BC_OK;
+}
+
+uint32_t bc_table_step(bc_table *table, float dt, uint32_t steps)
+{
+    if (!table || dt <= 0.0f)
+        return 0;
+
+    uint32_t pocketed = 0;
+    for (uint32_t i = 0; i < steps; ++i)
+    {
+        table->physics.Update(table->balls, dt);
+        pocketed |= CollectPocketed(table->balls, table->geometry);
+    }
+    return pocketed;
+}
+
+int bc_table_is_moving(const bc_table *table)
+{
+    return table && AnyMoving(table->balls) ? 1 : 0;
+}
+
+uint32_t bc_table_read_state(const bc_table *table, float *positions, float *velocities,
+                             float *rotations, uint32_t *pocketed_mask, uint32_t capacity)
+{
+    if (!table)
+        return 0;
+
+    const uint32_t count = static_cast<uint32_t>(table->balls.size());
+    const uint32_t written = std::min(count, capacity);
+    uint32_t mask = 0;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const Ball &ball = table->balls[i];
+        if (IsPocketed(ball) && i < 32)
+            mask |= 1u << i;
+        if (i >= written)
+            continue;
+
+        if (positions)
+            std::memcpy(positions + i * 3, &ball.getPosition()[0], 3 * sizeof(float));
+        if (velocities)
+            std::memcpy(velocities + i * 3, &ball.getVelocity()[0], 3 * sizeof(float));
+        if (rotations)
+        {
+            const glm::quat &rotation = ball.getRotation();
+            rotations[i * 4 + 0] = rotation.w;
+            rotations[i * 4 + 1] = rotation.x;
+            rotations[i * 4 + 2] = rotation.y;
+            rotations[i * 4 + 3] = rotation.z;
+        }
+    }
+    if (pocketed_mask)
+        *pocketed_mask = mask;
+    return count;
+}
+
+int bc_simulate_shots(const bc_table *table, const bc_shot *shots, uint32_t shot_count,
+                      bc_shot_result *results, float *final_positions, uint32_t threads)
+{
+    if (!table || (shot_count > 0 && (!shots || !results)))
+        return BC_ERROR_INVALID_ARGUMENT;
+    if (AnyMoving(table->balls))
+        return BC_ERROR_BALLS_MOVING;
+
+    const ShotSimulator simulator(table->geometry, table->desc.friction, table->desc.max_force);
+    const size_t ballCount = table->balls.size();
+
+    // Каждый удар пишет только в свои ячейки результата
+    return ParallelFor(shot_count, threads, [&](uint32_t i)
+                       {
+        const ShotOutcome outcome = simulator.Simulate(table->balls, ToShotParams(shots[i]));
+        results[i].pocketed_mask = outcome.pocketedMask;
+        results[i].first_contact = outcome.firstContact;
+        results[i].duration = outcome.duration;
+        if (final_positions)
+        {
+            float *out = final_positions + static_cast<size_t>(i) * ballCount * 3;
+            for (size_t b = 0; b < ballCount; ++b)
+                std::memcpy(out + b * 3, &outcome.finalPositions[b][0], 3 * sizeof(float));
+        } });
+}
+
+bc_dataset *bc_dataset_open(const char *path, uint32_t queue_chunks)
+{
+    if (!path)
+        return nullptr;
+
+    try
+    {
+        bc_dataset *dataset = new bc_dataset();
+        if (!dataset->writer.Open(path, queue_chunks ? queue_chunks : 4))
+        {
+            delete dataset;
+            return nullptr;
+        }
+        return dataset;
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
+
+int bc_dataset_close(bc_dataset *dataset)
+{
+    if (!dataset)
+        return BC_ERROR_INVALID_ARGUMENT;
+
+    const bool ok = dataset->writer.Close();
+    delete dataset;
+    return ok ? BC_OK : BC_ERROR_IO;
+}
+
+int bc_simulate_shots_to_dataset(const bc_table *table, const bc_shot *shots, uint32_t shot_count,
+                                 bc_dataset *dataset, uint32_t threads)
+{
+    if (!table || !dataset || (shot_count > 0 && !shots))
+        return BC_ERROR_INVALID_ARGUMENT;
+    if (AnyMoving(table->balls))
+        return BC_ERROR_BALLS_MOVING;
+
+    const ShotSimulator simulator(table->geometry, table->desc.friction, table->desc.max_force);
+    return ParallelFor(shot_count, threads, [&](uint32_t i)
+                       {
+        const ShotParams shot = ToShotParams(shots[i]);
+        dataset->writer.Append(table->balls, shot, simulator.Simulate(table->balls, shot)); });
+}
+
+int bc_evaluate_scenarios(const bc_table *table, const char *path, bc_shot_result *results,
+                          uint64_t capacity, uint64_t *evaluated, uint32_t threads)
+{
+    if (evaluated)
+        *evaluated = 0;
+    if (!table || !path || (capacity > 0 && !results))
+        return BC_ERROR_INVALID_ARGUMENT;
+
+    std::atomic<bool> failed{false};
+    try
+    {
+        ScenarioReader reader;
+        if (!reader.Open(path))
+            return BC_ERROR_IO;
+
+        const ShotSimulator simulator(table->geometry, table->desc.friction, table->desc.max_force);
+        const uint64_t count = std::min(capacity, reader.RecordCount());
+        const float ballRadius = reader.BallRadius();
+
+        // Диапазон записей — примерно 64 КБ отображения
+        constexpr size_t kSpanRecords = 64 * 1024 / sizeof(ScenarioRecord);
+        reader.ForEachSpan(threads, kSpanRecords, count, [&](size_t, uint64_t first, const ScenarioRecord *records, size_t size)
+                           {
+            try
+            {
+                std::vector<Ball> balls;
+                for (size_t i = 0; i < size; ++i)
+                {
+                    records[i].ToBalls(ballRadius, table->desc.ball_mass, balls);
+                    bc_shot_result &result = results[first + i];
+                    if (balls.empty() || IsPocketed(balls[0]))
+                    {
+                        result = {0, -1, 0.0f};
+                        continue;
+                    }
+                    const ShotOutcome outcome = simulator.Simulate(balls, records[i].shot);
+                    result.pocketed_mask = outcome.pocketedMask;
+                    result.first_contact = outcome.firstContact;
+                    result.duration = outcome.duration;
+                }
+            }
+            catch (...)
+            {
+                failed = true;
+            } });
+
+        if (evaluated)
+            *evaluated = count;
+    }
+    catch (...)
+    {
+        return BC_ERROR_INTERNAL;
+    }
+    return failed ? BC_ERROR_INTERNAL : BC_OK;
+}
+
+} // extern "C"
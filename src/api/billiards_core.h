@@ -0,0 +1,144 @@
+#ifndef BILLIARDS_CORE_H
+#define BILLIARDS_CORE_H
+
+/*
+ * C API симуляции бильярда (без GL и GLFW) для встраивания в другие языки.
+ *
+ * Все функции потокобезопасны для разных столов; один стол одновременно
+ * используется только из одного потока. Состояние пишется прямо в буферы
+ * вызывающего, библиотека не выделяет память под результаты.
+ * Координаты: стол в плоскости XZ, центр в начале координат, Y вверх.
+ */
+
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(BILLIARDS_CORE_SHARED)
+#ifdef BILLIARDS_CORE_BUILD
+#define BC_API __declspec(dllexport)
+#else
+#define BC_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__) && defined(BILLIARDS_CORE_SHARED)
+#define BC_API __attribute__((visibility("default")))
+#else
+#define BC_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BC_VERSION 1
+
+/* Больше шаров не помещается в 32-битную маску забитых (pocketed_mask) */
+#define BC_MAX_BALLS 32
+
+/* Коды возврата */
+#define BC_OK 0
+#define BC_ERROR_INVALID_ARGUMENT (-1)
+#define BC_ERROR_BALLS_MOVING (-2)
+#define BC_ERROR_INTERNAL (-3)
+#define BC_ERROR_IO (-4)
+
+typedef struct bc_table bc_table;
+typedef struct bc_dataset bc_dataset;
+
+/* Параметры стола; bc_table_desc_default() заполняет значения игры */
+typedef struct bc_table_desc
+{
+    float width;         /* Размер поля по X, м */
+    float height;        /* Размер поля по Z, м */
+    float pocket_radius; /* Радиус лунки, м */
+    float friction;      /* Замедление шаров, м/с^2 */
+    float ball_radius;
+    float ball_mass;
+    float max_force;     /* Импульс при силе удара 1 */
+} bc_table_desc;
+
+/* Удар по битку (шар 0) */
+typedef struct bc_shot
+{
+    float angle_deg; /* Направление в плоскости стола от оси +X к +Z */
+    float power;     /* 0..1 */
+    float offset_x;  /* Смещение точки удара в радиусах шара, -0.8..0.8 */
+    float offset_y;
+} bc_shot;
+
+typedef struct bc_shot_result
+{
+    uint32_t pocketed_mask; /* Бит i — шар i забит этим ударом */
+    int32_t first_contact;  /* Первый шар, сдвинутый битком, или -1 */
+    float duration;         /* Время до остановки всех шаров, с */
+} bc_shot_result;
+
+BC_API uint32_t bc_version(void);
+
+BC_API void bc_table_desc_default(bc_table_desc *desc);
+
+/* desc == NULL — параметры по умолчанию. Стол создаётся со стандартной расстановкой. */
+BC_API bc_table *bc_table_create(const bc_table_desc *desc);
+BC_API void bc_table_destroy(bc_table *table);
+
+/* Стандартная расстановка: биток и 15 шаров треугольником */
+BC_API int bc_table_rack(bc_table *table);
+
+/* Произвольная расстановка: positions — count * 3 float (x, y, z), шары неподвижны.
+   count > BC_MAX_BALLS — BC_ERROR_INVALID_ARGUMENT */
+BC_API int bc_table_set_balls(bc_table *table, const float *positions, uint32_t count);
+
+BC_API uint32_t bc_table_ball_count(const bc_table *table);
+
+/* Удар по битку; BC_ERROR_BALLS_MOVING, если шары ещё катятся */
+BC_API int bc_table_shoot(bc_table *table, const bc_shot *shot);
+
+/* steps шагов по dt секунд; возвращает маску шаров, забитых за эти шаги */
+BC_API uint32_t bc_table_step(bc_table *table, float dt, uint32_t steps);
+
+/* 1 — хотя бы один шар движется */
+BC_API int bc_table_is_moving(const bc_table *table);
+
+/*
+ * Копирует состояние не более чем capacity шаров в буферы вызывающего:
+ * positions и velocities — по 3 float на шар, rotations — кватернион (w, x, y, z).
+ * Любой буфер может быть NULL. pocketed_mask может быть NULL.
+ * Возвращает число шаров на столе (может быть больше capacity).
+ */
+BC_API uint32_t bc_table_read_state(const bc_table *table, float *positions, float *velocities,
+                                    float *rotations, uint32_t *pocketed_mask, uint32_t capacity);
+
+/*
+ * Пакетная симуляция ударов из текущего (неподвижного) состояния стола; стол не меняется.
+ * results — shot_count элементов. final_positions — shot_count * ball_count * 3 float или NULL.
+ * threads == 0 — по числу ядер.
+ */
+BC_API int bc_simulate_shots(const bc_table *table, const bc_shot *shots, uint32_t shot_count,
+                             bc_shot_result *results, float *final_positions, uint32_t threads);
+
+/*
+ * Набор данных для обучения (ShotDatasetWriter, src/game/ShotDataset.hpp): признаки и итог
+ * каждого удара по столбцам. Блоки сжимаются и пишутся фоновым потоком; queue_chunks —
+ * сколько заполненных блоков (по 4096 ударов) может ждать записи, 0 — по умолчанию.
+ */
+BC_API bc_dataset *bc_dataset_open(const char *path, uint32_t queue_chunks);
+
+/* Дописывает остаток и закрывает файл; BC_ERROR_IO, если запись не удалась */
+BC_API int bc_dataset_close(bc_dataset *dataset);
+
+/* Как bc_simulate_shots, но итоги ударов добавляются строками в dataset */
+BC_API int bc_simulate_shots_to_dataset(const bc_table *table, const bc_shot *shots, uint32_t shot_count,
+                                        bc_dataset *dataset, uint32_t threads);
+
+/*
+ * Прогон файла сценариев (ScenarioWriter, src/game/Scenario.hpp): расстановка и удар на запись.
+ * Файл отображается в память и читается без копирования; параметры стола берутся из table,
+ * радиус шара — из файла. results — capacity элементов, заполняются первые min(capacity, N).
+ * evaluated (может быть NULL) — число обработанных записей. threads == 0 — по числу ядер.
+ */
+BC_API int bc_evaluate_scenarios(const bc_table *table, const char *path, bc_shot_result *results,
+                                 uint64_t capacity, uint64_t *evaluated, uint32_t threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BILLIARDS_CORE_H */
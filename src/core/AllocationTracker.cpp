@@ -0,0 +1,94 @@
+// Замена глобальных operator new/delete для AllocationTracker.
+// Подключается к сборке только при BILLIARDS_TRACK_ALLOCATIONS (см. CMakeLists.txt).
+#include "AllocationTracker.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    void *AllocateTracked(size_t size)
+    {
+        AllocationTracker::OnAllocate(size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void *AllocateTrackedAligned(size_t size, std::align_val_t alignment)
+    {
+        AllocationTracker::OnAllocate(size);
+        const size_t align = static_cast<size_t>(alignment);
+#ifdef _WIN32
+        return _aligned_malloc(size ? size : 1, align);
+#else
+        // aligned_alloc требует размер, кратный выравниванию
+        const size_t rounded = ((size ? size : 1) + align - 1) / align * align;
+        return std::aligned_alloc(align, rounded);
+#endif
+    }
+
+    void FreeTracked(void *pointer)
+    {
+        if (!pointer)
+            return;
+        AllocationTracker::OnDeallocate();
+        std::free(pointer);
+    }
+
+    void FreeTrackedAligned(void *pointer)
+    {
+        if (!pointer)
+            return;
+        AllocationTracker::OnDeallocate();
+#ifdef _WIN32
+        _aligned_free(pointer);
+#else
+        std::free(pointer);
+#endif
+    }
+}
+
+void *operator new(size_t size)
+{
+    if (void *pointer = AllocateTracked(size))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+    return AllocateTracked(size);
+}
+
+void *operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return AllocateTracked(size);
+}
+
+void *operator new(size_t size, std::align_val_t alignment)
+{
+    if (void *pointer = AllocateTrackedAligned(size, alignment))
+        return pointer;
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size, std::align_val_t alignment)
+{
+    return operator new(size, alignment);
+}
+
+void operator delete(void *pointer) noexcept { FreeTracked(pointer); }
+void operator delete[](void *pointer) noexcept { FreeTracked(pointer); }
+void operator delete(void *pointer, size_t) noexcept { FreeTracked(pointer); }
+void operator delete[](void *pointer, size_t) noexcept { FreeTracked(pointer); }
+void operator delete(void *pointer, const std::nothrow_t &) noexcept { FreeTracked(pointer); }
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept { FreeTracked(pointer); }
+
+void operator delete(void *pointer, std::align_val_t) noexcept { FreeTrackedAligned(pointer); }
+void operator delete[](void *pointer, std::align_val_t) noexcept { FreeTrackedAligned(pointer); }
+void operator delete(void *pointer, size_t, std::align_val_t) noexcept { FreeTrackedAligned(pointer); }
+void operator delete[](void *pointer, size_t, std::align_val_t) noexcept { FreeTrackedAligned(pointer); }
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Счётчик глобальных new/delete текущего потока — для проверки, что установившийся кадр
+// не трогает кучу. Считает только в сборке с BILLIARDS_TRACK_ALLOCATIONS: тогда operator new
+// и operator delete заменяются в AllocationTracker.cpp, иначе счётчики всегда нулевые.
+class AllocationTracker
+{
+public:
+#ifdef BILLIARDS_TRACK_ALLOCATIONS
+    static constexpr bool kEnabled = true;
+#else
+    static constexpr bool kEnabled = false;
+#endif
+
+    static uint64_t Allocations() { return allocations; }
+    static uint64_t Deallocations() { return deallocations; }
+    static uint64_t AllocatedBytes() { return allocatedBytes; }
+
+    static void OnAllocate(size_t size)
+    {
+        ++allocations;
+        allocatedBytes += size;
+    }
+    static void OnDeallocate() { ++deallocations; }
+
+private:
+    static inline thread_local uint64_t allocations = 0;
+    static inline thread_local uint64_t deallocations = 0;
+    static inline thread_local uint64_t allocatedBytes = 0;
+};
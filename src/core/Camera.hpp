@@ -2,6 +2,7 @@
 
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
+#include <cstdint>
 
 enum class CameraMovement
 {
@@ -25,6 +26,9 @@ public:
     float getZoom() const;
     glm::vec3 getPosition() const;
 
+    // Счётчик изменений положения и ориентации (для перерисовки по требованию)
+    uint64_t getRevision() const { return m_revision; }
+
 protected:
     void updateCameraVectors();
 
@@ -42,6 +46,8 @@ private:
     float m_movementSpeed = 2.5f;
     float m_mouseSensitivity = 0.1f;
     float m_zoom = 45.0f;
+
+    uint64_t m_revision = 0;
 };
 
 Camera::Camera(glm::vec3 position, glm::vec3 up, float yaw, float pitch)
@@ -65,6 +71,7 @@ void Camera::processKeyboard(CameraMovement direction, float deltaTime)
         m_position -= m_right * velocity;
     if (direction == CameraMovement::RIGHT)
         m_position += m_right * velocity;
+    ++m_revision;
 }
 
 void Camera::processMouseMovement(float xoffset, float yoffset, bool constrainPitch)
@@ -82,6 +89,7 @@ void Camera::processMouseMovement(float xoffset, float yoffset, bool constrainPi
     }
 
     updateCameraVectors();
+    ++m_revision;
 }
 
 glm::mat4 Camera::getViewMatrix() const
@@ -97,6 +105,7 @@ glm::mat4 Camera::getProjectionMatrix(float aspect) const
 void Camera::processMouseScroll(float yoffset)
 {
     m_zoom = glm::clamp(m_zoom - yoffset, 1.0f, 45.0f);
+    ++m_revision;
 }
 
 float Camera::getZoom() const
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Лёгкое сжатие столбца 32-битных значений. Для каждого столбца выбирается самое короткое
+// из кодирований: как есть, varint, дельта к предыдущему значению + varint, серии (RLE).
+// Целые кодируются zigzag, у float вместо разности берётся XOR соседних значений —
+// близкие числа дают короткий varint.
+namespace ColumnCodec
+{
+    enum class Kind : uint8_t
+    {
+        Int,
+        Float,
+    };
+
+    enum class Encoding : uint8_t
+    {
+        Plain = 0, // 4 байта на значение
+        Varint,
+        Delta,
+        RunLength, // Пары (значение, длина серии)
+    };
+
+    inline uint32_t ZigZag(uint32_t value)
+    {
+        const int32_t signedValue = static_cast<int32_t>(value);
+        return (static_cast<uint32_t>(signedValue) << 1) ^ static_cast<uint32_t>(signedValue >> 31);
+    }
+
+    inline uint32_t UnZigZag(uint32_t value)
+    {
+        return (value >> 1) ^ (0u - (value & 1u));
+    }
+
+    inline size_t VarintSize(uint32_t value)
+    {
+        size_t size = 1;
+        while (value >= 0x80)
+        {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+
+    inline void PutVarint(std::vector<uint8_t> &out, uint32_t value)
+    {
+        while (value >= 0x80)
+        {
+            out.push_back(static_cast<uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    inline bool GetVarint(const uint8_t *&data, const uint8_t *end, uint32_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 35 && data < end; shift += 7)
+        {
+            const uint8_t byte = *data++;
+            value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+            if (!(byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    // Значение без учёта соседей: для целых — zigzag, у float порядок бит сохраняется
+    inline uint32_t Single(Kind kind, uint32_t value)
+    {
+        return kind == Kind::Int ? ZigZag(value) : value;
+    }
+
+    inline uint32_t FromSingle(Kind kind, uint32_t value)
+    {
+        return kind == Kind::Int ? UnZigZag(value) : value;
+    }
+
+    inline uint32_t Difference(Kind kind, uint32_t value, uint32_t previous)
+    {
+        return kind == Kind::Int ? ZigZag(value - previous) : value ^ previous;
+    }
+
+    inline uint32_t FromDifference(Kind kind, uint32_t difference, uint32_t previous)
+    {
+        return kind == Kind::Int ? UnZigZag(difference) + previous : difference ^ previous;
+    }
+
+    // Дописывает закодированный столбец в out; возвращает выбранное кодирование
+    inline Encoding Encode(Kind kind, const uint32_t *values, size_t count, std::vector<uint8_t> &out)
+    {
+        // Размеры всех вариантов считаются за один проход, кодируется только лучший
+        size_t varintSize = 0, deltaSize = 0, runSize = 0;
+        uint32_t previous = 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            varintSize += VarintSize(Single(kind, values[i]));
+            deltaSize += VarintSize(Difference(kind, values[i], previous));
+            if (i == 0 || values[i] != previous)
+            {
+                size_t run = 1;
+                while (i + run < count && values[i + run] == values[i])
+                    ++run;
+                runSize += VarintSize(Single(kind, values[i])) + VarintSize(static_cast<uint32_t>(run));
+            }
+            previous = values[i];
+        }
+
+        Encoding encoding = Encoding::Plain;
+        size_t best = count * sizeof(uint32_t);
+        if (varintSize < best)
+        {
+            encoding = Encoding::Varint;
+            best = varintSize;
+        }
+        if (deltaSize < best)
+        {
+            encoding = Encoding::Delta;
+            best = deltaSize;
+        }
+        if (runSize < best)
+        {
+            encoding = Encoding::RunLength;
+            best = runSize;
+        }
+
+        out.reserve(out.size() + best);
+        previous = 0;
+        switch (encoding)
+        {
+        case Encoding::Plain:
+        {
+            const size_t offset = out.size();
+            out.resize(offset + count * sizeof(uint32_t));
+            std::memcpy(out.data() + offset, values, count * sizeof(uint32_t));
+            break;
+        }
+        case Encoding::Varint:
+            for (size_t i = 0; i < count; ++i)
+                PutVarint(out, Single(kind, values[i]));
+            break;
+        case Encoding::Delta:
+            for (size_t i = 0; i < count; ++i)
+            {
+                PutVarint(out, Difference(kind, values[i], previous));
+                previous = values[i];
+            }
+            break;
+        case Encoding::RunLength:
+            for (size_t i = 0; i < count;)
+            {
+                size_t run = 1;
+                while (i + run < count && values[i + run] == values[i])
+                    ++run;
+                PutVarint(out, Single(kind, values[i]));
+                PutVarint(out, static_cast<uint32_t>(run));
+                i += run;
+            }
+            break;
+        }
+        return encoding;
+    }
+
+    // Ровно count значений из size байт; false — данные повреждены
+    inline bool Decode(Kind kind, Encoding encoding, const uint8_t *data, size_t size, uint32_t *values, size_t count)
+    {
+        const uint8_t *end = data + size;
+        uint32_t previous = 0;
+        uint32_t value = 0;
+        switch (encoding)
+        {
+        case Encoding::Plain:
+            if (size != count * sizeof(uint32_t))
+                return false;
+            std::memcpy(values, data, size);
+            return true;
+        case Encoding::Varint:
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!GetVarint(data, end, value))
+                    return false;
+                values[i] = FromSingle(kind, value);
+            }
+            break;
+        case Encoding::Delta:
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (!GetVarint(data, end, value))
+                    return false;
+                previous = values[i] = FromDifference(kind, value, previous);
+            }
+            break;
+        case Encoding::RunLength:
+            for (size_t i = 0; i < count;)
+            {
+                uint32_t run = 0;
+                if (!GetVarint(data, end, value) || !GetVarint(data, end, run) || run == 0 || run > count - i)
+                    return false;
+                value = FromSingle(kind, value);
+                for (uint32_t r = 0; r < run; ++r)
+                    values[i++] = value;
+            }
+            break;
+        default:
+            return false;
+        }
+        return data == end;
+    }
+}
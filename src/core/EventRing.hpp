@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+// Ограниченная очередь без блокировок на несколько писателей и читателей (схема Вьюкова:
+// у каждой ячейки свой счётчик последовательности). Писатель никогда не ждёт: если очередь
+// полна, событие отбрасывается и учитывается в Dropped(), чтобы медленный читатель не
+// тормозил симуляцию.
+template <typename T>
+class EventRing
+{
+    static_assert(std::is_trivially_copyable<T>::value, "EventRing stores plain event records");
+
+public:
+    // Ёмкость округляется вверх до степени двойки
+    explicit EventRing(size_t capacity);
+
+    EventRing(const EventRing &) = delete;
+    EventRing &operator=(const EventRing &) = delete;
+
+    bool TryPush(const T &value);
+    bool TryPop(T &value);
+
+    // fn(const T&) для накопившихся событий, не больше maxEvents; возвращает их число
+    template <typename Fn>
+    size_t Drain(Fn &&fn, size_t maxEvents = SIZE_MAX);
+
+    size_t Capacity() const { return mask + 1; }
+    uint64_t Pushed() const { return pushed.load(std::memory_order_relaxed); }
+    uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t mask = 0;
+
+    // Позиции писателей и читателей — в разных строках кэша
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+    alignas(64) std::atomic<uint64_t> pushed{0};
+    std::atomic<uint64_t> dropped{0};
+};
+
+template <typename T>
+EventRing<T>::EventRing(size_t capacity)
+{
+    size_t size = 2;
+    while (size < capacity)
+        size <<= 1;
+    mask = size - 1;
+    slots.reset(new Slot[size]);
+    for (size_t i = 0; i < size; ++i)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template <typename T>
+bool EventRing<T>::TryPush(const T &value)
+{
+    size_t position = head.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot &slot = slots[position & mask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0)
+        {
+            // Ячейка свободна — занимаем позицию; проигравший в гонке берёт следующую
+            if (head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                slot.value = value;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                pushed.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            // Читатель ещё не освободил ячейку круг назад — очередь полна
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        else
+        {
+            position = head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+bool EventRing<T>::TryPop(T &value)
+{
+    size_t position = tail.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        Slot &slot = slots[position & mask];
+        const size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+        if (difference == 0)
+        {
+            if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+            {
+                value = slot.value;
+                // Ячейка снова доступна писателю на следующем круге
+                slot.sequence.store(position + mask + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (difference < 0)
+        {
+            return false; // Пусто
+        }
+        else
+        {
+            position = tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+template <typename T>
+template <typename Fn>
+size_t EventRing<T>::Drain(Fn &&fn, size_t maxEvents)
+{
+    size_t count = 0;
+    T value;
+    while (count < maxEvents && TryPop(value))
+    {
+        fn(value);
+        ++count;
+    }
+    return count;
+}
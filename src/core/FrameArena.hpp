@@ -0,0 +1,107 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Линейный аллокатор временных данных кадра: выделение — сдвиг указателя, освобождение —
+// Reset() в начале следующего кадра. Если кадру не хватило блока, остаток берётся из кучи,
+// а при Reset() блок вырастает до пикового объёма, так что дальше кадры обходятся без аллокаций.
+// К моменту Reset() все выделенные из арены объекты должны быть уничтожены.
+class FrameArena
+{
+public:
+    explicit FrameArena(size_t capacity = 64 * 1024);
+
+    FrameArena(const FrameArena &) = delete;
+    FrameArena &operator=(const FrameArena &) = delete;
+
+    void *Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T *AllocateArray(size_t count) { return static_cast<T *>(Allocate(count * sizeof(T), alignof(T))); }
+
+    void Reset();
+
+    size_t Used() const { return offset + overflowBytes; }
+    size_t Capacity() const { return capacity; }
+    size_t Peak() const { return peak; }
+
+private:
+    std::unique_ptr<unsigned char[]> block;
+    size_t capacity = 0;
+    size_t offset = 0;
+
+    // Выделения сверх блока до следующего Reset()
+    std::vector<std::unique_ptr<unsigned char[]>> overflow;
+    size_t overflowBytes = 0;
+    size_t peak = 0;
+};
+
+// STL-аллокатор поверх FrameArena: deallocate ничего не делает, память возвращается в Reset()
+template <typename T>
+class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(FrameArena &arena) : arena(&arena) {}
+
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t count) { return arena->AllocateArray<T>(count); }
+    void deallocate(T *, size_t) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &other) const { return arena != other.arena; }
+
+private:
+    template <typename U>
+    friend class ArenaAllocator;
+
+    FrameArena *arena;
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+inline FrameArena::FrameArena(size_t capacity)
+    : block(new unsigned char[capacity]), capacity(capacity)
+{
+}
+
+inline void *FrameArena::Allocate(size_t size, size_t alignment)
+{
+    const uintptr_t base = reinterpret_cast<uintptr_t>(block.get());
+    const uintptr_t aligned = (base + offset + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    const size_t end = static_cast<size_t>(aligned - base) + size;
+    if (end <= capacity)
+    {
+        offset = end;
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    // Блок исчерпан — отдельное выделение из кучи, учитываемое при росте блока
+    overflow.emplace_back(new unsigned char[size + alignment]);
+    overflowBytes += size + alignment;
+    const uintptr_t raw = reinterpret_cast<uintptr_t>(overflow.back().get());
+    return reinterpret_cast<void *>((raw + alignment - 1) & ~(uintptr_t(alignment) - 1));
+}
+
+inline void FrameArena::Reset()
+{
+    peak = std::max(peak, Used());
+    if (overflowBytes > 0)
+    {
+        capacity = std::max(capacity * 2, peak);
+        block.reset(new unsigned char[capacity]);
+        overflow.clear();
+        overflowBytes = 0;
+    }
+    offset = 0;
+}
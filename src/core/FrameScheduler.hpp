@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+// Планировщик кадров "по требованию": кадр рисуется только если что-то изменилось
+// (камера, кий, движение шаров, события окна). После последнего изменения дорисовывается
+// ещё несколько кадров, чтобы на экране оказалось конечное состояние.
+// В простое главный цикл ждёт события вместо опроса.
+class FrameScheduler
+{
+public:
+    static constexpr double kIdleTimeout = 0.5; // Секунды ожидания событий в простое
+    static constexpr int kSettleFrames = 3;
+
+    void Update(uint64_t cameraRevision, uint64_t cueRevision, bool simulationActive, bool windowActivity);
+
+    bool ShouldRender() const { return framesToRender > 0; }
+    bool IsIdle() const { return framesToRender == 0; }
+
+    void FrameRendered();
+    void Invalidate() { framesToRender = kSettleFrames; }
+
+private:
+    uint64_t lastCameraRevision = 0;
+    uint64_t lastCueRevision = 0;
+    int framesToRender = kSettleFrames;
+};
+
+inline void FrameScheduler::Update(uint64_t cameraRevision, uint64_t cueRevision,
+                                   bool simulationActive, bool windowActivity)
+{
+    const bool changed = cameraRevision != lastCameraRevision || cueRevision != lastCueRevision;
+    lastCameraRevision = cameraRevision;
+    lastCueRevision = cueRevision;
+
+    if (changed || simulationActive || windowActivity)
+        Invalidate();
+}
+
+inline void FrameScheduler::FrameRendered()
+{
+    if (framesToRender > 0)
+        --framesToRender;
+}
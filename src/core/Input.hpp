@@ -0,0 +1,151 @@
+#pragma once
+
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+// Событие ввода с отметкой времени (glfwGetTime, секунды). GLFW вызывает колбэки изнутри
+// glfwPollEvents/glfwWaitEvents, поэтому отметка — момент опроса, в котором событие разобрано,
+// а не момент нажатия: все события одного опроса получают почти одно время, и точность
+// отметки равна периоду опроса (обычно кадру).
+struct InputEvent
+{
+    enum class Type : uint8_t
+    {
+        Key,
+        MouseButton
+    };
+
+    Type type = Type::Key;
+    int code = 0;   // GLFW_KEY_* или GLFW_MOUSE_BUTTON_*
+    int action = 0; // GLFW_PRESS / GLFW_RELEASE / GLFW_REPEAT
+    double time = 0.0;
+};
+
+// Очередь событий ввода фиксированного размера. Колбэки GLFW и симуляция работают в одном
+// (главном) потоке, так что синхронизация не нужна; кольцо вместо вектора — чтобы кадр не
+// обращался к куче. При переполнении новые события отбрасываются и учитываются в Dropped().
+class InputQueue
+{
+public:
+    static constexpr size_t kCapacity = 1024; // Степень двойки
+
+    bool Push(const InputEvent &event);
+
+    // Самое старое событие без извлечения
+    bool Peek(InputEvent &event) const;
+    void Pop();
+
+    size_t Dropped() const { return dropped; }
+
+private:
+    InputEvent events[kCapacity];
+    size_t head = 0; // Следующая запись
+    size_t tail = 0; // Следующее чтение
+    size_t dropped = 0;
+};
+
+inline bool InputQueue::Push(const InputEvent &event)
+{
+    if (head - tail >= kCapacity)
+    {
+        ++dropped;
+        return false;
+    }
+    events[head & (kCapacity - 1)] = event;
+    ++head;
+    return true;
+}
+
+inline bool InputQueue::Peek(InputEvent &event) const
+{
+    if (tail == head)
+        return false;
+    event = events[tail & (kCapacity - 1)];
+    return true;
+}
+
+inline void InputQueue::Pop()
+{
+    ++tail;
+}
+
+// Состояние клавиш на шкале времени симуляции. Advance() применяет события до конца тика
+// и считает, сколько секунд внутри тика каждая клавиша была зажата. Моменты нажатия и
+// отпускания известны с точностью до опроса событий (см. InputEvent), так что удержание
+// квантовано периодом опроса; зато его сумма по тикам не зависит от того, на сколько тиков
+// разбит кадр.
+class InputTimeline
+{
+public:
+    // Начало отсчёта (или пропуск простоя): удержание до time не учитывается
+    void Skip(double time);
+
+    void Advance(InputQueue &queue, double end);
+
+    bool IsDown(int key) const { return Valid(key) && keys[key].down; }
+
+    // Время удержания клавиши на последнем интервале Advance
+    float HeldSeconds(int key) const { return Valid(key) ? static_cast<float>(keys[key].held) : 0.0f; }
+
+private:
+    struct KeyState
+    {
+        bool down = false;
+        double since = 0.0;
+        double held = 0.0;
+    };
+
+    KeyState keys[GLFW_KEY_LAST + 1];
+    double intervalEnd = 0.0;
+
+    static bool Valid(int key) { return key >= 0 && key <= GLFW_KEY_LAST; }
+};
+
+inline void InputTimeline::Skip(double time)
+{
+    intervalEnd = time;
+    for (KeyState &key : keys)
+    {
+        key.held = 0.0;
+        if (key.down)
+            key.since = std::max(key.since, time);
+    }
+}
+
+inline void InputTimeline::Advance(InputQueue &queue, double end)
+{
+    const double begin = intervalEnd;
+    for (KeyState &key : keys)
+        key.held = 0.0;
+
+    InputEvent event;
+    while (queue.Peek(event) && event.time <= end)
+    {
+        queue.Pop();
+        if (event.type != InputEvent::Type::Key || !Valid(event.code) || event.action == GLFW_REPEAT)
+            continue;
+
+        // События, пришедшие раньше начала интервала, считаем случившимися в его начале
+        const double time = std::max(event.time, begin);
+        KeyState &key = keys[event.code];
+        if (event.action == GLFW_PRESS && !key.down)
+        {
+            key.down = true;
+            key.since = time;
+        }
+        else if (event.action == GLFW_RELEASE && key.down)
+        {
+            key.held += time - std::max(key.since, begin);
+            key.down = false;
+        }
+    }
+
+    for (KeyState &key : keys)
+    {
+        if (key.down)
+            key.held += end - std::max(key.since, begin);
+    }
+    intervalEnd = end;
+}
@@ -0,0 +1,186 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Файл, отображённый в память только для чтения
+class MappedFile
+{
+public:
+    // Подсказки ядру о порядке доступа к страницам
+    enum class Access
+    {
+        Sequential, // Агрессивное упреждающее чтение
+        WillNeed,   // Начать чтение диапазона заранее
+        DontNeed,   // Диапазон больше не нужен, страницы можно вытеснить
+    };
+
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    bool Open(const std::string &path);
+    void Close();
+
+    bool IsOpen() const { return data != nullptr; }
+    const uint8_t *Data() const { return data; }
+    size_t Size() const { return size; }
+
+    // Подсказка для диапазона [offset, offset + length); границы выравниваются по страницам
+    void Advise(size_t offset, size_t length, Access access) const;
+
+private:
+    const uint8_t *data = nullptr;
+    size_t size = 0;
+
+#ifdef _WIN32
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+inline MappedFile::~MappedFile()
+{
+    Close();
+}
+
+#ifdef _WIN32
+
+inline bool MappedFile::Open(const std::string &path)
+{
+    Close();
+
+    file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping)
+    {
+        Close();
+        return false;
+    }
+
+    data = static_cast<const uint8_t *>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!data)
+    {
+        Close();
+        return false;
+    }
+
+    size = static_cast<size_t>(fileSize.QuadPart);
+    return true;
+}
+
+// Явного аналога madvise для отображений нет — полагаемся на упреждающее чтение системы
+inline void MappedFile::Advise(size_t, size_t, Access) const
+{
+}
+
+inline void MappedFile::Close()
+{
+    if (data)
+        UnmapViewOfFile(data);
+    if (mapping)
+        CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+
+    data = nullptr;
+    size = 0;
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+}
+
+#else
+
+inline bool MappedFile::Open(const std::string &path)
+{
+    Close();
+
+    fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0)
+    {
+        Close();
+        return false;
+    }
+
+    void *address = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    if (address == MAP_FAILED)
+    {
+        Close();
+        return false;
+    }
+
+    data = static_cast<const uint8_t *>(address);
+    size = static_cast<size_t>(st.st_size);
+    return true;
+}
+
+inline void MappedFile::Advise(size_t offset, size_t length, Access access) const
+{
+    if (!data || offset >= size)
+        return;
+
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t begin = offset / pageSize * pageSize;
+    const size_t end = std::min(size, offset + length);
+    int advice = MADV_NORMAL;
+    switch (access)
+    {
+    case Access::Sequential:
+        advice = MADV_SEQUENTIAL;
+        break;
+    case Access::WillNeed:
+        advice = MADV_WILLNEED;
+        break;
+    case Access::DontNeed:
+        advice = MADV_DONTNEED;
+        break;
+    }
+    madvise(const_cast<uint8_t *>(data) + begin, end - begin, advice);
+}
+
+inline void MappedFile::Close()
+{
+    if (data)
+        munmap(const_cast<uint8_t *>(data), size);
+    if (fd >= 0)
+        ::close(fd);
+
+    data = nullptr;
+    size = 0;
+    fd = -1;
+}
+
+#endif
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <render/RenderStats.hpp>
+#include <render/RenderQueue.hpp>
+
+// Этапы кадра, измеряемые на CPU
+enum class CpuStage
+{
+    Input,
+    Physics,
+    Submit,
+    Count
+};
+
+constexpr int kCpuStageCount = static_cast<int>(CpuStage::Count);
+
+// Снимок одного кадра
+struct FrameSample
+{
+    float frameMs = 0.0f;
+    float cpuMs[kCpuStageCount] = {};
+    float gpuMs[kRenderPassCount] = {};
+    RenderStats render;
+    RenderQueue::Stats queue;
+    uint32_t allocations = 0; // Аллокации в куче за кадр (при BILLIARDS_TRACK_ALLOCATIONS)
+    float latencyMs = 0.0f;    // Ввод -> показ по последнему готовому кадру (FramePacer)
+    float pacingWaitMs = 0.0f; // Ожидание GPU и ограничителя частоты перед кадром
+};
+
+// Профилировщик кадра: таймеры этапов CPU, история времени кадра с перцентилями
+// и скользящий CSV-журнал (одна строка в секунду, файл перезаписывается по достижении лимита).
+class FrameProfiler
+{
+public:
+    explicit FrameProfiler(size_t historySize = 600);
+    ~FrameProfiler();
+
+    void BeginFrame();
+    void EndFrame();
+
+    // Отбрасывает текущий кадр (простой без отрисовки) и перезапускает отсчёт его времени
+    void SkipFrame();
+
+    void BeginStage(CpuStage stage);
+    void EndStage(CpuStage stage);
+
+    // Данные текущего кадра (GPU и счётчики заполняются снаружи)
+    FrameSample &Current() { return current; }
+    const FrameSample &Last() const { return last; }
+
+    // Перцентили времени кадра по истории, пересчитываются раз в секунду
+    float P50() const { return p50; }
+    float P95() const { return p95; }
+    float P99() const { return p99; }
+    float AverageFps() const { return averageFps; }
+
+    const std::vector<float> &History() const { return history; }
+    size_t HistoryStart() const { return historyHead; }
+
+    bool OpenCsv(const std::string &path, size_t maxRows = 3600);
+
+    static const char *StageName(CpuStage stage);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    FrameSample current;
+    FrameSample last;
+
+    Clock::time_point createdAt;
+    Clock::time_point frameStart;
+    Clock::time_point stageStart[kCpuStageCount];
+    bool started = false;
+
+    std::vector<float> history; // Кольцевой буфер времени кадра, мс
+    size_t historyHead = 0;
+    size_t historyCount = 0;
+    std::vector<float> sorted; // Рабочий буфер для перцентилей
+
+    // Накопление за секунду для CSV
+    Clock::time_point windowStart;
+    size_t windowFrames = 0;
+    FrameSample windowSum;
+
+    float p50 = 0.0f, p95 = 0.0f, p99 = 0.0f;
+    float averageFps = 0.0f;
+
+    std::ofstream csv;
+    std::string csvPath;
+    size_t csvRows = 0;
+    size_t csvMaxRows = 0;
+
+    void UpdatePercentiles();
+    void WriteCsvHeader();
+    void WriteCsvRow();
+
+    static float Milliseconds(Clock::duration duration);
+};
+
+inline FrameProfiler::FrameProfiler(size_t historySize)
+    : createdAt(Clock::now()), history(historySize, 0.0f)
+{
+    sorted.reserve(historySize);
+}
+
+inline FrameProfiler::~FrameProfiler()
+{
+    if (csv.is_open())
+        csv.flush();
+}
+
+inline float FrameProfiler::Milliseconds(Clock::duration duration)
+{
+    return std::chrono::duration<float, std::milli>(duration).count();
+}
+
+inline void FrameProfiler::BeginFrame()
+{
+    const Clock::time_point now = Clock::now();
+    if (!started)
+    {
+        started = true;
+        frameStart = now;
+        windowStart = now;
+        return;
+    }
+
+    // Время кадра — между соседними BeginFrame, включая ожидание swapBuffers
+    current.frameMs = Milliseconds(now - frameStart);
+    frameStart = now;
+}
+
+inline void FrameProfiler::EndFrame()
+{
+    if (current.frameMs > 0.0f)
+    {
+        history[historyHead] = current.frameMs;
+        historyHead = (historyHead + 1) % history.size();
+        historyCount = std::min(historyCount + 1, history.size());
+
+        windowSum.frameMs += current.frameMs;
+        for (int i = 0; i < kCpuStageCount; ++i)
+            windowSum.cpuMs[i] += current.cpuMs[i];
+        for (int i = 0; i < kRenderPassCount; ++i)
+            windowSum.gpuMs[i] += current.gpuMs[i];
+        windowSum.latencyMs += current.latencyMs;
+        windowSum.pacingWaitMs += current.pacingWaitMs;
+        ++windowFrames;
+    }
+
+    const Clock::time_point now = Clock::now();
+    if (windowFrames > 0 && now - windowStart >= std::chrono::seconds(1))
+    {
+        UpdatePercentiles();
+        averageFps = windowFrames / std::chrono::duration<float>(now - windowStart).count();
+        if (csv.is_open())
+            WriteCsvRow();
+
+        windowSum = FrameSample();
+        windowFrames = 0;
+        windowStart = now;
+    }
+
+    last = current;
+    current = FrameSample();
+}
+
+inline void FrameProfiler::SkipFrame()
+{
+    current = FrameSample();
+    frameStart = Clock::now();
+}
+
+inline void FrameProfiler::BeginStage(CpuStage stage)
+{
+    stageStart[static_cast<int>(stage)] = Clock::now();
+}
+
+inline void FrameProfiler::EndStage(CpuStage stage)
+{
+    const int index = static_cast<int>(stage);
+    current.cpuMs[index] += Milliseconds(Clock::now() - stageStart[index]);
+}
+
+inline void FrameProfiler::UpdatePercentiles()
+{
+    if (historyCount == 0)
+        return;
+
+    sorted.assign(history.begin(), history.begin() + historyCount);
+    auto percentile = [this](float p)
+    {
+        const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+        std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+        return sorted[index];
+    };
+    p50 = percentile(0.50f);
+    p95 = percentile(0.95f);
+    p99 = percentile(0.99f);
+}
+
+inline bool FrameProfiler::OpenCsv(const std::string &path, size_t maxRows)
+{
+    csvPath = path;
+    csvMaxRows = maxRows;
+    csv.open(path, std::ios::trunc);
+    if (!csv.is_open())
+        return false;
+    WriteCsvHeader();
+    return true;
+}
+
+inline void FrameProfiler::WriteCsvHeader()
+{
+    csv << "time_s,fps,frame_avg_ms,p50_ms,p95_ms,p99_ms";
+    for (int i = 0; i < kCpuStageCount; ++i)
+        csv << ",cpu_" << StageName(static_cast<CpuStage>(i)) << "_ms";
+    for (int i = 0; i < kRenderPassCount; ++i)
+        csv << ",gpu_" << RenderPassName(static_cast<RenderPass>(i)) << "_ms";
+    csv << ",latency_ms,pacing_wait_ms";
+    csv << ",draw_calls,state_changes,elided_state_changes,uniform_uploads,buffer_uploads,submitted,culled\n";
+    csvRows = 0;
+}
+
+inline void FrameProfiler::WriteCsvRow()
+{
+    // Скользящий журнал: по достижении лимита файл начинается заново
+    if (csvRows >= csvMaxRows)
+    {
+        csv.close();
+        csv.open(csvPath, std::ios::trunc);
+        WriteCsvHeader();
+    }
+
+    const float frames = static_cast<float>(windowFrames);
+    const float seconds = std::chrono::duration<float>(Clock::now() - createdAt).count();
+
+    csv << seconds << ',' << averageFps << ',' << windowSum.frameMs / frames << ','
+        << p50 << ',' << p95 << ',' << p99;
+    for (int i = 0; i < kCpuStageCount; ++i)
+        csv << ',' << windowSum.cpuMs[i] / frames;
+    for (int i = 0; i < kRenderPassCount; ++i)
+        csv << ',' << windowSum.gpuMs[i] / frames;
+    csv << ',' << windowSum.latencyMs / frames << ',' << windowSum.pacingWaitMs / frames;
+    csv << ',' << current.render.drawCalls << ',' << current.render.stateChanges
+        << ',' << current.render.elidedStateChanges << ',' << current.render.uniformUploads << ',' << current.render.bufferUploads
+        << ',' << current.queue.submitted << ',' << current.queue.culled << '\n';
+    csv.flush();
+    ++csvRows;
+}
+
+inline const char *FrameProfiler::StageName(CpuStage stage)
+{
+    switch (stage)
+    {
+    case CpuStage::Input:
+        return "input";
+    case CpuStage::Physics:
+        return "physics";
+    case CpuStage::Submit:
+        return "submit";
+    default:
+        return "?";
+    }
+}
@@ -0,0 +1,232 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Трассировка этапов кадра для chrome://tracing и Perfetto.
+// Каждый поток пишет события в свой кольцевой буфер без блокировок; при переполнении
+// старые события затираются. Dump() снимает копию всех буферов и пишет JSON в фоне.
+// Буферы других потоков читаются без остановки писателя: поля событий — атомарные, а после
+// копирования Dump перечитывает head и отбрасывает ячейки, которые писатель мог успеть
+// перезаписать за это время (как в seqlock), чтобы в снимок не попали склеенные события.
+class Tracer
+{
+public:
+    static constexpr size_t kEventsPerThread = 1 << 15; // Степень двойки
+
+    static Tracer &Get();
+
+    void SetEnabled(bool value) { enabled.store(value, std::memory_order_relaxed); }
+    bool IsEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Имя текущего потока в трассе
+    void SetThreadName(const char *name);
+
+    void Record(const char *name, int64_t startNs, int64_t endNs);
+
+    // Пишет события всех потоков в файл формата Chrome Trace Event (в фоновом потоке)
+    bool Dump(const std::string &path);
+
+    int64_t NowNs() const;
+
+    ~Tracer();
+
+private:
+    struct Event
+    {
+        const char *name; // Строковый литерал
+        int64_t startNs;
+        int64_t durationNs;
+    };
+
+    // Ячейка кольца: Dump читает её одновременно с записью владельцем
+    struct Slot
+    {
+        std::atomic<const char *> name{nullptr};
+        std::atomic<int64_t> startNs{0};
+        std::atomic<int64_t> durationNs{0};
+    };
+
+    struct ThreadBuffer
+    {
+        std::vector<Slot> events = std::vector<Slot>(kEventsPerThread);
+        std::atomic<size_t> head{0};
+        uint32_t id = 0;
+        std::string name;
+    };
+
+    Tracer() = default;
+
+    ThreadBuffer &LocalBuffer();
+    static void WriteJson(std::string path, std::vector<std::pair<uint32_t, std::string>> threads,
+                          std::vector<std::pair<uint32_t, Event>> events);
+
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    std::atomic<bool> enabled{false}; // Включается явно: запись стоит времени в каждом кадре
+
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers; // Живут дольше своих потоков
+    std::thread writer;
+};
+
+// Замер области видимости: TRACE_SCOPE("Physics::Update");
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name)
+        : name(Tracer::Get().IsEnabled() ? name : nullptr), start(this->name ? Tracer::Get().NowNs() : 0)
+    {
+    }
+
+    ~TraceScope()
+    {
+        if (name)
+        {
+            Tracer &tracer = Tracer::Get();
+            tracer.Record(name, start, tracer.NowNs());
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name;
+    int64_t start;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+
+inline Tracer &Tracer::Get()
+{
+    static Tracer tracer;
+    return tracer;
+}
+
+inline Tracer::~Tracer()
+{
+    if (writer.joinable())
+        writer.join();
+}
+
+inline int64_t Tracer::NowNs() const
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+inline Tracer::ThreadBuffer &Tracer::LocalBuffer()
+{
+    thread_local ThreadBuffer *local = nullptr;
+    if (!local)
+    {
+        auto buffer = std::make_shared<ThreadBuffer>();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer->id = static_cast<uint32_t>(buffers.size() + 1);
+        buffer->name = "thread " + std::to_string(buffer->id);
+        buffers.push_back(buffer);
+        local = buffer.get();
+    }
+    return *local;
+}
+
+inline void Tracer::SetThreadName(const char *name)
+{
+    ThreadBuffer &buffer = LocalBuffer();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    buffer.name = name;
+}
+
+inline void Tracer::Record(const char *name, int64_t startNs, int64_t endNs)
+{
+    ThreadBuffer &buffer = LocalBuffer();
+    const size_t head = buffer.head.load(std::memory_order_relaxed);
+    // release: читатель, увидевший хоть одно из полей, увидит и head не меньше нынешнего
+    Slot &slot = buffer.events[head & (kEventsPerThread - 1)];
+    slot.name.store(name, std::memory_order_release);
+    slot.startNs.store(startNs, std::memory_order_release);
+    slot.durationNs.store(endNs - startNs, std::memory_order_release);
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+inline bool Tracer::Dump(const std::string &path)
+{
+    std::vector<std::pair<uint32_t, std::string>> threads;
+    std::vector<std::pair<uint32_t, Event>> events;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto &buffer : buffers)
+        {
+            threads.emplace_back(buffer->id, buffer->name);
+            const size_t head = buffer->head.load(std::memory_order_acquire);
+            const size_t count = std::min(head, kEventsPerThread);
+            const size_t begin = events.size();
+            for (size_t i = head - count; i < head; ++i)
+            {
+                const Slot &slot = buffer->events[i & (kEventsPerThread - 1)];
+                events.emplace_back(buffer->id, Event{slot.name.load(std::memory_order_acquire),
+                                                      slot.startNs.load(std::memory_order_acquire),
+                                                      slot.durationNs.load(std::memory_order_acquire)});
+            }
+
+            // Пока шло копирование, владелец мог дописать события: ячейки индексов до
+            // newHead - kEventsPerThread включительно (последняя — запись, идущая прямо сейчас)
+            // могли быть перезаписаны, их копии отбрасываем
+            const size_t newHead = buffer->head.load(std::memory_order_relaxed);
+            if (newHead >= kEventsPerThread)
+            {
+                const size_t firstValid = newHead - kEventsPerThread + 1;
+                const size_t stale = firstValid > head - count ? std::min(firstValid - (head - count), count) : 0;
+                events.erase(events.begin() + static_cast<std::ptrdiff_t>(begin),
+                             events.begin() + static_cast<std::ptrdiff_t>(begin + stale));
+            }
+        }
+    }
+
+    // Предыдущая выгрузка должна закончиться, прежде чем начнётся следующая
+    if (writer.joinable())
+        writer.join();
+    writer = std::thread(WriteJson, path, std::move(threads), std::move(events));
+    return true;
+}
+
+inline void Tracer::WriteJson(std::string path, std::vector<std::pair<uint32_t, std::string>> threads,
+                              std::vector<std::pair<uint32_t, Event>> events)
+{
+    std::ofstream out(path, std::ios::trunc);
+    if (!out)
+        return;
+
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const auto &thread : threads)
+    {
+        out << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+            << thread.first << ",\"args\":{\"name\":\"" << thread.second << "\"}}";
+        first = false;
+    }
+
+    // Время в микросекундах с дробной частью
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    for (const auto &entry : events)
+    {
+        const Event &event = entry.second;
+        if (!event.name)
+            continue;
+        out << (first ? "" : ",\n") << "{\"name\":\"" << event.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+            << entry.first << ",\"ts\":" << event.startNs / 1000.0 << ",\"dur\":" << event.durationNs / 1000.0 << "}";
+        first = false;
+    }
+    out << "\n]}\n";
+}
@@ -4,28 +4,45 @@
 #include <GLFW/glfw3.h>
 #include <string>
 #include <memory>
+#include <algorithm>
 #include <iostream>
+#include <render/GLState.hpp>
 #include "Camera.hpp"
+#include "Input.hpp"
+#include "Tracer.hpp"
 
 class Window
 {
 public:
-    Window(int width, int height, const std::string &title);
+    // visible = false — скрытое окно только ради контекста GL (рендер в FBO)
+    Window(int width, int height, const std::string &title, bool visible = true);
     ~Window();
 
     bool init();
     void shutdown();
 
-    void update();
+    // waitTimeout > 0 — ждать событий (режим простоя) вместо опроса
+    void update(double waitTimeout = 0.0);
     void swapBuffers() const;
+    // 0 — без vsync, 1 — по кадровому импульсу
+    void setSwapInterval(int interval) const;
+    // Только опрос событий (мышь двигает камеру) без пересчёта шага времени — поздняя выборка ввода
+    void pollEvents();
     bool shouldClose() const;
 
     void processInput();
     bool isKeyPressed(int key) const;
     void attachCamera(const std::shared_ptr<Camera> &camera);
 
+    // Были ли события окна (ввод, изменение размера, запрос перерисовки) с прошлого вызова
+    bool consumeActivity();
+
+    // События клавиш и кнопок мыши с отметками времени опроса, в порядке поступления
+    InputQueue &getInputQueue() { return s_input; }
+
     float getDeltaTime() const;
     float getAspectRatio() const;
+    void getFramebufferSize(int &width, int &height) const;
 
 private:
     void setupCallbacks();
@@ -33,11 +50,15 @@ private:
     static void framebufferSizeCallback(GLFWwindow *window, int width, int height);
     static void mouseCallback(GLFWwindow *window, double xpos, double ypos);
     static void scrollCallback(GLFWwindow *window, double xoffset, double yoffset);
+    static void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods);
+    static void mouseButtonCallback(GLFWwindow *window, int button, int action, int mods);
+    static void refreshCallback(GLFWwindow *window);
 
     GLFWwindow *m_window = nullptr;
     int m_width;
     int m_height;
     std::string m_title;
+    bool m_visible;
 
     float m_lastFrame = 0.0f;
     float m_deltaTime = 0.0f;
@@ -45,12 +66,14 @@ private:
     static inline float s_lastX = 400.0f;
     static inline float s_lastY = 300.0f;
     static inline bool s_firstMouse = true;
+    static inline bool s_activity = true;
+    static inline InputQueue s_input;
 
     static inline std::shared_ptr<Camera> s_camera = nullptr;
 };
 
-Window::Window(int width, int height, const std::string &title)
-    : m_width(width), m_height(height), m_title(title) {}
+Window::Window(int width, int height, const std::string &title, bool visible)
+    : m_width(width), m_height(height), m_title(title), m_visible(visible) {}
 
 Window::~Window() { shutdown(); }
 
@@ -65,6 +88,7 @@ bool Window::init()
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_VISIBLE, m_visible ? GLFW_TRUE : GLFW_FALSE);
 
     m_window = glfwCreateWindow(m_width, m_height, m_title.c_str(), nullptr, nullptr);
     if (!m_window)
@@ -75,7 +99,8 @@ bool Window::init()
     }
 
     glfwMakeContextCurrent(m_window);
-    glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+    if (m_visible)
+        glfwSetInputMode(m_window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -83,9 +108,9 @@ bool Window::init()
         return false;
     }
 
-    glViewport(0, 0, m_width, m_height);
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
+    GLState::Viewport(0, 0, m_width, m_height);
+    GLState::Enable(GL_DEPTH_TEST);
+    GLState::DepthFunc(GL_LESS);
 
     setupCallbacks();
 
@@ -102,20 +127,40 @@ void Window::shutdown()
     }
 }
 
-void Window::update()
+void Window::update(double waitTimeout)
 {
+    TRACE_SCOPE("Window::update");
+    if (waitTimeout > 0.0)
+        glfwWaitEventsTimeout(waitTimeout);
+    else
+        glfwPollEvents();
+
     float currentFrame = glfwGetTime();
     m_deltaTime = currentFrame - m_lastFrame;
     m_lastFrame = currentFrame;
 
-    glfwPollEvents();
+    // После простоя время ожидания не должно попасть в шаг симуляции и ввода
+    if (waitTimeout > 0.0)
+        m_deltaTime = std::min(m_deltaTime, 1.0f / 60.0f);
 }
 
 void Window::swapBuffers() const
 {
+    TRACE_SCOPE("Window::swapBuffers");
     glfwSwapBuffers(m_window);
 }
 
+void Window::setSwapInterval(int interval) const
+{
+    glfwSwapInterval(interval);
+}
+
+void Window::pollEvents()
+{
+    TRACE_SCOPE("Window::pollEvents");
+    glfwPollEvents();
+}
+
 bool Window::shouldClose() const
 {
     return glfwWindowShouldClose(m_window);
@@ -135,8 +180,6 @@ void Window::processInput()
         s_camera->processKeyboard(CameraMovement::LEFT, deltaTime);
     if (isKeyPressed(GLFW_KEY_D))
         s_camera->processKeyboard(CameraMovement::RIGHT, deltaTime);
-
-    glEnable(GL_DEPTH_TEST);
 }
 
 bool Window::isKeyPressed(int key) const
@@ -154,6 +197,18 @@ float Window::getAspectRatio() const
     return static_cast<float>(m_width) / m_height;
 }
 
+void Window::getFramebufferSize(int &width, int &height) const
+{
+    glfwGetFramebufferSize(m_window, &width, &height);
+}
+
+bool Window::consumeActivity()
+{
+    const bool activity = s_activity;
+    s_activity = false;
+    return activity;
+}
+
 void Window::attachCamera(const std::shared_ptr<Camera> &camera)
 {
     s_camera = camera;
@@ -164,11 +219,32 @@ void Window::setupCallbacks()
     glfwSetFramebufferSizeCallback(m_window, framebufferSizeCallback);
     glfwSetCursorPosCallback(m_window, mouseCallback);
     glfwSetScrollCallback(m_window, scrollCallback);
+    glfwSetKeyCallback(m_window, keyCallback);
+    glfwSetMouseButtonCallback(m_window, mouseButtonCallback);
+    glfwSetWindowRefreshCallback(m_window, refreshCallback);
 }
 
 void Window::framebufferSizeCallback(GLFWwindow *window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    GLState::Viewport(0, 0, width, height);
+    s_activity = true;
+}
+
+void Window::keyCallback(GLFWwindow * /*window*/, int key, int /*scancode*/, int action, int /*mods*/)
+{
+    s_activity = true;
+    s_input.Push({InputEvent::Type::Key, key, action, glfwGetTime()});
+}
+
+void Window::mouseButtonCallback(GLFWwindow * /*window*/, int button, int action, int /*mods*/)
+{
+    s_activity = true;
+    s_input.Push({InputEvent::Type::MouseButton, button, action, glfwGetTime()});
+}
+
+void Window::refreshCallback(GLFWwindow * /*window*/)
+{
+    s_activity = true;
 }
 
 void Window::mouseCallback(GLFWwindow *window, double xpos, double ypos)
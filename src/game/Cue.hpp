@@ -4,6 +4,8 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtx/compatibility.hpp>
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
 
 class Cue
 {
@@ -28,8 +30,14 @@ public:
     glm::vec3 getDirection() const;
     float getPower() const;
     glm::vec2 getOffset() const;
+    float getMaxForce() const { return maxForce; }
+
+    // Счётчик изменений состояния кия (для перерисовки по требованию)
+    uint64_t getRevision() const { return revision; }
+
     glm::vec3 computeImpactPoint(const glm::vec3 &origin,
-                                 const std::vector<glm::vec3> &ballPositions,
+                                 const glm::vec3 *ballPositions,
+                                 size_t ballCount,
                                  float ballRadius,
                                  float tableWidth,
                                  float tableHeight) const;
@@ -38,6 +46,7 @@ private:
     glm::vec3 direction;
     float power;
     glm::vec2 offset;
+    uint64_t revision = 0;
 
     const float maxPower = 1.0f;
     const float chargeRate = 0.5f;
@@ -55,35 +64,43 @@ inline void Cue::rotate(float angleDeg)
 {
     glm::mat4 rot = glm::rotate(glm::mat4(1.0f), glm::radians(angleDeg), glm::vec3(0, 1, 0));
     direction = glm::normalize(glm::vec3(rot * glm::vec4(direction, 0.0f)));
+    ++revision;
 }
 
 inline void Cue::charge(float dt)
 {
+    const float previous = power;
     power += dt * chargeRate;
     power = std::min(power, maxPower);
+    if (power != previous)
+        ++revision;
 }
 
 inline glm::vec3 Cue::release()
 {
     glm::vec3 velocity = direction * (power * maxForce);
     power = 0.0f;
+    ++revision;
     return velocity;
 }
 
 inline void Cue::adjustOffset(glm::vec2 delta)
 {
+    const glm::vec2 previous = offset;
     offset += delta;
     float limit = 0.8f;
     offset.x = std::clamp(offset.x, -limit, limit);
     offset.y = std::clamp(offset.y, -limit, limit);
+    if (offset != previous)
+        ++revision;
 }
 
-float Cue::getRadius() const
+inline float Cue::getRadius() const
 {
     return cueRadius;
 }
 
-float Cue::getLength() const
+inline float Cue::getLength() const
 {
     return minLength + power * (maxLength - minLength);
 }
@@ -125,7 +142,8 @@ inline glm::vec2 Cue::getOffset() const
 
 inline glm::vec3 Cue::computeImpactPoint(
     const glm::vec3 &origin,
-    const std::vector<glm::vec3> &ballPositions,
+    const glm::vec3 *ballPositions,
+    size_t ballCount,
     float ballRadius,
     float tableWidth,
     float tableHeight) const
@@ -135,8 +153,9 @@ inline glm::vec3 Cue::computeImpactPoint(
     glm::vec3 hit = origin + dir * maxDistance;
 
     // Проверка столкновения с шарами
-    for (const auto &pos : ballPositions)
+    for (size_t i = 0; i < ballCount; ++i)
     {
+        const glm::vec3 &pos = ballPositions[i];
         if (glm::distance(pos, origin) < 1e-4f)
             continue;
 
@@ -158,29 +177,32 @@ inline glm::vec3 Cue::computeImpactPoint(
     float xMax = tableWidth / 2.0f - ballRadius;
     float zMax = tableHeight / 2.0f - ballRadius;
 
-    std::vector<float> tVals;
+    // Не больше двух пересечений на ось
+    float tVals[4];
+    int tCount = 0;
 
     if (dir.x != 0.0f)
     {
         float tx1 = (xMax - origin.x) / dir.x;
         float tx2 = (-xMax - origin.x) / dir.x;
         if (tx1 > 0)
-            tVals.push_back(tx1);
+            tVals[tCount++] = tx1;
         if (tx2 > 0)
-            tVals.push_back(tx2);
+            tVals[tCount++] = tx2;
     }
     if (dir.z != 0.0f)
     {
         float tz1 = (zMax - origin.z) / dir.z;
         float tz2 = (-zMax - origin.z) / dir.z;
         if (tz1 > 0)
-            tVals.push_back(tz1);
+            tVals[tCount++] = tz1;
         if (tz2 > 0)
-            tVals.push_back(tz2);
+            tVals[tCount++] = tz2;
     }
 
-    for (float t : tVals)
+    for (int i = 0; i < tCount; ++i)
     {
+        const float t = tVals[i];
         glm::vec3 p = origin + dir * t;
         if (abs(p.x) <= xMax + 0.01f && abs(p.z) <= zMax + 0.01f)
         {
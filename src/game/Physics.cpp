@@ -0,0 +1,324 @@
+#include "Physics.hpp"
+
+#include <algorithm>
+
+Physics::Physics(float tableWidth, float tableHeight, float friction)
+    : tableWidth(tableWidth), tableHeight(tableHeight), friction(friction) {}
+
+void Physics::Update(std::vector<Ball> &balls, float dt)
+{
+    // Контакты по положениям начала шага: скорости исправляются до перемещения
+    if (events && moving.size() != balls.size())
+        moving.assign(balls.size(), 0);
+
+    FindContacts(balls, dt);
+    WarmStart(balls);
+    SolveVelocities(balls);
+    if (events)
+        EmitContacts();
+
+    for (size_t i = 0; i < balls.size(); ++i)
+    {
+        Ball &ball = balls[i];
+        ball.update(dt);
+
+        HandleWallCollisions(ball, static_cast<uint16_t>(i), dt);
+
+        ball.applyFriction(friction, dt);
+    }
+
+    SolvePositions(balls);
+
+    time += dt;
+    pocketedMask = CollectPocketed(balls, pockets, pocketRadius, [&](size_t ball, size_t pocket)
+    {
+        if (events)
+            EmitPocketed(balls[ball], static_cast<uint16_t>(ball), pocket, dt);
+    });
+    if (events)
+        EmitRest(balls);
+}
+
+void Physics::SetPockets(const TableGeometry &table)
+{
+    pockets = table.pockets;
+    pocketRadius = table.pocketRadius;
+}
+
+void Physics::Emit(PhysicsEvent::Type type, uint16_t a, uint16_t b, uint8_t detail, float impulse, double at)
+{
+    PhysicsEvent event;
+    event.type = type;
+    event.detail = detail;
+    event.a = a;
+    event.b = b;
+    event.impulse = impulse;
+    event.time = at;
+    events->TryPush(event); // Полная очередь — событие теряется, шаг не ждёт
+}
+
+void Physics::EmitContacts()
+{
+    // Импульс — итог решателя, время — смыкание внутри шага. Мягкое касание (медленнее
+    // kRestitutionThreshold) отскока не даёт, но шар сдвигает — о нём событие в начале шага,
+    // где импульс пары впервые стал ненулевым
+    for (const Contact &contact : contacts)
+    {
+        const bool impact = contact.impactTime >= 0.0f;
+        const bool softTouch = !impact && contact.impulse > 0.0f && contact.previousImpulse <= 0.0f;
+        if (!impact && !softTouch)
+            continue;
+        Emit(PhysicsEvent::Type::BallContact, contact.a, contact.b, impact ? 0 : 1, contact.impulse,
+             time + (impact ? contact.impactTime : 0.0f));
+        // У шара с событием всегда будет и Rest, даже если толчок был слишком слабым для isMoving
+        moving[contact.a] = moving[contact.b] = 1;
+    }
+}
+
+void Physics::EmitPocketed(const Ball &ball, uint16_t index, size_t pocket, float dt)
+{
+    // Вход в зону захвата на отрезке перемещения за шаг: |d + v·s| = R, s — назад от конца шага
+    const glm::vec3 toPocket = pockets[pocket] - ball.getPosition();
+    const glm::vec3 velocity = ball.getVelocity();
+    const float speedSquared = glm::dot(velocity, velocity);
+    float back = 0.0f;
+    if (speedSquared > 0.0f)
+    {
+        const float along = glm::dot(toPocket, velocity);
+        const float c = glm::dot(toPocket, toPocket) - pocketRadius * pocketRadius;
+        const float root = std::sqrt(std::max(along * along - speedSquared * c, 0.0f));
+        back = glm::clamp((root - along) / speedSquared, 0.0f, dt);
+    }
+    Emit(PhysicsEvent::Type::Pocketed, index, 0, static_cast<uint8_t>(pocket), ball.getMass() * std::sqrt(speedSquared),
+         time - back);
+}
+
+void Physics::EmitRest(const std::vector<Ball> &balls)
+{
+    for (size_t i = 0; i < balls.size(); ++i)
+    {
+        const bool pocketedBall = IsPocketed(balls[i]);
+        const bool now = !pocketedBall && balls[i].isMoving();
+        if (moving[i] && !now && !pocketedBall)
+            Emit(PhysicsEvent::Type::Rest, static_cast<uint16_t>(i), 0, 0, 0.0f, time);
+        moving[i] = now;
+    }
+}
+
+void Physics::ResetContacts()
+{
+    contacts.clear();
+    previousContacts.clear();
+}
+
+void Physics::ApplyFriction(Ball &ball, float dt)
+{
+    ball.applyFriction(friction, dt);
+}
+
+void Physics::HandleWallCollisions(Ball &ball, uint16_t index, float dt)
+{
+    glm::vec3 position = ball.getPosition();
+    glm::vec3 velocity = ball.getVelocity();
+    float radius = ball.getRadius();
+
+    float left = -tableWidth / 2.0f + radius;
+    float right = tableWidth / 2.0f - radius;
+    float top = tableHeight / 2.0f - radius;
+    float bottom = -tableHeight / 2.0f + radius;
+
+    bool positionChanged = false;
+    bool velocityChanged = false;
+
+    // Момент касания борта — по заходу за борт и скорости поперёк него (шаг ещё не учтён в time)
+    auto cushion = [&](uint8_t side, float overshoot, float speed)
+    {
+        // Забитые шары стоят под столом и тоже «упираются» в борт — это не удар
+        if (!events || IsPocketed(ball))
+            return;
+        const float back = speed > 0.0f ? std::min(overshoot / speed, dt) : 0.0f;
+        Emit(PhysicsEvent::Type::Cushion, index, 0, side, 2.0f * ball.getMass() * speed, time + dt - back);
+        moving[index] = 1;
+    };
+
+    if (position.x < left)
+    {
+        cushion(0, left - position.x, std::abs(velocity.x));
+        position.x = left;
+        velocity.x = -velocity.x;
+        positionChanged = true;
+        velocityChanged = true;
+    }
+    else if (position.x > right)
+    {
+        cushion(1, position.x - right, std::abs(velocity.x));
+        position.x = right;
+        velocity.x = -velocity.x;
+        positionChanged = true;
+        velocityChanged = true;
+    }
+
+    if (position.z < bottom)
+    {
+        cushion(2, bottom - position.z, std::abs(velocity.z));
+        position.z = bottom;
+        velocity.z = -velocity.z;
+        positionChanged = true;
+        velocityChanged = true;
+    }
+    else if (position.z > top)
+    {
+        cushion(3, position.z - top, std::abs(velocity.z));
+        position.z = top;
+        velocity.z = -velocity.z;
+        positionChanged = true;
+        velocityChanged = true;
+    }
+
+    if (positionChanged)
+    {
+        ball.setPosition(position);
+    }
+    if (velocityChanged)
+    {
+        ball.setVelocity(velocity);
+    }
+}
+
+void Physics::FindContacts(const std::vector<Ball> &balls, float dt)
+{
+    std::swap(contacts, previousContacts);
+    contacts.clear();
+
+    // Обе последовательности упорядочены по ключу, поэтому поиск прошлого импульса — слияние
+    size_t previous = 0;
+    stats.impacts = 0;
+    for (size_t i = 0; i < balls.size(); ++i)
+    {
+        const Ball &ballA = balls[i];
+        for (size_t j = i + 1; j < balls.size(); ++j)
+        {
+            const Ball &ballB = balls[j];
+            const glm::vec3 delta = ballB.getPosition() - ballA.getPosition();
+            const glm::vec3 relativeVelocity = ballB.getVelocity() - ballA.getVelocity();
+            // Запас на относительное смещение за шаг, чтобы быстрые шары не проскочили друг в друга
+            const float reach = ballA.getRadius() + ballB.getRadius() + kContactMargin + glm::length(relativeVelocity) * dt;
+            const float distSquared = glm::dot(delta, delta);
+            // Совпадающие центры (забитые шары) контакта не образуют
+            if (distSquared >= reach * reach || distSquared < 1e-12f)
+                continue;
+
+            const float radii = ballA.getRadius() + ballB.getRadius();
+
+            const float dist = std::sqrt(distSquared);
+            Contact contact;
+            contact.a = static_cast<uint16_t>(i);
+            contact.b = static_cast<uint16_t>(j);
+            contact.key = (static_cast<uint32_t>(i) << 16) | static_cast<uint32_t>(j);
+            contact.normal = delta / dist;
+            contact.separation = dist - radii;
+            contact.normalMass = 1.0f / (1.0f / ballA.getMass() + 1.0f / ballB.getMass());
+            contact.impulse = 0.0f;
+            contact.previousImpulse = 0.0f;
+            contact.impactTime = -1.0f;
+
+            // Отскок, если шары сходятся быстро и сомкнутся на этом шаге; иначе зазор
+            // можно закрыть, но не больше, чем за шаг
+            const float approach = glm::dot(relativeVelocity, contact.normal);
+            const float gap = std::max(contact.separation, 0.0f);
+            if (approach < -kRestitutionThreshold && approach * dt <= -gap)
+            {
+                contact.targetVelocity = -kRestitution * approach;
+                contact.impactTime = gap / -approach;
+                ++stats.impacts;
+            }
+            else
+                contact.targetVelocity = -gap / dt;
+
+            while (previous < previousContacts.size() && previousContacts[previous].key < contact.key)
+                ++previous;
+            if (previous < previousContacts.size() && previousContacts[previous].key == contact.key)
+            {
+                contact.impulse = previousContacts[previous].impulse;
+                contact.previousImpulse = contact.impulse;
+            }
+
+            contacts.push_back(contact);
+        }
+    }
+    stats.contacts = contacts.size();
+}
+
+void Physics::WarmStart(std::vector<Ball> &balls)
+{
+    for (const Contact &contact : contacts)
+    {
+        if (contact.impulse <= 0.0f)
+            continue;
+        const glm::vec3 impulse = contact.normal * contact.impulse;
+        balls[contact.a].applyImpulse(-impulse);
+        balls[contact.b].applyImpulse(impulse);
+    }
+}
+
+void Physics::SolveVelocities(std::vector<Ball> &balls)
+{
+    // Удары шаров центральные, поэтому импульсы только линейные и вращение не меняют
+    stats.iterations = 0;
+    stats.residual = 0.0f;
+    for (int iteration = 0; iteration < kMaxVelocityIterations && !contacts.empty(); ++iteration)
+    {
+        float maxChange = 0.0f;
+        for (Contact &contact : contacts)
+        {
+            Ball &ballA = balls[contact.a];
+            Ball &ballB = balls[contact.b];
+            const float velocityAlongNormal = glm::dot(ballB.getVelocity() - ballA.getVelocity(), contact.normal);
+
+            // Накопленный импульс только отталкивает
+            float lambda = (contact.targetVelocity - velocityAlongNormal) * contact.normalMass;
+            const float accumulated = std::max(contact.impulse + lambda, 0.0f);
+            lambda = accumulated - contact.impulse;
+            contact.impulse = accumulated;
+            if (lambda == 0.0f)
+                continue;
+
+            const glm::vec3 impulse = contact.normal * lambda;
+            ballA.applyImpulse(-impulse);
+            ballB.applyImpulse(impulse);
+            maxChange = std::max(maxChange, std::abs(lambda));
+        }
+
+        stats.iterations = iteration + 1;
+        stats.residual = maxChange;
+        if (maxChange < kVelocityTolerance)
+            break;
+    }
+}
+
+void Physics::SolvePositions(std::vector<Ball> &balls)
+{
+    // Раздвигаем перекрывшиеся шары сверх допуска; скорости не трогаем
+    for (int iteration = 0; iteration < kPositionIterations; ++iteration)
+    {
+        bool corrected = false;
+        for (const Contact &contact : contacts)
+        {
+            Ball &ballA = balls[contact.a];
+            Ball &ballB = balls[contact.b];
+            const glm::vec3 delta = ballB.getPosition() - ballA.getPosition();
+            const float dist = glm::length(delta);
+            const float penetration = ballA.getRadius() + ballB.getRadius() - dist - kLinearSlop;
+            if (penetration <= 0.0f || dist <= 0.0f)
+                continue;
+
+            const glm::vec3 normal = delta / dist;
+            const float totalMass = ballA.getMass() + ballB.getMass();
+            ballA.setPosition(ballA.getPosition() - normal * penetration * (ballB.getMass() / totalMass));
+            ballB.setPosition(ballB.getPosition() + normal * penetration * (ballA.getMass() / totalMass));
+            corrected = true;
+        }
+        if (!corrected)
+            break;
+    }
+}
@@ -1,165 +1,119 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <vector>
 #include <cmath>
 #include <iostream>
+#include <core/EventRing.hpp>
 #include "Ball.hpp"
+#include "Table.hpp"
 
-class Physics
+// Событие симуляции для игровой логики (фолы, первое касание, очки, звук, статистика)
+struct PhysicsEvent
 {
-public:
-    Physics(float tableWidth, float tableHeight, float friction);
-
-    void Update(std::vector<Ball> &balls, float dt);
-
-    bool CheckPocketCollision(const Ball &ball, const glm::vec3 &pocketPos, float pocketRadius);
-
-private:
-    float tableWidth;
-    float tableHeight;
-    float friction; // коэффициент трения, замедляющий шары
-
-    void ApplyFriction(Ball &ball, float dt);
-    void HandleWallCollisions(Ball &ball);
-    void HandleBallCollisions(Ball &ballA, Ball &ballB);
+    enum class Type : uint8_t
+    {
+        BallContact, // Касание шаров: соударение с отскоком (detail 0) или мягкое (detail 1)
+        Cushion,     // Отскок от борта
+        Pocketed,    // Шар попал в лузу
+        Rest,        // Шар остановился
+    };
+
+    Type type = Type::BallContact;
+    uint8_t detail = 0;   // BallContact — 1 без отскока; Cushion — борт (0 левый, 1 правый, 2 нижний,
+                          // 3 верхний); Pocketed — луза
+    uint16_t a = 0;       // Шар
+    uint16_t b = 0;       // Второй шар для BallContact
+    float impulse = 0.0f; // Н·с: нормальный импульс контакта или изменение импульса шара о борт
+    double time = 0.0;    // Время симуляции с точностью до доли шага, с
 };
 
-Physics::Physics(float tableWidth, float tableHeight, float friction)
-    : tableWidth(tableWidth), tableHeight(tableHeight), friction(friction) {}
+using PhysicsEventRing = EventRing<PhysicsEvent>;
 
-void Physics::Update(std::vector<Ball> &balls, float dt)
+// Шары на столе: интегрирование, борта, трение и контакты шар–шар.
+// Контакты решаются итеративно (последовательные импульсы, PGS): все касания шаров в
+// скоплении, как в пирамиде при разбое, обрабатываются совместно, а не по парам в порядке
+// обхода. Накопленные импульсы контактов сохраняются между шагами и подставляются в начале
+// следующего шага (тёплый старт), поэтому покоящаяся пирамида не дрожит.
+class Physics
 {
-    for (auto &ball : balls)
-    {
-        ball.update(dt);
-
-        HandleWallCollisions(ball);
-
-        ball.applyFriction(friction, dt);
-    }
-
-    for (size_t i = 0; i < balls.size(); ++i)
+public:
+    static constexpr int kMaxVelocityIterations = 24;
+    static constexpr int kPositionIterations = 3;
+    static constexpr float kVelocityTolerance = 1e-5f; // Итерации прекращаются, когда импульсы почти не меняются
+    static constexpr float kContactMargin = 0.005f;    // Зазор, при котором пара уже считается контактом, м
+    static constexpr float kLinearSlop = 0.0005f;      // Допустимое взаимопроникновение, м
+    static constexpr float kRestitution = 0.9f;        // Коэффициент восстановления (1 - полностью упругое)
+    static constexpr float kRestitutionThreshold = 0.02f; // Медленнее, м/с — контакт без отскока
+
+    struct SolverStats
     {
-        for (size_t j = i + 1; j < balls.size(); ++j)
-        {
-            HandleBallCollisions(balls[i], balls[j]);
-        }
-    }
-}
-
-bool Physics::CheckPocketCollision(const Ball &ball, const glm::vec3 &pocketPos, float pocketRadius)
-{
-    float dist = glm::distance(ball.getPosition(), pocketPos);
-    return dist < pocketRadius;
-}
-
-void Physics::ApplyFriction(Ball &ball, float dt)
-{
-    ball.applyFriction(friction, dt);
-}
+        size_t contacts = 0;
+        size_t impacts = 0; // Новые соударения с отскоком на этом шаге
+        int iterations = 0;
+        float residual = 0.0f; // Наибольшее изменение импульса на последней итерации
+    };
 
-void Physics::HandleWallCollisions(Ball &ball)
-{
-    glm::vec3 position = ball.getPosition();
-    glm::vec3 velocity = ball.getVelocity();
-    float radius = ball.getRadius();
+    Physics(float tableWidth, float tableHeight, float friction);
 
-    float left = -tableWidth / 2.0f + radius;
-    float right = tableWidth / 2.0f - radius;
-    float top = tableHeight / 2.0f - radius;
-    float bottom = -tableHeight / 2.0f + radius;
+    void Update(std::vector<Ball> &balls, float dt);
 
-    bool positionChanged = false;
-    bool velocityChanged = false;
+    // События шага пишутся в очередь; nullptr — без событий. Очередь должна жить дольше Physics.
+    void SetEventSink(PhysicsEventRing *sink) { events = sink; }
 
-    if (position.x < left)
-    {
-        position.x = left;
-        velocity.x = -velocity.x;
-        positionChanged = true;
-        velocityChanged = true;
-    }
-    else if (position.x > right)
-    {
-        position.x = right;
-        velocity.x = -velocity.x;
-        positionChanged = true;
-        velocityChanged = true;
-    }
+    // Лузы проверяются внутри Update (забитый шар уходит в kPocketedPosition с событием Pocketed)
+    void SetPockets(const TableGeometry &table);
 
-    if (position.z < bottom)
-    {
-        position.z = bottom;
-        velocity.z = -velocity.z;
-        positionChanged = true;
-        velocityChanged = true;
-    }
-    else if (position.z > top)
-    {
-        position.z = top;
-        velocity.z = -velocity.z;
-        positionChanged = true;
-        velocityChanged = true;
-    }
+    // Шары, забитые на последнем шаге (при заданных лузах)
+    uint32_t PocketedMask() const { return pocketedMask; }
 
-    if (positionChanged)
-    {
-        ball.setPosition(position);
-    }
-    if (velocityChanged)
-    {
-        ball.setVelocity(velocity);
-    }
-}
+    // Суммарное время шагов — шкала времени событий
+    double Time() const { return time; }
 
-void Physics::HandleBallCollisions(Ball &ballA, Ball &ballB)
-{
-    glm::vec3 posA = ballA.getPosition();
-    glm::vec3 posB = ballB.getPosition();
-    glm::vec3 velA = ballA.getVelocity();
-    glm::vec3 velB = ballB.getVelocity();
+    // Сброс сохранённых контактов — после перестановки шаров
+    void ResetContacts();
 
-    glm::vec3 delta = posB - posA;
-    float dist = glm::length(delta);
-    float penetration = ballA.getRadius() + ballB.getRadius() - dist;
+    const SolverStats &GetSolverStats() const { return stats; }
 
-    if (penetration > 0.0f && dist > 0.0f)
+private:
+    struct Contact
     {
-        // Раздвигаем шары, чтобы не пересекались
-        glm::vec3 collisionNormal = delta / dist;
+        uint32_t key; // (a << 16) | b, a < b — по нему контакт находится на следующем шаге
+        uint16_t a, b;
+        glm::vec3 normal; // От a к b
+        float separation; // Зазор (< 0 — взаимопроникновение)
+        float normalMass;
+        float targetVelocity; // Нижняя граница относительной скорости вдоль нормали
+        float impulse;        // Накопленный импульс, >= 0
+        float previousImpulse; // Импульс пары на прошлом шаге (0 — касания не было)
+        float impactTime;     // Момент смыкания от начала шага для соударения с отскоком, иначе < 0
+    };
 
-        float totalMass = ballA.getMass() + ballB.getMass();
-        float correction = penetration / 2.0f;
-
-        posA -= collisionNormal * correction * (ballB.getMass() / totalMass);
-        posB += collisionNormal * correction * (ballA.getMass() / totalMass);
-
-        // Обновляем позиции
-        ballA.setPosition(posA);
-        ballB.setPosition(posB);
-
-        // Скорости по формулам упругого столкновения
-        glm::vec3 relativeVelocity = velB - velA;
-        float velocityAlongNormal = glm::dot(relativeVelocity, collisionNormal);
-
-        if (velocityAlongNormal > 0)
-            return; // уже разлетаются
-
-        // Коэффициент восстановления (1 - полностью упругое)
-        const float restitution = 0.9f;
-
-        float impulseMagnitude = -(1.0f + restitution) * velocityAlongNormal;
-        impulseMagnitude /= (1.0f / ballA.getMass() + 1.0f / ballB.getMass());
+    float tableWidth;
+    float tableHeight;
+    float friction; // коэффициент трения, замедляющий шары
 
-        glm::vec3 impulse = impulseMagnitude * collisionNormal;
+    std::vector<Contact> contacts;
+    std::vector<Contact> previousContacts;
+    SolverStats stats;
 
-        // Применяем импульсы через методы класса Ball
-        ballA.applyImpulse(-impulse);
-        ballB.applyImpulse(impulse);
+    PhysicsEventRing *events = nullptr;
+    std::vector<glm::vec3> pockets;
+    float pocketRadius = 0.0f;
+    uint32_t pocketedMask = 0;
+    double time = 0.0;
+    std::vector<uint8_t> moving; // Шар двигался на прошлом шаге — для событий Rest
 
-        // Добавляем угловой импульс в точке столкновения
-        ballA.applyAngularImpulse(ballA.getPosition() + collisionNormal * ballA.getRadius(), -impulse);
-        ballB.applyAngularImpulse(ballB.getPosition() - collisionNormal * ballB.getRadius(), impulse);
-    }
-}
\ No newline at end of file
+    void ApplyFriction(Ball &ball, float dt);
+    void HandleWallCollisions(Ball &ball, uint16_t index, float dt);
+    void EmitPocketed(const Ball &ball, uint16_t index, size_t pocket, float dt);
+    void EmitContacts();
+    void EmitRest(const std::vector<Ball> &balls);
+    void Emit(PhysicsEvent::Type type, uint16_t a, uint16_t b, uint8_t detail, float impulse, double at);
+
+    void FindContacts(const std::vector<Ball> &balls, float dt);
+    void WarmStart(std::vector<Ball> &balls);
+    void SolveVelocities(std::vector<Ball> &balls);
+    void SolvePositions(std::vector<Ball> &balls);
+};
@@ -0,0 +1,503 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "Ball.hpp"
+#include "ShotCache.hpp"
+#include "Table.hpp"
+
+// Окно попадания в лузу для шара в клетке: направления, при которых центр шара доходит
+// до зоны захвата лузы (CollectPocketed), не упираясь в борт
+struct PocketWindow
+{
+    uint16_t angle = 0;     // Центр окна, 1/100 градуса (как ShotParams::angle)
+    uint16_t halfWidth = 0; // Допуск в каждую сторону, 1/100 градуса; 0 — лузы не видно
+
+    bool Open() const { return halfWidth > 0; }
+
+    // Направления битка, при которых прицельный шар вообще можно послать в окно:
+    // резка не больше maxCut. Градусы, min может быть отрицательным.
+    void CueRange(float maxCut, float &minDegrees, float &maxDegrees) const;
+};
+
+// Кандидат удара из поля: биток в «призрачный» шар перед прицельным
+struct ShotCandidate
+{
+    int ball = -1;
+    int pocket = -1;
+    ShotParams shot;
+    float cut = 0.0f;    // Угол резки, градусы
+    float margin = 0.0f; // Допуск по направлению битка, градусы
+};
+
+// Заранее посчитанное поле забиваемости по сетке стола для пустого стола: для каждой клетки
+// и каждой лузы — окно направлений прицельного шара. Строится параллельно по строкам сетки
+// из геометрии лунок и радиуса шара; вопрос «можно ли забить шар из точки P и с каким запасом»
+// становится чтением из таблицы.
+class PocketField
+{
+public:
+    static constexpr int kMaxPockets = 8;
+    static constexpr int kMouthSamples = 32; // Точки на границе зоны захвата лузы
+    static constexpr float kMaxCutDegrees = 75.0f;
+
+    PocketField(const TableGeometry &table, float ballRadius, float cellSize = 0.02f);
+
+    // threads = 0 — по числу ядер
+    void Build(size_t threads = 0);
+
+    int Columns() const { return columns; }
+    int Rows() const { return rows; }
+    int PocketCount() const { return pocketCount; }
+    float BallRadius() const { return ballRadius; }
+    float BuildMs() const { return buildMs; }
+    const TableGeometry &Table() const { return table; }
+
+    // -1 — точка вне поля центров шаров
+    int CellIndex(const glm::vec3 &position) const;
+    glm::vec2 CellCenter(int cell) const;
+
+    const PocketWindow &At(int cell, int pocket) const { return windows[cell * pocketCount + pocket]; }
+
+    // Окно для точки, а не центра клетки: центр сдвигается на разницу направлений к лузе
+    PocketWindow Lookup(const glm::vec3 &position, int pocket) const;
+
+    // Окно ячейки, сдвинутое из её центра в точку
+    PocketWindow Shift(const PocketWindow &window, int cell, const glm::vec3 &position, int pocket) const;
+
+private:
+    TableGeometry table;
+    float ballRadius;
+    float cellSize;
+    glm::vec2 extent; // Полуразмеры поля центров шаров (борта)
+    int columns = 0;
+    int rows = 0;
+    int pocketCount = 0;
+    float buildMs = 0.0f;
+    std::vector<PocketWindow> windows; // [cell * pocketCount + pocket]
+
+    PocketWindow Compute(const glm::vec2 &point, int pocket) const;
+};
+
+// Поле для текущей расстановки: окна базового поля, сужённые шарами на пути к лузе.
+// Refine пересчитывает только клетки в «тени» шаров, сдвинувшихся с прошлого вызова
+// (старое и новое положение), остальные клетки остаются как были.
+class PocketLayout
+{
+public:
+    explicit PocketLayout(const PocketField &field);
+
+    // Биток (шар 0) не считается помехой: к моменту удара по прицельному он уже у цели
+    void Refine(const std::vector<Ball> &balls);
+
+    // Сколько пар клетка–луза пересчитал последний Refine
+    size_t LastRefined() const { return lastRefined; }
+
+    PocketWindow Lookup(const glm::vec3 &position, int pocket) const;
+
+    // Удары битком по прицельным шарам в открытые окна, по убыванию допуска.
+    // Путь битка до призрачного шара проверяется по расстановке; сила — из трения,
+    // чтобы прицельный шар с запасом докатился до лузы.
+    void Candidates(const std::vector<Ball> &balls, float friction, float maxForce,
+                    std::vector<ShotCandidate> &out) const;
+
+private:
+    struct Blocker
+    {
+        glm::vec2 position;
+        bool present = false;
+    };
+
+    const PocketField &field;
+    std::vector<PocketWindow> windows;
+    std::vector<Blocker> blockers; // Положения шаров на момент прошлого Refine
+    std::vector<uint8_t> dirty;    // Рабочий буфер: пара клетка–луза попала в тень
+    size_t lastRefined = 0;
+
+    bool InShadow(int cell, int pocket, const glm::vec2 &blocker) const;
+    void RefineWindow(int cell, int pocket);
+};
+
+namespace PocketMath
+{
+    // Угол в 1/100 градуса в [0, 36000)
+    inline uint16_t ToCentidegrees(float degrees)
+    {
+        int32_t value = static_cast<int32_t>(std::lround(degrees * 100.0f)) % 36000;
+        if (value < 0)
+            value += 36000;
+        return static_cast<uint16_t>(value);
+    }
+
+    inline float Heading(const glm::vec2 &direction)
+    {
+        return glm::degrees(std::atan2(direction.y, direction.x));
+    }
+
+    // Разница углов в (-180, 180]
+    inline float Wrap(float degrees)
+    {
+        degrees = std::fmod(degrees, 360.0f);
+        if (degrees > 180.0f)
+            degrees -= 360.0f;
+        else if (degrees <= -180.0f)
+            degrees += 360.0f;
+        return degrees;
+    }
+
+    inline float SegmentDistance(const glm::vec2 &point, const glm::vec2 &a, const glm::vec2 &b)
+    {
+        const glm::vec2 ab = b - a;
+        const float lengthSquared = glm::dot(ab, ab);
+        const float t = lengthSquared > 0.0f ? glm::clamp(glm::dot(point - a, ab) / lengthSquared, 0.0f, 1.0f) : 0.0f;
+        return glm::length(point - (a + ab * t));
+    }
+
+    inline glm::vec2 Plane(const glm::vec3 &position) { return glm::vec2(position.x, position.z); }
+}
+
+inline void PocketWindow::CueRange(float maxCut, float &minDegrees, float &maxDegrees) const
+{
+    const float center = angle / 100.0f;
+    const float half = halfWidth / 100.0f;
+    minDegrees = center - half - maxCut;
+    maxDegrees = center + half + maxCut;
+}
+
+inline PocketField::PocketField(const TableGeometry &table, float ballRadius, float cellSize)
+    : table(table), ballRadius(ballRadius), cellSize(cellSize),
+      extent(table.width * 0.5f - ballRadius, table.height * 0.5f - ballRadius)
+{
+    columns = std::max(1, static_cast<int>(std::ceil(2.0f * extent.x / cellSize)));
+    rows = std::max(1, static_cast<int>(std::ceil(2.0f * extent.y / cellSize)));
+    pocketCount = std::min(static_cast<int>(table.pockets.size()), kMaxPockets);
+}
+
+inline int PocketField::CellIndex(const glm::vec3 &position) const
+{
+    const int column = static_cast<int>(std::floor((position.x + extent.x) / cellSize));
+    const int row = static_cast<int>(std::floor((position.z + extent.y) / cellSize));
+    if (column < 0 || column > columns || row < 0 || row > rows)
+        return -1;
+    // Шар, прижатый к борту, лежит ровно на границе поля
+    return std::min(row, rows - 1) * columns + std::min(column, columns - 1);
+}
+
+inline glm::vec2 PocketField::CellCenter(int cell) const
+{
+    return glm::vec2(-extent.x + (cell % columns + 0.5f) * cellSize, -extent.y + (cell / columns + 0.5f) * cellSize);
+}
+
+inline void PocketField::Build(size_t threads)
+{
+    const auto start = std::chrono::steady_clock::now();
+    windows.assign(static_cast<size_t>(columns) * rows * pocketCount, PocketWindow());
+
+    threads = std::max<size_t>(1, std::min<size_t>(threads ? threads : std::thread::hardware_concurrency(), rows));
+    std::atomic<int> nextRow{0};
+    auto worker = [&]()
+    {
+        for (int row = nextRow++; row < rows; row = nextRow++)
+        {
+            for (int column = 0; column < columns; ++column)
+            {
+                const int cell = row * columns + column;
+                for (int pocket = 0; pocket < pocketCount; ++pocket)
+                    windows[cell * pocketCount + pocket] = Compute(CellCenter(cell), pocket);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t)
+        pool.emplace_back(worker);
+    worker();
+    for (auto &thread : pool)
+        thread.join();
+
+    buildMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+inline PocketWindow PocketField::Compute(const glm::vec2 &point, int pocket) const
+{
+    const glm::vec2 center = PocketMath::Plane(table.pockets[pocket]);
+    const glm::vec2 toPocket = center - point;
+    if (glm::length(toPocket) <= table.pocketRadius)
+        return PocketWindow(); // Здесь шар уже в лузе
+
+    // Зона захвата лузы, обрезанная бортами, выпукла, как и поле центров шаров, поэтому
+    // её угловой размер из точки — крайние направления на точки её границы. Точки окружности
+    // за бортом проецируются на борт: проекция остаётся внутри круга.
+    const float heading = PocketMath::Heading(toPocket);
+    float low = 180.0f, high = -180.0f;
+    for (int i = 0; i < kMouthSamples; ++i)
+    {
+        const float phi = glm::two_pi<float>() * i / kMouthSamples;
+        glm::vec2 target = center + table.pocketRadius * glm::vec2(std::cos(phi), std::sin(phi));
+        target = glm::clamp(target, -extent, extent);
+        const float offset = PocketMath::Wrap(PocketMath::Heading(target - point) - heading);
+        low = std::min(low, offset);
+        high = std::max(high, offset);
+    }
+
+    PocketWindow window;
+    window.angle = PocketMath::ToCentidegrees(heading + 0.5f * (low + high));
+    window.halfWidth = static_cast<uint16_t>(std::lround(50.0f * (high - low)));
+    return window;
+}
+
+inline PocketWindow PocketField::Shift(const PocketWindow &window, int cell, const glm::vec3 &position, int pocket) const
+{
+    if (!window.Open())
+        return window;
+
+    const glm::vec2 center = PocketMath::Plane(table.pockets[pocket]);
+    const float delta = PocketMath::Wrap(PocketMath::Heading(center - PocketMath::Plane(position)) -
+                                         PocketMath::Heading(center - CellCenter(cell)));
+    PocketWindow shifted = window;
+    shifted.angle = PocketMath::ToCentidegrees(window.angle / 100.0f + delta);
+    return shifted;
+}
+
+inline PocketWindow PocketField::Lookup(const glm::vec3 &position, int pocket) const
+{
+    const int cell = CellIndex(position);
+    return cell < 0 ? PocketWindow() : Shift(At(cell, pocket), cell, position, pocket);
+}
+
+inline PocketLayout::PocketLayout(const PocketField &field)
+    : field(field),
+      windows(static_cast<size_t>(field.Columns()) * field.Rows() * field.PocketCount()),
+      dirty(windows.size(), 0)
+{
+    const int cellCount = field.Columns() * field.Rows();
+    for (int cell = 0; cell < cellCount; ++cell)
+    {
+        for (int pocket = 0; pocket < field.PocketCount(); ++pocket)
+            windows[cell * field.PocketCount() + pocket] = field.At(cell, pocket);
+    }
+}
+
+inline bool PocketLayout::InShadow(int cell, int pocket, const glm::vec2 &blocker) const
+{
+    // Шар заслоняет путь, если проходит ближе двух радиусов к отрезку клетка -> луза;
+    // окно шире отрезка не больше чем на радиус лузы
+    const float reach = 2.0f * field.BallRadius() + field.Table().pocketRadius;
+    return PocketMath::SegmentDistance(blocker, field.CellCenter(cell),
+                                       PocketMath::Plane(field.Table().pockets[pocket])) < reach;
+}
+
+inline void PocketLayout::Refine(const std::vector<Ball> &balls)
+{
+    const int cellCount = field.Columns() * field.Rows();
+    blockers.resize(std::max(blockers.size(), balls.size()));
+
+    // Тени только сдвинувшихся шаров: и откуда ушёл, и куда пришёл
+    bool anyMoved = false;
+    const float kMoveTolerance = 0.0005f;
+    for (size_t i = 1; i < blockers.size(); ++i)
+    {
+        Blocker current;
+        if (i < balls.size())
+        {
+            current.present = !IsPocketed(balls[i]);
+            current.position = PocketMath::Plane(balls[i].getPosition());
+        }
+
+        Blocker &previous = blockers[i];
+        const bool moved = current.present != previous.present ||
+                           (current.present && glm::length(current.position - previous.position) > kMoveTolerance);
+        if (!moved)
+            continue;
+
+        anyMoved = true;
+        for (int cell = 0; cell < cellCount; ++cell)
+        {
+            for (int pocket = 0; pocket < field.PocketCount(); ++pocket)
+            {
+                uint8_t &entry = dirty[cell * field.PocketCount() + pocket];
+                if (!entry && field.At(cell, pocket).Open() &&
+                    ((previous.present && InShadow(cell, pocket, previous.position)) ||
+                     (current.present && InShadow(cell, pocket, current.position))))
+                {
+                    entry = 1;
+                }
+            }
+        }
+        previous = current;
+    }
+
+    lastRefined = 0;
+    if (!anyMoved)
+        return;
+
+    for (int cell = 0; cell < cellCount; ++cell)
+    {
+        for (int pocket = 0; pocket < field.PocketCount(); ++pocket)
+        {
+            uint8_t &entry = dirty[cell * field.PocketCount() + pocket];
+            if (!entry)
+                continue;
+            RefineWindow(cell, pocket);
+            entry = 0;
+            ++lastRefined;
+        }
+    }
+}
+
+inline void PocketLayout::RefineWindow(int cell, int pocket)
+{
+    struct Interval
+    {
+        float low, high;
+    };
+    constexpr int kMaxIntervals = 24;
+
+    const glm::vec2 point = field.CellCenter(cell);
+    const float ballRadius = field.BallRadius();
+    const PocketWindow &base = field.At(cell, pocket);
+    PocketWindow &window = windows[cell * field.PocketCount() + pocket];
+    window = base;
+    if (!base.Open())
+        return;
+
+    // Открытые части окна — смещения от центра базового окна, градусы
+    const float center = base.angle / 100.0f;
+    const float pocketDistance = glm::length(PocketMath::Plane(field.Table().pockets[pocket]) - point);
+    Interval open[kMaxIntervals];
+    int openCount = 1;
+    open[0] = {-base.halfWidth / 100.0f, base.halfWidth / 100.0f};
+
+    for (size_t i = 1; i < blockers.size() && openCount > 0; ++i)
+    {
+        const Blocker &blocker = blockers[i];
+        if (!blocker.present)
+            continue;
+        const glm::vec2 toBlocker = blocker.position - point;
+        const float distance = glm::length(toBlocker);
+        // Шар в самой клетке — это тот, кого спрашивают; за лузой — не мешает
+        if (distance < 1.5f * ballRadius || distance > pocketDistance + 2.0f * ballRadius)
+            continue;
+
+        const float shadowCenter = PocketMath::Wrap(PocketMath::Heading(toBlocker) - center);
+        const float shadowHalf = glm::degrees(std::asin(std::min(1.0f, 2.0f * ballRadius / distance)));
+        const float low = shadowCenter - shadowHalf;
+        const float high = shadowCenter + shadowHalf;
+
+        Interval next[kMaxIntervals];
+        int nextCount = 0;
+        for (int k = 0; k < openCount; ++k)
+        {
+            const Interval &part = open[k];
+            if (high <= part.low || low >= part.high)
+            {
+                // Просветов больше kMaxIntervals — лишние отбрасываются (нужны десятки шаров в окне)
+                if (nextCount < kMaxIntervals)
+                    next[nextCount++] = part;
+                continue;
+            }
+            if (low > part.low && nextCount < kMaxIntervals)
+                next[nextCount++] = {part.low, low};
+            if (high < part.high && nextCount < kMaxIntervals)
+                next[nextCount++] = {high, part.high};
+        }
+        std::copy(next, next + nextCount, open);
+        openCount = nextCount;
+    }
+
+    // Окно — самый широкий из оставшихся просветов
+    Interval best = {0.0f, 0.0f};
+    for (int k = 0; k < openCount; ++k)
+    {
+        if (open[k].high - open[k].low > best.high - best.low)
+            best = open[k];
+    }
+    window.angle = PocketMath::ToCentidegrees(center + 0.5f * (best.low + best.high));
+    window.halfWidth = static_cast<uint16_t>(std::lround(50.0f * (best.high - best.low)));
+}
+
+inline PocketWindow PocketLayout::Lookup(const glm::vec3 &position, int pocket) const
+{
+    const int cell = field.CellIndex(position);
+    return cell < 0 ? PocketWindow() : field.Shift(windows[cell * field.PocketCount() + pocket], cell, position, pocket);
+}
+
+inline void PocketLayout::Candidates(const std::vector<Ball> &balls, float friction, float maxForce,
+                                     std::vector<ShotCandidate> &out) const
+{
+    out.clear();
+    if (balls.empty() || IsPocketed(balls[0]))
+        return;
+
+    const float ballRadius = field.BallRadius();
+    const glm::vec2 cueBall = PocketMath::Plane(balls[0].getPosition());
+    const glm::vec2 extent(field.Table().width * 0.5f - ballRadius, field.Table().height * 0.5f - ballRadius);
+
+    for (size_t i = 1; i < balls.size(); ++i)
+    {
+        if (IsPocketed(balls[i]))
+            continue;
+        const glm::vec2 target = PocketMath::Plane(balls[i].getPosition());
+
+        for (int pocket = 0; pocket < field.PocketCount(); ++pocket)
+        {
+            const PocketWindow window = Lookup(balls[i].getPosition(), pocket);
+            if (!window.Open())
+                continue;
+
+            // Призрачный шар: где должен оказаться биток в момент удара
+            const float objectHeading = window.angle / 100.0f;
+            const glm::vec2 objectDirection(std::cos(glm::radians(objectHeading)), std::sin(glm::radians(objectHeading)));
+            const glm::vec2 ghost = target - 2.0f * ballRadius * objectDirection;
+            if (glm::any(glm::greaterThan(glm::abs(ghost), extent)))
+                continue;
+
+            const glm::vec2 cuePath = ghost - cueBall;
+            const float cueDistance = glm::length(cuePath);
+            if (cueDistance < 1e-4f)
+                continue;
+            const float cueHeading = PocketMath::Heading(cuePath);
+            const float cut = PocketMath::Wrap(cueHeading - objectHeading);
+            if (std::abs(cut) > PocketField::kMaxCutDegrees)
+                continue;
+
+            bool blocked = false;
+            for (size_t j = 1; j < balls.size() && !blocked; ++j)
+            {
+                if (j != i && !IsPocketed(balls[j]))
+                    blocked = PocketMath::SegmentDistance(PocketMath::Plane(balls[j].getPosition()), cueBall, ghost) <
+                              2.0f * ballRadius;
+            }
+            if (blocked)
+                continue;
+
+            // Ошибка направления битка δ сдвигает точку встречи на d·δ, а направление
+            // прицельного — на d·δ / (2r·cos(резки)): допуск окна пересчитывается к битку
+            const float cosCut = std::cos(glm::radians(cut));
+            ShotCandidate candidate;
+            candidate.ball = static_cast<int>(i);
+            candidate.pocket = pocket;
+            candidate.cut = cut;
+            candidate.margin = window.halfWidth / 100.0f * 2.0f * ballRadius * cosCut / std::max(cueDistance, 2.0f * ballRadius);
+
+            // Равнозамедленное качение: v² = 2·a·s. Прицельный шар получает v·cos(резки);
+            // запас в полтора раза — на неупругость соударения
+            const float objectDistance = glm::length(PocketMath::Plane(field.Table().pockets[pocket]) - target);
+            const float speed = 1.5f * std::sqrt(2.0f * friction * (cueDistance + objectDistance / (cosCut * cosCut)));
+            const float power = glm::clamp(speed * balls[0].getMass() / maxForce, 0.15f, 1.0f);
+
+            candidate.shot.angle = PocketMath::ToCentidegrees(cueHeading);
+            candidate.shot.power = static_cast<int32_t>(std::lround(power * 256.0f));
+            out.push_back(candidate);
+        }
+    }
+
+    std::sort(out.begin(), out.end(),
+              [](const ShotCandidate &a, const ShotCandidate &b) { return a.margin > b.margin; });
+}
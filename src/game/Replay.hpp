@@ -0,0 +1,188 @@
+#pragma once
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "Ball.hpp"
+
+// Состояние шара в кадре повтора
+struct ReplayBall
+{
+    glm::vec3 position;
+    glm::quat rotation;
+};
+
+// Состояние кия в кадре повтора — уже готовая для отрисовки геометрия
+struct ReplayCue
+{
+    glm::vec3 start = glm::vec3(0.0f);
+    glm::vec3 end = glm::vec3(0.0f);
+    glm::vec3 hitPoint = glm::vec3(0.0f);
+    glm::vec3 impact = glm::vec3(0.0f);
+    float radius = 0.0f;
+    float power = 0.0f;
+    uint32_t visible = 0;
+};
+
+// Запись партии: по кадру на каждый шаг игрового цикла (время, шары, кий).
+// Воспроизведение с любой частотой кадров через Sample(): позиции интерполируются
+// линейно, вращения — slerp.
+class Replay
+{
+public:
+    void Reset(uint32_t ballCount, float ballRadius);
+    void Record(float time, const std::vector<ReplayBall> &frameBalls, const ReplayCue &cue);
+
+    bool Save(const std::string &path) const;
+    bool Load(const std::string &path);
+
+    size_t FrameCount() const { return times.size(); }
+    uint32_t BallCount() const { return ballCount; }
+    float BallRadius() const { return ballRadius; }
+    float Duration() const { return times.empty() ? 0.0f : times.back() - times.front(); }
+
+    // Состояние на момент time (от начала записи)
+    void Sample(float time, std::vector<ReplayBall> &outBalls, ReplayCue &outCue) const;
+
+    static void Capture(const std::vector<Ball> &source, std::vector<ReplayBall> &out);
+
+private:
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t ballCount;
+        uint32_t frameCount;
+        float ballRadius;
+        uint32_t reserved;
+    };
+
+    static constexpr uint32_t kVersion = 1;
+
+    uint32_t ballCount = 0;
+    float ballRadius = 0.0f;
+    std::vector<float> times;
+    std::vector<ReplayBall> balls; // frameCount * ballCount
+    std::vector<ReplayCue> cues;
+};
+
+inline void Replay::Reset(uint32_t count, float radius)
+{
+    ballCount = count;
+    ballRadius = radius;
+    times.clear();
+    balls.clear();
+    cues.clear();
+}
+
+inline void Replay::Capture(const std::vector<Ball> &source, std::vector<ReplayBall> &out)
+{
+    out.resize(source.size());
+    for (size_t i = 0; i < source.size(); ++i)
+    {
+        out[i] = {source[i].getPosition(), source[i].getRotation()};
+    }
+}
+
+inline void Replay::Record(float time, const std::vector<ReplayBall> &frameBalls, const ReplayCue &cue)
+{
+    if (frameBalls.size() != ballCount)
+        return;
+
+    times.push_back(time);
+    balls.insert(balls.end(), frameBalls.begin(), frameBalls.end());
+    cues.push_back(cue);
+}
+
+inline bool Replay::Save(const std::string &path) const
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    FileHeader header = {{'B', 'R', 'P', 'L'}, kVersion, ballCount,
+                         static_cast<uint32_t>(times.size()), ballRadius, 0};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(times.data()), times.size() * sizeof(float));
+    file.write(reinterpret_cast<const char *>(balls.data()), balls.size() * sizeof(ReplayBall));
+    file.write(reinterpret_cast<const char *>(cues.data()), cues.size() * sizeof(ReplayCue));
+    return static_cast<bool>(file);
+}
+
+inline bool Replay::Load(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    FileHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, "BRPL", 4) != 0 || header.version != kVersion)
+    {
+        return false;
+    }
+
+    // Размеры из заголовка сверяем с длиной файла до выделения памяти: повреждённый или чужой
+    // файл не должен заставить resize запросить гигабайты
+    const std::streamoff dataStart = file.tellg();
+    file.seekg(0, std::ios::end);
+    const std::streamoff fileEnd = file.tellg();
+    file.seekg(dataStart);
+    if (dataStart < 0 || fileEnd < dataStart)
+        return false;
+    const uint64_t available = static_cast<uint64_t>(fileEnd - dataStart);
+    const uint64_t frameBytes = sizeof(float) + sizeof(ReplayCue) + uint64_t(header.ballCount) * sizeof(ReplayBall);
+    if (header.frameCount > available / frameBytes || header.frameCount * frameBytes != available)
+        return false;
+
+    Reset(header.ballCount, header.ballRadius);
+    times.resize(header.frameCount);
+    balls.resize(static_cast<size_t>(header.frameCount) * header.ballCount);
+    cues.resize(header.frameCount);
+    file.read(reinterpret_cast<char *>(times.data()), times.size() * sizeof(float));
+    file.read(reinterpret_cast<char *>(balls.data()), balls.size() * sizeof(ReplayBall));
+    file.read(reinterpret_cast<char *>(cues.data()), cues.size() * sizeof(ReplayCue));
+    if (!file)
+    {
+        Reset(0, 0.0f);
+        return false;
+    }
+    return true;
+}
+
+inline void Replay::Sample(float time, std::vector<ReplayBall> &outBalls, ReplayCue &outCue) const
+{
+    outBalls.resize(ballCount);
+    if (times.empty())
+    {
+        outCue = ReplayCue();
+        return;
+    }
+
+    // Первый кадр с временем > t; интерполируем между ним и предыдущим
+    const float t = times.front() + time;
+    const size_t next = std::upper_bound(times.begin(), times.end(), t) - times.begin();
+    const size_t b = std::min(next, times.size() - 1);
+    const size_t a = next == 0 ? 0 : next - 1;
+    const float span = times[b] - times[a];
+    const float alpha = span > 0.0f ? std::clamp((t - times[a]) / span, 0.0f, 1.0f) : 0.0f;
+
+    const ReplayBall *from = balls.data() + a * ballCount;
+    const ReplayBall *to = balls.data() + b * ballCount;
+    for (uint32_t i = 0; i < ballCount; ++i)
+    {
+        // Забитый шар телепортируется за стол — такой переход не интерполируем
+        if (glm::distance(from[i].position, to[i].position) > 1.0f)
+        {
+            outBalls[i] = alpha < 0.5f ? from[i] : to[i];
+            continue;
+        }
+        outBalls[i].position = glm::mix(from[i].position, to[i].position, alpha);
+        outBalls[i].rotation = glm::slerp(from[i].rotation, to[i].rotation, alpha);
+    }
+
+    outCue = alpha < 0.5f ? cues[a] : cues[b];
+}
@@ -0,0 +1,249 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <core/MappedFile.hpp>
+#include "Ball.hpp"
+#include "ShotCache.hpp"
+#include "Table.hpp"
+
+// Сценарий для пакетного анализа: неподвижная расстановка и удар по битку.
+// Запись фиксированного размера, файл читается отображением в память без разбора.
+struct ScenarioRecord
+{
+    static constexpr uint32_t kMaxBalls = 16;
+
+    float positions[kMaxBalls][2]; // x, z на плоскости стола; забитые шары не используются
+    uint32_t ballCount;
+    uint32_t pocketedMask; // Шары, уже забитые до удара
+    ShotParams shot;
+
+    static ScenarioRecord FromBalls(const std::vector<Ball> &balls, const ShotParams &shot);
+
+    // Расстановка для симуляции; out переиспользуется между записями
+    void ToBalls(float ballRadius, float ballMass, std::vector<Ball> &out) const;
+};
+
+static_assert(std::is_trivially_copyable<ScenarioRecord>::value, "ScenarioRecord is read straight from the mapping");
+static_assert(sizeof(ScenarioRecord) == 152, "ScenarioRecord layout is part of the file format");
+
+// Последовательная запись файла сценариев. Число записей дописывается в заголовок в Close().
+class ScenarioWriter
+{
+public:
+    ~ScenarioWriter() { Close(); }
+
+    bool Open(const std::string &path, float ballRadius);
+    bool Write(const ScenarioRecord &record);
+    bool Write(const std::vector<Ball> &balls, const ShotParams &shot) { return Write(ScenarioRecord::FromBalls(balls, shot)); }
+    bool Close();
+
+    uint64_t RecordCount() const { return recordCount; }
+
+private:
+    std::ofstream file;
+    float ballRadius = 0.0f;
+    uint64_t recordCount = 0;
+};
+
+// Чтение файла сценариев прямо из отображения: записи отдаются рабочим потокам диапазонами,
+// с упреждающим чтением следующих диапазонов и освобождением пройденных.
+class ScenarioReader
+{
+public:
+    bool Open(const std::string &path);
+    void Close() { file.Close(); }
+
+    uint64_t RecordCount() const { return recordCount; }
+    float BallRadius() const { return ballRadius; }
+    const ScenarioRecord *Records() const { return records; }
+
+    // fn(worker, first, records, count) для каждого диапазона из spanRecords записей.
+    // Диапазоны раздаются threads потокам из общего счётчика; fn не должна бросать исключения.
+    template <typename Fn>
+    void ForEachSpan(size_t threads, size_t spanRecords, Fn &&fn) const;
+
+    // То же для первых limit записей: дальше файл не читается и не подгружается
+    template <typename Fn>
+    void ForEachSpan(size_t threads, size_t spanRecords, uint64_t limit, Fn &&fn) const;
+
+private:
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t recordSize;
+        float ballRadius;
+        uint64_t recordCount;
+        uint64_t reserved;
+    };
+
+    static constexpr uint32_t kVersion = 1;
+
+    MappedFile file;
+    const ScenarioRecord *records = nullptr;
+    uint64_t recordCount = 0;
+    float ballRadius = 0.0f;
+
+    friend class ScenarioWriter;
+};
+
+inline ScenarioRecord ScenarioRecord::FromBalls(const std::vector<Ball> &balls, const ShotParams &shot)
+{
+    ScenarioRecord record = {};
+    record.ballCount = static_cast<uint32_t>(std::min<size_t>(balls.size(), kMaxBalls));
+    record.shot = shot;
+    for (uint32_t i = 0; i < record.ballCount; ++i)
+    {
+        if (IsPocketed(balls[i]))
+        {
+            record.pocketedMask |= 1u << i;
+            continue;
+        }
+        record.positions[i][0] = balls[i].getPosition().x;
+        record.positions[i][1] = balls[i].getPosition().z;
+    }
+    return record;
+}
+
+inline void ScenarioRecord::ToBalls(float ballRadius, float ballMass, std::vector<Ball> &out) const
+{
+    out.clear();
+    const uint32_t count = std::min(ballCount, kMaxBalls);
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        const glm::vec3 position = (pocketedMask >> i) & 1u
+                                       ? kPocketedPosition
+                                       : glm::vec3(positions[i][0], ballRadius, positions[i][1]);
+        out.emplace_back(position, ballRadius, ballMass);
+    }
+}
+
+inline bool ScenarioWriter::Open(const std::string &path, float radius)
+{
+    Close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    ballRadius = radius;
+    recordCount = 0;
+    // Заголовок с нулевым числом записей: незакрытый файл читатель не примет
+    const ScenarioReader::FileHeader header = {{'B', 'S', 'C', 'N'}, ScenarioReader::kVersion,
+                                               sizeof(ScenarioRecord), ballRadius, 0, 0};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    return static_cast<bool>(file);
+}
+
+inline bool ScenarioWriter::Write(const ScenarioRecord &record)
+{
+    if (!file.is_open())
+        return false;
+    file.write(reinterpret_cast<const char *>(&record), sizeof(record));
+    ++recordCount;
+    return static_cast<bool>(file);
+}
+
+inline bool ScenarioWriter::Close()
+{
+    if (!file.is_open())
+        return true;
+
+    const ScenarioReader::FileHeader header = {{'B', 'S', 'C', 'N'}, ScenarioReader::kVersion,
+                                               sizeof(ScenarioRecord), ballRadius, recordCount, 0};
+    file.seekp(0);
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    const bool ok = static_cast<bool>(file);
+    file.close();
+    return ok;
+}
+
+inline bool ScenarioReader::Open(const std::string &path)
+{
+    Close();
+    records = nullptr;
+    recordCount = 0;
+    if (!file.Open(path) || file.Size() < sizeof(FileHeader))
+        return false;
+
+    FileHeader header;
+    std::memcpy(&header, file.Data(), sizeof(header));
+    if (std::memcmp(header.magic, "BSCN", 4) != 0 || header.version != kVersion ||
+        header.recordSize != sizeof(ScenarioRecord) ||
+        header.recordCount > (file.Size() - sizeof(FileHeader)) / sizeof(ScenarioRecord))
+    {
+        Close();
+        return false;
+    }
+
+    // Заголовок кратен 8 байтам, отображение выровнено по странице — записи читаются на месте
+    records = reinterpret_cast<const ScenarioRecord *>(file.Data() + sizeof(FileHeader));
+    recordCount = header.recordCount;
+    ballRadius = header.ballRadius;
+    file.Advise(0, file.Size(), MappedFile::Access::Sequential);
+    return true;
+}
+
+template <typename Fn>
+void ScenarioReader::ForEachSpan(size_t threads, size_t spanRecords, Fn &&fn) const
+{
+    ForEachSpan(threads, spanRecords, recordCount, std::forward<Fn>(fn));
+}
+
+template <typename Fn>
+void ScenarioReader::ForEachSpan(size_t threads, size_t spanRecords, uint64_t limit, Fn &&fn) const
+{
+    const uint64_t total = std::min(limit, recordCount);
+    if (total == 0)
+        return;
+
+    spanRecords = std::max<size_t>(1, spanRecords);
+    const uint64_t spanCount = (total + spanRecords - 1) / spanRecords;
+    threads = std::max<size_t>(1, std::min<uint64_t>(threads ? threads : std::thread::hardware_concurrency(), spanCount));
+
+    // Последний диапазон может быть короче — подгружается только до total
+    auto advise = [&](uint64_t span, MappedFile::Access access)
+    {
+        if (span >= spanCount)
+            return;
+        const uint64_t first = span * spanRecords;
+        const uint64_t size = std::min<uint64_t>(spanRecords, total - first);
+        file.Advise(sizeof(FileHeader) + first * sizeof(ScenarioRecord),
+                    static_cast<size_t>(size * sizeof(ScenarioRecord)), access);
+    };
+
+    // Первая волна читается заранее, дальше каждый поток подгружает диапазон на круг вперёд
+    for (uint64_t span = 0; span < threads; ++span)
+        advise(span, MappedFile::Access::WillNeed);
+
+    std::atomic<uint64_t> next{0};
+    auto worker = [&](size_t index)
+    {
+        for (uint64_t span = next++; span < spanCount; span = next++)
+        {
+            advise(span + threads, MappedFile::Access::WillNeed);
+
+            const uint64_t first = span * spanRecords;
+            const size_t count = static_cast<size_t>(std::min<uint64_t>(spanRecords, total - first));
+            fn(index, first, records + first, count);
+
+            advise(span, MappedFile::Access::DontNeed);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < threads; ++t)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for (auto &thread : pool)
+        thread.join();
+}
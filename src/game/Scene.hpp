@@ -1,17 +1,16 @@
 #pragma once
 
 #include <render/Renderer.hpp>
+#include <core/Tracer.hpp>
+#include "Table.hpp"
 #include <glm/glm.hpp>
 #include <vector>
 
 class Scene
 {
 public:
-    Scene();
-    void Render(Renderer &renderer,
-                const glm::mat4 &view,
-                const glm::mat4 &projection,
-                const glm::vec3 &cameraPos);
+    explicit Scene(const TableGeometry &table = TableGeometry());
+    void Render(Renderer &renderer, const glm::vec3 &cameraPos);
 
 private:
     glm::vec2 tableSize;
@@ -28,41 +27,29 @@ private:
     glm::vec3 legColor; // Цвет ножек
 
     void drawSkyBackground();
-    void drawFloor(Renderer &renderer,
-                   const glm::mat4 &view,
-                   const glm::mat4 &projection);
-    void drawTable(Renderer &renderer,
-                   const glm::mat4 &view,
-                   const glm::mat4 &projection);
+    void drawFloor(Renderer &renderer);
+    void drawTable(Renderer &renderer);
 };
 
-inline Scene::Scene()
-    : tableSize(2.0f, 1.0f),
+inline Scene::Scene(const TableGeometry &table)
+    : tableSize(table.width, table.height),
       tableColor(0.0f, 0.3f, 0.0f),
       floorColor(0.2f, 0.15f, 0.1f),
       skyColor(0.5f, 0.7f, 1.0f),
       wallColor(0.3f, 0.2f, 0.1f),
       wallHeight(0.1f),
       wallThickness(0.05f),
-      pocketRadius(0.08f),
+      pocketRadius(table.pocketRadius),
+      pocketPositions(table.pockets),
       legWidth(0.08f),             // Ширина ножки (8 см)
       legHeight(0.6f),             // Высота ножки (60 см)
       legColor(0.3f, 0.15f, 0.05f) // Цвет ножек (коричневый)
 {
-    pocketPositions = {
-        {-0.95f, 0.01f, -0.45f},
-        {-0.95f, 0.01f, 0.45f},
-        {0.95f, 0.01f, -0.45f},
-        {0.95f, 0.01f, 0.45f},
-        {0.0f, 0.01f, -0.45f},
-        {0.0f, 0.01f, 0.45f}};
 }
 
-inline void Scene::Render(Renderer &renderer,
-                          const glm::mat4 &view,
-                          const glm::mat4 &projection,
-                          const glm::vec3 &cameraPos)
+inline void Scene::Render(Renderer &renderer, const glm::vec3 &cameraPos)
 {
+    TRACE_SCOPE("Scene::Render");
     // Передаём позицию камеры в renderer (если нужно для расчётов света и т.п.)
     renderer.SetCameraPos(cameraPos);
 
@@ -70,29 +57,27 @@ inline void Scene::Render(Renderer &renderer,
     drawSkyBackground();
 
     // Рисуем пол
-    drawFloor(renderer, view, projection);
+    drawFloor(renderer);
 
     // Рисуем сам стол с бортиками и лунками
-    drawTable(renderer, view, projection);
+    drawTable(renderer);
 
     // Затем лунки (после стола, чтобы они были сверху)
     for (const auto &pocket : pocketPositions)
     {
-        renderer.DrawPocket(pocket, pocketRadius, view, projection);
+        renderer.DrawPocket(pocket, pocketRadius);
     }
 }
 
 inline void Scene::drawSkyBackground()
 {
     // установка цвета фона
-    glClearColor(skyColor.r, skyColor.g, skyColor.b, 1.0f);
+    GLState::ClearColor(skyColor.r, skyColor.g, skyColor.b, 1.0f);
     // очистка глубины и цвета
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
 
-inline void Scene::drawFloor(Renderer &renderer,
-                             const glm::mat4 &view,
-                             const glm::mat4 &projection)
+inline void Scene::drawFloor(Renderer &renderer)
 {
     // 1. Рассчитываем позицию самой нижней точки ножек
     float lowestLegY = -legHeight / 2.0f; // Центр ножки
@@ -112,13 +97,13 @@ inline void Scene::drawFloor(Renderer &renderer,
     glm::vec3 floorPos(0.0f, lowestLegY, 0.0f);
 
     // 5. Отрисовка
-    renderer.DrawTable(floorPos, floorSize, floorColor, view, projection);
+    renderer.DrawTable(floorPos, floorSize, floorColor);
 }
 
-inline void Scene::drawTable(Renderer &renderer, const glm::mat4 &view, const glm::mat4 &projection)
+inline void Scene::drawTable(Renderer &renderer)
 {
     // Игровая поверхность
-    renderer.DrawTable(glm::vec3(0, 0, 0), tableSize, tableColor, view, projection);
+    renderer.DrawTable(glm::vec3(0, 0, 0), tableSize, tableColor);
 
     // Размеры бортиков
     glm::vec3 sizeX(tableSize.x + 2 * wallThickness, wallHeight, wallThickness);
@@ -129,7 +114,7 @@ inline void Scene::drawTable(Renderer &renderer, const glm::mat4 &view, const gl
     glm::vec3 sideColor(0.5f, 0.35f, 0.2f); // Светло-коричневый для боковин
 
     // Столешница
-    renderer.DrawTable(glm::vec3(0, -0.01f, 0), tableSize, sideColor, view, projection);
+    renderer.DrawTable(glm::vec3(0, -0.01f, 0), tableSize, sideColor);
 
     // Высота верхней части (1/4 от общей высоты)
     float topHeight = wallHeight / 4;
@@ -139,57 +124,57 @@ inline void Scene::drawTable(Renderer &renderer, const glm::mat4 &view, const gl
     renderer.DrawBox(
         glm::vec3(0.0f, baseHeight / 2, tableSize.y / 2 + wallThickness / 2),
         glm::vec3(sizeX.x, baseHeight, sizeX.z),
-        sideColor, view, projection);
+        sideColor);
 
     // Задний бортик (верх)
     renderer.DrawBox(
         glm::vec3(0.0f, baseHeight + topHeight / 2, tableSize.y / 2 + wallThickness / 2),
         glm::vec3(sizeX.x, topHeight, sizeX.z),
-        topColor, view, projection);
+        topColor);
 
     // Передний бортик (основание)
     renderer.DrawBox(
         glm::vec3(0.0f, baseHeight / 2, -(tableSize.y / 2 + wallThickness / 2)),
         glm::vec3(sizeX.x, baseHeight, sizeX.z),
-        sideColor, view, projection);
+        sideColor);
 
     // Передний бортик (верх)
     renderer.DrawBox(
         glm::vec3(0.0f, baseHeight + topHeight / 2, -(tableSize.y / 2 + wallThickness / 2)),
         glm::vec3(sizeX.x, topHeight, sizeX.z),
-        topColor, view, projection);
+        topColor);
 
     // Левый бортик (основание)
     renderer.DrawBox(
         glm::vec3(-(tableSize.x / 2 + wallThickness / 2), baseHeight / 2, 0.0f),
         glm::vec3(sizeZ.x, baseHeight, sizeZ.z),
-        sideColor, view, projection);
+        sideColor);
 
     // Левый бортик (верх)
     renderer.DrawBox(
         glm::vec3(-(tableSize.x / 2 + wallThickness / 2), baseHeight + topHeight / 2, 0.0f),
         glm::vec3(sizeZ.x, topHeight, sizeZ.z),
-        topColor, view, projection);
+        topColor);
 
     // Правый бортик (основание)
     renderer.DrawBox(
         glm::vec3(tableSize.x / 2 + wallThickness / 2, baseHeight / 2, 0.0f),
         glm::vec3(sizeZ.x, baseHeight, sizeZ.z),
-        sideColor, view, projection);
+        sideColor);
 
     // Правый бортик (верх)
     renderer.DrawBox(
         glm::vec3(tableSize.x / 2 + wallThickness / 2, baseHeight + topHeight / 2, 0.0f),
         glm::vec3(sizeZ.x, topHeight, sizeZ.z),
-        topColor, view, projection);
+        topColor);
 
     // Ножки стола (остаются без изменений)
     glm::vec3 legSize(legWidth, legHeight, legWidth);
     float xCorner = tableSize.x / 2 + wallThickness - legWidth / 2;
     float zCorner = tableSize.y / 2 + wallThickness - legWidth / 2;
 
-    renderer.DrawBox(glm::vec3(-xCorner, -legHeight / 2, -zCorner), legSize, legColor, view, projection);
-    renderer.DrawBox(glm::vec3(-xCorner, -legHeight / 2, zCorner), legSize, legColor, view, projection);
-    renderer.DrawBox(glm::vec3(xCorner, -legHeight / 2, -zCorner), legSize, legColor, view, projection);
-    renderer.DrawBox(glm::vec3(xCorner, -legHeight / 2, zCorner), legSize, legColor, view, projection);
+    renderer.DrawBox(glm::vec3(-xCorner, -legHeight / 2, -zCorner), legSize, legColor);
+    renderer.DrawBox(glm::vec3(-xCorner, -legHeight / 2, zCorner), legSize, legColor);
+    renderer.DrawBox(glm::vec3(xCorner, -legHeight / 2, -zCorner), legSize, legColor);
+    renderer.DrawBox(glm::vec3(xCorner, -legHeight / 2, zCorner), legSize, legColor);
 }
\ No newline at end of file
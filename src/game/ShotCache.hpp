@@ -0,0 +1,257 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "Ball.hpp"
+#include "Cue.hpp"
+#include "Table.hpp"
+
+// Параметры удара, квантованные для ключа кэша. Симуляция использует именно квантованные
+// значения, поэтому одинаковый ключ всегда даёт одинаковый результат.
+struct ShotParams
+{
+    int32_t angle = 0;   // Направление в плоскости стола, 1/100 градуса
+    int32_t power = 0;   // Сила, 1/256
+    int32_t offsetX = 0; // Смещение точки удара, 1/256 радиуса
+    int32_t offsetY = 0;
+
+    static ShotParams FromCue(const Cue &cue);
+
+    glm::vec3 Direction() const;
+    float Power() const { return power / 256.0f; }
+    glm::vec2 Offset() const { return glm::vec2(offsetX, offsetY) / 256.0f; }
+
+    uint64_t Key() const;
+};
+
+// Результат симуляции удара до остановки всех шаров
+struct ShotOutcome
+{
+    static constexpr size_t kMaxPathPoints = 128;
+
+    std::vector<glm::vec3> finalPositions;
+    uint32_t pocketedMask = 0; // Шары, забитые этим ударом
+    int firstContact = -1;     // Первый шар, сдвинутый битком
+    uint32_t collisions = 0;   // Соударения шаров с отскоком
+    float duration = 0.0f;     // Время до остановки, с
+    std::vector<glm::vec3> cuePath; // Траектория битка (прореженная)
+    std::vector<glm::vec3> objectPath; // Траектория шара firstContact от касания (прореженная)
+};
+
+// Канонический хэш расстановки: позиции стоящих шаров на сетке 0.5 мм и набор забитых.
+// Незначительные различия (шум интегрирования) дают тот же ключ.
+uint64_t TableStateHash(const std::vector<Ball> &balls);
+
+// Потокобезопасный кэш результатов ударов ограниченного размера.
+// Разбит на шарды со своими мьютексами; вытеснение внутри шарда — CLOCK (второй шанс).
+class ShotOutcomeCache
+{
+public:
+    struct Stats
+    {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t inserts = 0;
+        uint64_t evictions = 0;
+    };
+
+    explicit ShotOutcomeCache(size_t capacity = 4096);
+
+    std::shared_ptr<const ShotOutcome> Find(uint64_t stateHash, uint64_t shotKey);
+    void Insert(uint64_t stateHash, uint64_t shotKey, std::shared_ptr<const ShotOutcome> outcome);
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    static constexpr size_t kShards = 16;
+
+    struct Entry
+    {
+        uint64_t stateHash = 0;
+        uint64_t shotKey = 0;
+        std::shared_ptr<const ShotOutcome> outcome;
+        bool referenced = false;
+    };
+
+    struct Shard
+    {
+        std::mutex mutex;
+        std::vector<Entry> entries;
+        std::unordered_map<uint64_t, size_t> index; // Комбинированный ключ -> слот
+        size_t hand = 0;                            // Стрелка CLOCK
+    };
+
+    size_t shardCapacity;
+    Shard shards[kShards];
+
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> inserts{0};
+    std::atomic<uint64_t> evictions{0};
+
+    static uint64_t Combine(uint64_t stateHash, uint64_t shotKey);
+};
+
+inline uint64_t MixHash(uint64_t value)
+{
+    // Финализатор splitmix64
+    value += 0x9e3779b97f4a7c15ull;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+    return value ^ (value >> 31);
+}
+
+inline ShotParams ShotParams::FromCue(const Cue &cue)
+{
+    const glm::vec3 direction = cue.getDirection();
+    float degrees = glm::degrees(std::atan2(direction.z, direction.x));
+    if (degrees < 0.0f)
+        degrees += 360.0f;
+
+    ShotParams params;
+    params.angle = static_cast<int32_t>(std::lround(degrees * 100.0f)) % 36000;
+    params.power = static_cast<int32_t>(std::lround(cue.getPower() * 256.0f));
+    params.offsetX = static_cast<int32_t>(std::lround(cue.getOffset().x * 256.0f));
+    params.offsetY = static_cast<int32_t>(std::lround(cue.getOffset().y * 256.0f));
+    return params;
+}
+
+inline glm::vec3 ShotParams::Direction() const
+{
+    const float radians = glm::radians(angle / 100.0f);
+    return glm::vec3(std::cos(radians), 0.0f, std::sin(radians));
+}
+
+inline uint64_t ShotParams::Key() const
+{
+    uint64_t key = MixHash(static_cast<uint32_t>(angle));
+    key = MixHash(key ^ static_cast<uint32_t>(power));
+    key = MixHash(key ^ static_cast<uint32_t>(offsetX));
+    key = MixHash(key ^ static_cast<uint32_t>(offsetY));
+    return key;
+}
+
+inline uint64_t TableStateHash(const std::vector<Ball> &balls)
+{
+    const float kGrid = 0.0005f;
+    uint64_t hash = MixHash(balls.size());
+    uint64_t pocketed = 0;
+    for (size_t i = 0; i < balls.size(); ++i)
+    {
+        if (IsPocketed(balls[i]))
+        {
+            pocketed |= uint64_t(1) << (i & 63);
+            continue;
+        }
+        const glm::vec3 &p = balls[i].getPosition();
+        const uint64_t x = static_cast<uint32_t>(static_cast<int32_t>(std::lround(p.x / kGrid)));
+        const uint64_t z = static_cast<uint32_t>(static_cast<int32_t>(std::lround(p.z / kGrid)));
+        hash = MixHash(hash ^ (i << 56) ^ (x << 28) ^ z);
+    }
+    return MixHash(hash ^ pocketed);
+}
+
+inline ShotOutcomeCache::ShotOutcomeCache(size_t capacity)
+    : shardCapacity(std::max<size_t>(1, (capacity + kShards - 1) / kShards))
+{
+    for (Shard &shard : shards)
+    {
+        shard.entries.reserve(shardCapacity);
+        shard.index.reserve(shardCapacity);
+    }
+}
+
+inline uint64_t ShotOutcomeCache::Combine(uint64_t stateHash, uint64_t shotKey)
+{
+    return MixHash(stateHash ^ MixHash(shotKey));
+}
+
+inline std::shared_ptr<const ShotOutcome> ShotOutcomeCache::Find(uint64_t stateHash, uint64_t shotKey)
+{
+    const uint64_t key = Combine(stateHash, shotKey);
+    Shard &shard = shards[key >> 60];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end())
+    {
+        Entry &entry = shard.entries[it->second];
+        if (entry.stateHash == stateHash && entry.shotKey == shotKey)
+        {
+            entry.referenced = true;
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return entry.outcome;
+        }
+    }
+    misses.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+inline void ShotOutcomeCache::Insert(uint64_t stateHash, uint64_t shotKey, std::shared_ptr<const ShotOutcome> outcome)
+{
+    const uint64_t key = Combine(stateHash, shotKey);
+    Shard &shard = shards[key >> 60];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end())
+    {
+        // Уже есть (посчитал другой поток) или коллизия комбинированного ключа — перезаписываем
+        shard.entries[it->second] = {stateHash, shotKey, std::move(outcome), true};
+        return;
+    }
+
+    size_t slot;
+    if (shard.entries.size() < shardCapacity)
+    {
+        slot = shard.entries.size();
+        shard.entries.emplace_back();
+    }
+    else
+    {
+        // CLOCK: пропускаем записи с флагом обращения, снимая его
+        while (shard.entries[shard.hand].referenced)
+        {
+            shard.entries[shard.hand].referenced = false;
+            shard.hand = (shard.hand + 1) % shard.entries.size();
+        }
+        slot = shard.hand;
+        shard.hand = (shard.hand + 1) % shard.entries.size();
+
+        const Entry &victim = shard.entries[slot];
+        shard.index.erase(Combine(victim.stateHash, victim.shotKey));
+        evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    shard.entries[slot] = {stateHash, shotKey, std::move(outcome), false};
+    shard.index[key] = slot;
+    inserts.fetch_add(1, std::memory_order_relaxed);
+}
+
+inline void ShotOutcomeCache::Clear()
+{
+    for (Shard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.index.clear();
+        shard.hand = 0;
+    }
+}
+
+inline ShotOutcomeCache::Stats ShotOutcomeCache::GetStats() const
+{
+    Stats stats;
+    stats.hits = hits.load(std::memory_order_relaxed);
+    stats.misses = misses.load(std::memory_order_relaxed);
+    stats.inserts = inserts.load(std::memory_order_relaxed);
+    stats.evictions = evictions.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <core/ColumnCodec.hpp>
+#include "Ball.hpp"
+#include "ShotCache.hpp"
+#include "Table.hpp"
+
+// Набор данных по симулированным ударам: признаки удара и его итог, по строке на удар.
+// Строки копятся блоками по kChunkRows и хранятся по столбцам (ColumnCodec), так что
+// похожие значения соседних ударов сжимаются.
+namespace ShotDataset
+{
+    constexpr uint32_t kMaxBalls = 16;
+    constexpr uint32_t kChunkRows = 4096;
+
+    enum Column : uint32_t
+    {
+        ShotAngle,   // ShotParams::angle, 1/100 градуса
+        ShotPower,   // 1/256
+        ShotOffsetX, // 1/256 радиуса
+        ShotOffsetY,
+        CueX,        // Положение битка до удара
+        CueZ,
+        BallsOnTable,
+        PocketedMask, // Забиты этим ударом
+        FirstContact,
+        Collisions,
+        TimeToRest, // с
+        FinalX,     // kMaxBalls столбцов; забитые шары — kPocketedPosition
+        FinalZ = FinalX + kMaxBalls,
+        ColumnCount = FinalZ + kMaxBalls,
+    };
+
+    ColumnCodec::Kind ColumnKind(uint32_t column);
+    std::string ColumnName(uint32_t column);
+
+    inline uint32_t FloatBits(float value)
+    {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    inline float BitsToFloat(uint32_t bits)
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t columnCount;
+        uint32_t chunkRows;
+    };
+
+    // Блок в файле: ChunkHeader, затем по столбцу — ColumnHeader и байты
+    struct ChunkHeader
+    {
+        uint32_t rows;
+    };
+
+    struct ColumnHeader
+    {
+        uint8_t encoding; // ColumnCodec::Encoding
+        uint8_t reserved[3];
+        uint32_t size;
+    };
+
+    constexpr uint32_t kVersion = 1;
+}
+
+// Запись набора данных. Append() можно звать из любого числа потоков симуляции: строка
+// кладётся в текущий блок, а сжатие и запись заполненных блоков идут в отдельном потоке.
+// Память ограничена числом блоков (queueChunks + 1); потоки симуляции ждут только если
+// диск отстал на всю очередь — такие ожидания считаются в Stalls(). Пока заполнивший блок
+// поток ждёт свободный, остальные ждут вместе с ним: строки не теряются.
+class ShotDatasetWriter
+{
+public:
+    ShotDatasetWriter() = default;
+    ~ShotDatasetWriter() { Close(); }
+
+    ShotDatasetWriter(const ShotDatasetWriter &) = delete;
+    ShotDatasetWriter &operator=(const ShotDatasetWriter &) = delete;
+
+    bool Open(const std::string &path, size_t queueChunks = 4);
+
+    void Append(const std::vector<Ball> &initial, const ShotParams &shot, const ShotOutcome &outcome);
+
+    // Дописывает неполный блок и дожидается записи; false — была ошибка ввода-вывода
+    bool Close();
+
+    uint64_t Rows() const;
+    uint64_t BytesWritten() const;
+    uint64_t Stalls() const;
+
+private:
+    struct Chunk
+    {
+        uint32_t rows = 0;
+        std::vector<uint32_t> values; // ColumnCount * kChunkRows, по столбцам
+    };
+
+    std::ofstream file;
+    std::thread thread;
+
+    mutable std::mutex mutex;
+    std::condition_variable chunkReady; // Блок для записи или остановка
+    std::condition_variable chunkFreed; // Свободный блок или новый текущий
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    Chunk *current = nullptr;
+    std::vector<Chunk *> freeChunks;
+    std::deque<Chunk *> pending;
+    bool stopping = false;
+    bool failed = false;
+
+    uint64_t rows = 0;
+    uint64_t bytesWritten = 0;
+    uint64_t stalls = 0;
+
+    void Run();
+    void WriteChunk(const Chunk &chunk, std::vector<uint8_t> &buffer);
+};
+
+// Последовательное чтение набора данных по блокам
+class ShotDatasetReader
+{
+public:
+    bool Open(const std::string &path);
+
+    // Следующий блок: values — ColumnCount * rows, по столбцам. false — конец файла или ошибка.
+    bool NextChunk(std::vector<uint32_t> &values, uint32_t &rows);
+
+private:
+    std::ifstream file;
+    uint32_t chunkRows = 0;
+    std::vector<uint8_t> buffer;
+};
+
+inline ColumnCodec::Kind ShotDataset::ColumnKind(uint32_t column)
+{
+    const bool isFloat = column == CueX || column == CueZ || column == TimeToRest || column >= FinalX;
+    return isFloat ? ColumnCodec::Kind::Float : ColumnCodec::Kind::Int;
+}
+
+inline std::string ShotDataset::ColumnName(uint32_t column)
+{
+    static const char *const names[] = {"shot_angle", "shot_power", "shot_offset_x", "shot_offset_y",
+                                        "cue_x", "cue_z", "balls_on_table", "pocketed_mask",
+                                        "first_contact", "collisions", "time_to_rest"};
+    if (column < FinalX)
+        return names[column];
+    if (column < FinalZ)
+        return "final_x_" + std::to_string(column - FinalX);
+    return "final_z_" + std::to_string(column - FinalZ);
+}
+
+inline bool ShotDatasetWriter::Open(const std::string &path, size_t queueChunks)
+{
+    Close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    // Имена столбцов не пишутся: схема фиксирована версией формата
+    const ShotDataset::FileHeader header = {{'B', 'S', 'D', 'S'}, ShotDataset::kVersion,
+                                            ShotDataset::ColumnCount, ShotDataset::kChunkRows};
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    if (!file)
+        return false;
+
+    chunks.clear();
+    freeChunks.clear();
+    pending.clear();
+    for (size_t i = 0; i < std::max<size_t>(queueChunks, 1) + 1; ++i)
+    {
+        chunks.push_back(std::make_unique<Chunk>());
+        chunks.back()->values.resize(static_cast<size_t>(ShotDataset::ColumnCount) * ShotDataset::kChunkRows);
+        freeChunks.push_back(chunks.back().get());
+    }
+    current = freeChunks.back();
+    freeChunks.pop_back();
+
+    stopping = false;
+    failed = false;
+    rows = 0;
+    stalls = 0;
+    bytesWritten = sizeof(header);
+    thread = std::thread(&ShotDatasetWriter::Run, this);
+    return true;
+}
+
+inline void ShotDatasetWriter::Append(const std::vector<Ball> &initial, const ShotParams &shot, const ShotOutcome &outcome)
+{
+    using namespace ShotDataset;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    // Текущего блока нет, пока другой поток ждёт свободный; без него — только после Close()
+    chunkFreed.wait(lock, [this]
+                    { return current != nullptr || stopping; });
+    if (!current)
+        return;
+
+    const uint32_t row = current->rows;
+    uint32_t *values = current->values.data();
+    auto set = [&](uint32_t column, uint32_t value)
+    { values[column * kChunkRows + row] = value; };
+
+    set(ShotAngle, static_cast<uint32_t>(shot.angle));
+    set(ShotPower, static_cast<uint32_t>(shot.power));
+    set(ShotOffsetX, static_cast<uint32_t>(shot.offsetX));
+    set(ShotOffsetY, static_cast<uint32_t>(shot.offsetY));
+    const glm::vec3 cue = initial.empty() ? kPocketedPosition : initial[0].getPosition();
+    set(CueX, FloatBits(cue.x));
+    set(CueZ, FloatBits(cue.z));
+    set(BallsOnTable, static_cast<uint32_t>(std::count_if(initial.begin(), initial.end(), [](const Ball &ball)
+                                                          { return !IsPocketed(ball); })));
+    set(PocketedMask, outcome.pocketedMask);
+    set(FirstContact, static_cast<uint32_t>(outcome.firstContact));
+    set(Collisions, outcome.collisions);
+    set(TimeToRest, FloatBits(outcome.duration));
+    for (uint32_t i = 0; i < kMaxBalls; ++i)
+    {
+        const glm::vec3 position = i < outcome.finalPositions.size() ? outcome.finalPositions[i] : kPocketedPosition;
+        set(FinalX + i, FloatBits(position.x));
+        set(FinalZ + i, FloatBits(position.z));
+    }
+    ++rows;
+
+    if (++current->rows < kChunkRows)
+        return;
+
+    // Блок заполнен — в очередь записи; следующий берётся из свободных
+    pending.push_back(current);
+    current = nullptr;
+    chunkReady.notify_one();
+    if (freeChunks.empty())
+    {
+        ++stalls;
+        chunkFreed.wait(lock, [this]
+                        { return !freeChunks.empty() || stopping; });
+        if (stopping)
+            return;
+    }
+    current = freeChunks.back();
+    freeChunks.pop_back();
+    chunkFreed.notify_all();
+}
+
+inline bool ShotDatasetWriter::Close()
+{
+    if (!thread.joinable())
+    {
+        file.close();
+        return !failed;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (current && current->rows > 0)
+            pending.push_back(current);
+        current = nullptr;
+        stopping = true;
+    }
+    chunkReady.notify_one();
+    chunkFreed.notify_all();
+    thread.join();
+
+    file.close();
+    chunks.clear();
+    freeChunks.clear();
+    return !failed;
+}
+
+inline uint64_t ShotDatasetWriter::Rows() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return rows;
+}
+
+inline uint64_t ShotDatasetWriter::BytesWritten() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return bytesWritten;
+}
+
+inline uint64_t ShotDatasetWriter::Stalls() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return stalls;
+}
+
+inline void ShotDatasetWriter::Run()
+{
+    std::vector<uint8_t> buffer;
+    for (;;)
+    {
+        Chunk *chunk = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            chunkReady.wait(lock, [this]
+                            { return stopping || !pending.empty(); });
+            if (pending.empty())
+                return;
+            chunk = pending.front();
+            pending.pop_front();
+        }
+
+        // Сжатие и запись — без блокировки, потоки симуляции тем временем заполняют другой блок
+        WriteChunk(*chunk, buffer);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            bytesWritten += buffer.size();
+            failed |= !file;
+            chunk->rows = 0;
+            freeChunks.push_back(chunk);
+        }
+        // Ждать может и поток с заполненным блоком, и стоящие за ним — будим всех
+        chunkFreed.notify_all();
+    }
+}
+
+inline void ShotDatasetWriter::WriteChunk(const Chunk &chunk, std::vector<uint8_t> &buffer)
+{
+    using namespace ShotDataset;
+
+    buffer.clear();
+    const ChunkHeader header = {chunk.rows};
+    buffer.resize(sizeof(header));
+    std::memcpy(buffer.data(), &header, sizeof(header));
+
+    for (uint32_t column = 0; column < ColumnCount; ++column)
+    {
+        const size_t headerOffset = buffer.size();
+        buffer.resize(headerOffset + sizeof(ColumnHeader));
+        ColumnHeader columnHeader = {};
+        columnHeader.encoding = static_cast<uint8_t>(ColumnCodec::Encode(ColumnKind(column), chunk.values.data() + column * kChunkRows,
+                                                                         chunk.rows, buffer));
+        columnHeader.size = static_cast<uint32_t>(buffer.size() - headerOffset - sizeof(ColumnHeader));
+        std::memcpy(buffer.data() + headerOffset, &columnHeader, sizeof(columnHeader));
+    }
+
+    file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+}
+
+inline bool ShotDatasetReader::Open(const std::string &path)
+{
+    file.close();
+    file.open(path, std::ios::binary);
+    ShotDataset::FileHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)) || std::memcmp(header.magic, "BSDS", 4) != 0 ||
+        header.version != ShotDataset::kVersion || header.columnCount != ShotDataset::ColumnCount)
+    {
+        file.close();
+        return false;
+    }
+    chunkRows = header.chunkRows;
+    return true;
+}
+
+inline bool ShotDatasetReader::NextChunk(std::vector<uint32_t> &values, uint32_t &rows)
+{
+    using namespace ShotDataset;
+
+    ChunkHeader header;
+    if (!file.is_open() || !file.read(reinterpret_cast<char *>(&header), sizeof(header)) || header.rows > chunkRows)
+        return false;
+
+    rows = header.rows;
+    values.resize(static_cast<size_t>(ColumnCount) * rows);
+    for (uint32_t column = 0; column < ColumnCount; ++column)
+    {
+        ColumnHeader columnHeader;
+        if (!file.read(reinterpret_cast<char *>(&columnHeader), sizeof(columnHeader)))
+            return false;
+        buffer.resize(columnHeader.size);
+        if (!file.read(reinterpret_cast<char *>(buffer.data()), columnHeader.size) ||
+            !ColumnCodec::Decode(ColumnKind(column), static_cast<ColumnCodec::Encoding>(columnHeader.encoding),
+                                 buffer.data(), buffer.size(), values.data() + column * rows, rows))
+        {
+            return false;
+        }
+    }
+    return true;
+}
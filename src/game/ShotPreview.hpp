@@ -0,0 +1,205 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "ShotSimulator.hpp"
+
+// Предпросмотр удара при прицеливании: полная симуляция текущего прицела в фоновом потоке.
+// Новый прицел (поворот кия, сила, точка удара) отменяет незаконченный прогон и запускает
+// следующий. Для отрисовки публикуется последний завершённый результат; поток интерфейса
+// его не ждёт — пока новый не готов, виден предыдущий.
+class ShotPreview
+{
+public:
+    struct Stats
+    {
+        uint64_t completed = 0; // Досчитаны до остановки шаров
+        uint64_t cancelled = 0; // Прерваны новым прицелом
+        uint64_t cached = 0;    // Взяты из кэша без симуляции
+    };
+
+    // Шаг силы для предпросмотра, 1/256: при зарядке сила растёт каждый кадр, и без округления
+    // каждый кадр был бы новым ключом кэша и новым прогоном, отменяющим предыдущий
+    static constexpr int32_t kPowerStep = 8;
+
+    // onPublished вызывается из фонового потока после публикации результата — будит поток
+    // интерфейса, который в простое ждёт событий и сам кадр не перерисует
+    ShotPreview(const ShotSimulator &simulator, ShotOutcomeCache &cache, std::function<void()> onPublished = nullptr)
+        : simulator(simulator), cache(cache), onPublished(std::move(onPublished))
+    {
+    }
+    ~ShotPreview() { Stop(); }
+
+    ShotPreview(const ShotPreview &) = delete;
+    ShotPreview &operator=(const ShotPreview &) = delete;
+
+    void Start();
+    void Stop();
+
+    // Из потока интерфейса при каждом кадре прицеливания; повтор того же прицела (с точностью
+    // до kPowerStep по силе) ничего не делает
+    void Request(const std::vector<Ball> &balls, const ShotParams &aim);
+
+    // Последний готовый результат для расстановки из последнего Request; nullptr — ещё не готов
+    std::shared_ptr<const ShotOutcome> Latest() const;
+
+    // Растёт с каждым опубликованным результатом: изменился — Latest стоит перерисовать
+    uint64_t Revision() const { return revision.load(std::memory_order_acquire); }
+
+    Stats GetStats() const;
+
+private:
+    struct Result
+    {
+        uint64_t stateHash = 0;
+        std::shared_ptr<const ShotOutcome> outcome;
+    };
+
+    const ShotSimulator &simulator;
+    ShotOutcomeCache &cache;
+    std::function<void()> onPublished;
+    std::thread worker;
+    std::atomic<bool> running{false};
+
+    // Заявка: под мьютексом только обмен данными, сама симуляция идёт без него
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool pending = false;
+    std::vector<Ball> requestBalls;
+    ShotParams requestShot;
+    uint64_t requestHash = 0;
+    std::atomic<bool> cancel{false};
+
+    // Только поток интерфейса
+    bool requested = false;
+    uint64_t lastHash = 0;
+    uint64_t lastKey = 0;
+
+    std::shared_ptr<const Result> published; // std::atomic_load / std::atomic_store
+    std::atomic<uint64_t> revision{0};
+
+    std::atomic<uint64_t> completed{0};
+    std::atomic<uint64_t> cancelled{0};
+    std::atomic<uint64_t> cached{0};
+
+    void Run();
+    void Publish(uint64_t stateHash, std::shared_ptr<const ShotOutcome> outcome);
+};
+
+inline void ShotPreview::Start()
+{
+    if (running.exchange(true))
+        return;
+    worker = std::thread(&ShotPreview::Run, this);
+}
+
+inline void ShotPreview::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!running.exchange(false))
+            return;
+        cancel.store(true, std::memory_order_relaxed);
+    }
+    wake.notify_one();
+    worker.join();
+}
+
+inline void ShotPreview::Request(const std::vector<Ball> &balls, const ShotParams &aim)
+{
+    ShotParams shot = aim;
+    shot.power = (aim.power + kPowerStep / 2) / kPowerStep * kPowerStep;
+
+    const uint64_t stateHash = TableStateHash(balls);
+    const uint64_t shotKey = shot.Key();
+    if (requested && stateHash == lastHash && shotKey == lastKey)
+        return;
+    requested = true;
+    lastHash = stateHash;
+    lastKey = shotKey;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requestBalls = balls;
+        requestShot = shot;
+        requestHash = stateHash;
+        pending = true;
+        // Идущий прогон считает устаревший прицел — прерываем
+        cancel.store(true, std::memory_order_relaxed);
+    }
+    wake.notify_one();
+}
+
+inline std::shared_ptr<const ShotOutcome> ShotPreview::Latest() const
+{
+    const std::shared_ptr<const Result> result = std::atomic_load(&published);
+    // Результат для другой расстановки (до удара) не показываем
+    if (!result || !requested || result->stateHash != lastHash)
+        return nullptr;
+    return result->outcome;
+}
+
+inline ShotPreview::Stats ShotPreview::GetStats() const
+{
+    Stats stats;
+    stats.completed = completed.load(std::memory_order_relaxed);
+    stats.cancelled = cancelled.load(std::memory_order_relaxed);
+    stats.cached = cached.load(std::memory_order_relaxed);
+    return stats;
+}
+
+inline void ShotPreview::Run()
+{
+    std::vector<Ball> balls;
+    for (;;)
+    {
+        ShotParams shot;
+        uint64_t stateHash = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return pending || !running.load(std::memory_order_relaxed); });
+            if (!running.load(std::memory_order_relaxed))
+                return;
+            balls.swap(requestBalls);
+            shot = requestShot;
+            stateHash = requestHash;
+            pending = false;
+            cancel.store(false, std::memory_order_relaxed);
+        }
+
+        const uint64_t shotKey = shot.Key();
+        if (auto outcome = cache.Find(stateHash, shotKey))
+        {
+            cached.fetch_add(1, std::memory_order_relaxed);
+            Publish(stateHash, std::move(outcome));
+            continue;
+        }
+
+        auto outcome = std::make_shared<ShotOutcome>();
+        if (!simulator.Simulate(balls, shot, *outcome, &cancel))
+        {
+            cancelled.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        completed.fetch_add(1, std::memory_order_relaxed);
+        cache.Insert(stateHash, shotKey, outcome);
+        Publish(stateHash, std::move(outcome));
+    }
+}
+
+inline void ShotPreview::Publish(uint64_t stateHash, std::shared_ptr<const ShotOutcome> outcome)
+{
+    auto result = std::make_shared<Result>();
+    result->stateHash = stateHash;
+    result->outcome = std::move(outcome);
+    std::atomic_store(&published, std::shared_ptr<const Result>(std::move(result)));
+    revision.fetch_add(1, std::memory_order_release);
+    if (onPublished)
+        onPublished();
+}
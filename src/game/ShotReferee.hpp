@@ -0,0 +1,180 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include "Physics.hpp"
+
+// Разбор ударов по событиям физики в отдельном потоке: первое касание, борта, забитые шары,
+// фолы (биток забит, биток никого не задел). Симуляция только пишет в очередь и не ждёт.
+// Удар начинается с первого события после покоя и заканчивается, когда остановились все
+// шары, задетые за удар. Итоги видны в оверлее (GetTotals); построчный разбор каждого удара
+// печатается только в подробном режиме.
+class ShotReferee
+{
+public:
+    struct Totals
+    {
+        uint64_t contacts = 0;
+        uint64_t cushions = 0;
+        uint64_t pocketed = 0;
+        uint64_t shots = 0;
+        uint64_t fouls = 0;
+    };
+
+    explicit ShotReferee(PhysicsEventRing &ring, bool verbose = false) : ring(ring), verbose(verbose) {}
+    ~ShotReferee() { Stop(); }
+
+    ShotReferee(const ShotReferee &) = delete;
+    ShotReferee &operator=(const ShotReferee &) = delete;
+
+    void Start();
+    void Stop();
+
+    Totals GetTotals() const;
+
+private:
+    struct Shot
+    {
+        bool active = false;
+        int firstHit = -1;
+        uint32_t contacts = 0;
+        uint32_t cushions = 0;
+        uint64_t moving = 0; // Шары, задетые за удар и ещё не остановившиеся
+        uint64_t pocketed = 0;
+        double start = 0.0;
+    };
+
+    PhysicsEventRing &ring;
+    const bool verbose;
+    std::thread worker;
+    std::atomic<bool> running{false};
+    Shot shot; // Только поток разбора
+
+    std::atomic<uint64_t> contacts{0};
+    std::atomic<uint64_t> cushions{0};
+    std::atomic<uint64_t> pocketed{0};
+    std::atomic<uint64_t> shots{0};
+    std::atomic<uint64_t> fouls{0};
+
+    void Run();
+    void Handle(const PhysicsEvent &event);
+    void Finish(double time);
+
+    static uint64_t Bit(uint16_t ball) { return ball < 64 ? 1ull << ball : 0; }
+};
+
+inline void ShotReferee::Start()
+{
+    if (running.exchange(true))
+        return;
+    worker = std::thread(&ShotReferee::Run, this);
+}
+
+inline void ShotReferee::Stop()
+{
+    if (!running.exchange(false))
+        return;
+    worker.join();
+}
+
+inline ShotReferee::Totals ShotReferee::GetTotals() const
+{
+    Totals totals;
+    totals.contacts = contacts.load(std::memory_order_relaxed);
+    totals.cushions = cushions.load(std::memory_order_relaxed);
+    totals.pocketed = pocketed.load(std::memory_order_relaxed);
+    totals.shots = shots.load(std::memory_order_relaxed);
+    totals.fouls = fouls.load(std::memory_order_relaxed);
+    return totals;
+}
+
+inline void ShotReferee::Run()
+{
+    while (running.load(std::memory_order_relaxed))
+    {
+        // Пустая очередь — короткий сон: событий десятки за удар, задержка разбора не важна
+        if (ring.Drain([this](const PhysicsEvent &event) { Handle(event); }) == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    ring.Drain([this](const PhysicsEvent &event) { Handle(event); });
+}
+
+inline void ShotReferee::Handle(const PhysicsEvent &event)
+{
+    if (!shot.active)
+    {
+        // Остановка прицельного шара после конца удара новый удар не начинает; остановка битка
+        // без единого события до неё — удар мимо всего
+        if (event.type == PhysicsEvent::Type::Rest && event.a != 0)
+            return;
+        shot = Shot();
+        shot.active = true;
+        shot.start = event.time;
+        shot.moving = Bit(0);
+    }
+
+    switch (event.type)
+    {
+    case PhysicsEvent::Type::BallContact:
+        contacts.fetch_add(1, std::memory_order_relaxed);
+        ++shot.contacts;
+        if (shot.firstHit < 0 && (event.a == 0 || event.b == 0))
+            shot.firstHit = event.a == 0 ? event.b : event.a;
+        shot.moving |= Bit(event.a) | Bit(event.b);
+        break;
+    case PhysicsEvent::Type::Cushion:
+        cushions.fetch_add(1, std::memory_order_relaxed);
+        ++shot.cushions;
+        shot.moving |= Bit(event.a);
+        break;
+    case PhysicsEvent::Type::Pocketed:
+        pocketed.fetch_add(1, std::memory_order_relaxed);
+        shot.pocketed |= Bit(event.a);
+        shot.moving &= ~Bit(event.a);
+        break;
+    case PhysicsEvent::Type::Rest:
+        shot.moving &= ~Bit(event.a);
+        break;
+    }
+
+    if (shot.moving == 0)
+        Finish(event.time);
+}
+
+inline void ShotReferee::Finish(double time)
+{
+    shot.active = false;
+    shots.fetch_add(1, std::memory_order_relaxed);
+
+    const bool scratch = (shot.pocketed & Bit(0)) != 0;
+    const bool noHit = shot.firstHit < 0;
+    if (scratch || noHit)
+        fouls.fetch_add(1, std::memory_order_relaxed);
+    if (!verbose)
+        return;
+
+    std::ostringstream line;
+    line << "[Shot] " << (time - shot.start) << " s, first hit ";
+    if (shot.firstHit >= 0)
+        line << shot.firstHit;
+    else
+        line << "none";
+    line << ", " << shot.contacts << " contacts, " << shot.cushions << " cushions";
+    if (shot.pocketed & ~Bit(0))
+    {
+        line << ", pocketed";
+        for (uint16_t ball = 1; ball < 64; ++ball)
+        {
+            if (shot.pocketed & Bit(ball))
+                line << ' ' << ball;
+        }
+    }
+    if (scratch || noHit)
+        line << ", foul: " << (scratch ? "cue ball pocketed" : "no ball hit");
+    line << '\n';
+    std::cout << line.str();
+}
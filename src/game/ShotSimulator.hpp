@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "Ball.hpp"
+#include "Cue.hpp"
+#include "Physics.hpp"
+#include "ShotCache.hpp"
+#include "Table.hpp"
+
+// Прогон удара на копии расстановки до остановки шаров (для подсказок и планировщиков).
+// Шаг и трение те же, что в игровом цикле.
+class ShotSimulator
+{
+public:
+    static constexpr float kTickSeconds = 1.0f / 240.0f;
+    static constexpr float kMaxDuration = 20.0f;
+
+    ShotSimulator(const TableGeometry &table, float friction, float maxForce);
+
+    ShotOutcome Simulate(const std::vector<Ball> &balls, const ShotParams &shot) const;
+
+    // То же с отменой: cancel проверяется каждые kCancelCheckTicks тиков; false — прогон
+    // прерван, outcome неполон
+    bool Simulate(const std::vector<Ball> &balls, const ShotParams &shot, ShotOutcome &outcome,
+                  const std::atomic<bool> *cancel) const;
+
+    // Тот же удар, что Cue::release + точка касания Cue::getHitPoint
+    static void ApplyShot(Ball &cueBall, const ShotParams &shot, float maxForce);
+
+    // Результат из кэша или, при промахе, симуляция с сохранением в кэш
+    std::shared_ptr<const ShotOutcome> Query(ShotOutcomeCache &cache, const std::vector<Ball> &balls,
+                                             const ShotParams &shot) const;
+
+private:
+    static constexpr int kCancelCheckTicks = 16;
+    static constexpr float kTurnCosine = 0.9986f; // Поворот скорости на 3° — новая точка траектории
+
+    TableGeometry table;
+    float friction;
+    float maxForce;
+
+    // Точка траектории шара: по расписанию или сразу после поворота (шар, борт)
+    static void TracePath(std::vector<glm::vec3> &path, glm::vec3 &heading, const Ball &ball, bool scheduled);
+};
+
+inline ShotSimulator::ShotSimulator(const TableGeometry &table, float friction, float maxForce)
+    : table(table), friction(friction), maxForce(maxForce)
+{
+}
+
+inline void ShotSimulator::ApplyShot(Ball &cueBall, const ShotParams &shot, float maxForce)
+{
+    const glm::vec3 direction = shot.Direction();
+    const glm::vec3 impulse = direction * (shot.Power() * maxForce);
+    const glm::vec3 up(0.0f, 1.0f, 0.0f);
+    const glm::vec3 right = glm::normalize(glm::cross(direction, up));
+    const glm::vec2 offset = shot.Offset();
+    const glm::vec3 hitPoint = cueBall.getPosition() + (offset.x * right + offset.y * up) * cueBall.getRadius();
+    cueBall.applyImpulse(impulse);
+    cueBall.applyAngularImpulse(hitPoint, impulse);
+}
+
+inline ShotOutcome ShotSimulator::Simulate(const std::vector<Ball> &initial, const ShotParams &shot) const
+{
+    ShotOutcome outcome;
+    Simulate(initial, shot, outcome, nullptr);
+    return outcome;
+}
+
+inline bool ShotSimulator::Simulate(const std::vector<Ball> &initial, const ShotParams &shot, ShotOutcome &outcome,
+                                    const std::atomic<bool> *cancel) const
+{
+    std::vector<Ball> balls = initial;
+    Physics physics(table.width, table.height, friction);
+    outcome = ShotOutcome();
+
+    if (!balls.empty() && !IsPocketed(balls[0]))
+        ApplyShot(balls[0], shot, maxForce);
+
+    // Траектории прореживаются так, чтобы уложиться в kMaxPathPoints; повороты сохраняются
+    const int maxTicks = static_cast<int>(kMaxDuration / kTickSeconds);
+    const int pathStride = maxTicks / static_cast<int>(ShotOutcome::kMaxPathPoints) + 1;
+    glm::vec3 cueHeading(0.0f), objectHeading(0.0f);
+    if (!balls.empty())
+        outcome.cuePath.push_back(balls[0].getPosition());
+
+    int tick = 0;
+    for (; tick < maxTicks; ++tick)
+    {
+        if (cancel && tick % kCancelCheckTicks == 0 && cancel->load(std::memory_order_relaxed))
+            return false;
+
+        physics.Update(balls, kTickSeconds);
+        outcome.collisions += static_cast<uint32_t>(physics.GetSolverStats().impacts);
+
+        // Точки траекторий — пока забитые шары ещё у лузы, а не убраны со стола
+        const bool scheduled = tick % pathStride == 0;
+        const int object = outcome.firstContact;
+        glm::vec3 cueBefore(0.0f), objectBefore(0.0f);
+        if (!balls.empty())
+        {
+            TracePath(outcome.cuePath, cueHeading, balls[0], scheduled);
+            cueBefore = balls[0].getPosition();
+        }
+        if (object > 0)
+        {
+            TracePath(outcome.objectPath, objectHeading, balls[object], scheduled);
+            objectBefore = balls[object].getPosition();
+        }
+
+        const uint32_t pocketed = CollectPocketed(balls, table);
+        outcome.pocketedMask |= pocketed;
+        if (pocketed & 1u)
+            outcome.cuePath.push_back(cueBefore);
+        if (object > 0 && object < 32 && (pocketed & (1u << object)))
+            outcome.objectPath.push_back(objectBefore);
+
+        bool moving = false;
+        for (size_t i = 0; i < balls.size(); ++i)
+        {
+            if (!balls[i].isMoving())
+                continue;
+            moving = true;
+            if (i > 0 && outcome.firstContact < 0)
+            {
+                outcome.firstContact = static_cast<int>(i);
+                outcome.objectPath.push_back(balls[i].getPosition());
+            }
+        }
+
+        if (!moving)
+            break;
+    }
+
+    if (!balls.empty() && !IsPocketed(balls[0]))
+        outcome.cuePath.push_back(balls[0].getPosition());
+    if (outcome.firstContact > 0 && !IsPocketed(balls[outcome.firstContact]))
+        outcome.objectPath.push_back(balls[outcome.firstContact].getPosition());
+
+    outcome.duration = tick * kTickSeconds;
+    outcome.finalPositions.reserve(balls.size());
+    for (const Ball &ball : balls)
+        outcome.finalPositions.push_back(ball.getPosition());
+    return true;
+}
+
+inline void ShotSimulator::TracePath(std::vector<glm::vec3> &path, glm::vec3 &heading, const Ball &ball, bool scheduled)
+{
+    // Последнее место — под конечную точку
+    if (IsPocketed(ball) || path.size() + 1 >= ShotOutcome::kMaxPathPoints)
+        return;
+
+    const glm::vec3 &velocity = ball.getVelocity();
+    const float speed = glm::length(velocity);
+    if (speed < 1e-4f)
+        return;
+
+    const glm::vec3 direction = velocity / speed;
+    if (!scheduled && glm::dot(direction, heading) > kTurnCosine)
+        return;
+    heading = direction;
+    path.push_back(ball.getPosition());
+}
+
+inline std::shared_ptr<const ShotOutcome> ShotSimulator::Query(ShotOutcomeCache &cache, const std::vector<Ball> &balls,
+                                                              const ShotParams &shot) const
+{
+    const uint64_t stateHash = TableStateHash(balls);
+    const uint64_t shotKey = shot.Key();
+    if (auto cached = cache.Find(stateHash, shotKey))
+        return cached;
+
+    auto outcome = std::make_shared<const ShotOutcome>(Simulate(balls, shot));
+    cache.Insert(stateHash, shotKey, outcome);
+    return outcome;
+}
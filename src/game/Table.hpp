@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+#include "Ball.hpp"
+
+// Геометрия игрового поля: размеры и лунки. Общая для сцены, физики и симуляции ударов.
+struct TableGeometry
+{
+    float width = 2.0f;
+    float height = 1.0f;
+    float pocketRadius = 0.08f;
+
+    std::vector<glm::vec3> pockets = {
+        glm::vec3(-0.95f, 0.01f, -0.45f), // левый нижний угол
+        glm::vec3(-0.95f, 0.01f, 0.45f),  // левый верхний угол
+        glm::vec3(0.95f, 0.01f, -0.45f),  // правый нижний угол
+        glm::vec3(0.95f, 0.01f, 0.45f),   // правый верхний угол
+        glm::vec3(0.0f, 0.01f, -0.45f),   // середина нижней стороны
+        glm::vec3(0.0f, 0.01f, 0.45f)     // середина верхней стороны
+    };
+};
+
+// Стандартная расстановка: биток слева, 15 шаров треугольником справа от центра
+inline std::vector<Ball> RackBalls(float ballRadius, float ballMass)
+{
+    std::vector<Ball> balls;
+
+    // Черный шар - кий-бол
+    balls.emplace_back(glm::vec3(-0.8f, ballRadius, 0.0f), ballRadius, ballMass);
+
+    // Треугольная расстановка белых шаров
+    int rows = 5;
+    float spacing = ballRadius * 2.05f;         // чуть больше диаметра, чтобы не перекрывались
+    glm::vec3 startPos(0.3f, ballRadius, 0.0f); // ближе к центру стола, справа
+
+    for (int row = 0; row < rows; ++row)
+    {
+        for (int col = 0; col <= row; ++col)
+        {
+            float x = startPos.x + row * spacing * 0.866f; // cos(30°)
+            float z = startPos.z - row * spacing * 0.5f + col * spacing;
+            balls.emplace_back(glm::vec3(x, ballRadius, z), ballRadius, ballMass);
+        }
+    }
+    return balls;
+}
+
+// Куда переносится забитый шар
+const glm::vec3 kPocketedPosition(-100.0f, -100.0f, -100.0f);
+
+inline bool IsPocketed(const Ball &ball)
+{
+    return ball.getPosition().y < -50.0f;
+}
+
+// Убирает с поля шары, попавшие в лунки; возвращает маску забитых на этом шаге.
+// onPocketed(шар, луза) вызывается до переноса шара — с его последними положением и скоростью
+template <typename OnPocketed>
+inline uint32_t CollectPocketed(std::vector<Ball> &balls, const std::vector<glm::vec3> &pockets, float pocketRadius,
+                                OnPocketed &&onPocketed)
+{
+    uint32_t mask = 0;
+    for (size_t i = 0; i < balls.size(); ++i)
+    {
+        Ball &ball = balls[i];
+        if (IsPocketed(ball))
+            continue;
+
+        for (size_t p = 0; p < pockets.size(); ++p)
+        {
+            if (glm::distance(ball.getPosition(), pockets[p]) < pocketRadius)
+            {
+                onPocketed(i, p);
+                ball.setPosition(kPocketedPosition);
+                ball.setVelocity(glm::vec3(0.0f));
+                if (i < 32)
+                    mask |= 1u << i;
+                break;
+            }
+        }
+    }
+    return mask;
+}
+
+inline uint32_t CollectPocketed(std::vector<Ball> &balls, const TableGeometry &table)
+{
+    return CollectPocketed(balls, table.pockets, table.pocketRadius, [](size_t, size_t) {});
+}
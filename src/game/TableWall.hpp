@@ -0,0 +1,474 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <core/Tracer.hpp>
+#include <render/GLState.hpp>
+#include <render/MeshRegistry.hpp>
+#include <render/RenderStats.hpp>
+#include <render/ShaderLibrary.hpp>
+#include <render/TextureCache.hpp>
+#include "Ball.hpp"
+#include "Table.hpp"
+
+// Стена из многих столов для трансляции: вид сверху на каждый стол в своей плитке.
+// Плитки живут в атласе (FBO размером с экран) и перерисовываются, только когда на их
+// столе что-то сдвинулось; остальные берутся из атласа как есть. Все изменившиеся столы
+// рисуются за один проход: по одному инстансному вызову на вид меша (сукно, борта, лунки,
+// шары), а преобразование стола в его плитку входит в матрицу каждого экземпляра.
+class TableWall
+{
+public:
+    static constexpr int kMaxTables = 64;
+
+    TableWall() = default;
+    ~TableWall() { Cleanup(); }
+
+    TableWall(const TableWall &) = delete;
+    TableWall &operator=(const TableWall &) = delete;
+
+    bool Init(const MeshRegistry &meshes, const ShaderLibrary &shaders, const TableGeometry &table, int tableCount);
+    void Cleanup();
+
+    // Новое состояние стола; плитка помечается к перерисовке, только если шары сдвинулись
+    void UpdateTable(int index, const std::vector<Ball> &balls);
+
+    // Перерисовывает изменившиеся плитки и выводит атлас в текущий буфер кадра
+    void Render(int screenWidth, int screenHeight);
+
+    int TableCount() const { return static_cast<int>(tables.size()); }
+    int TilesDrawn() const { return tilesDrawn; }
+    int DrawCalls() const { return drawCalls; }
+
+private:
+    // Экземпляр: аффинная матрица меш → NDC атласа (три строки) и цвет;
+    // у шаров с текстурой color.a — слой массива текстур
+    struct Instance
+    {
+        glm::vec4 rows[3];
+        glm::vec4 color;
+    };
+
+    enum Group
+    {
+        GroupFelt,
+        GroupRails,
+        GroupPockets,
+        GroupBalls,
+        GroupCount
+    };
+
+    struct TableState
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::quat> rotations;
+        glm::mat4 tileTransform{1.0f}; // Стол (вид сверху) → его плитка в NDC атласа
+        bool dirty = true;
+    };
+
+    const MeshRegistry *meshes = nullptr;
+    const ShaderLibrary *shaders = nullptr;
+    TableGeometry geometry;
+    float railThickness = 0.05f;
+    float ballRadius = 0.05f;
+
+    GLuint vao = 0;
+    GLuint instanceBuffer = 0;
+    GLsizeiptr instanceCapacity = 0;
+    GLuint ballTextures = 0; // GL_TEXTURE_2D_ARRAY, слой — номер шара
+    int ballLayers = 0;
+
+    GLuint fbo = 0;
+    GLuint colorTexture = 0;
+    GLuint depthBuffer = 0;
+    int atlasWidth = 0;
+    int atlasHeight = 0;
+    int columns = 1;
+    int rowCount = 1;
+
+    std::vector<TableState> tables;
+    std::vector<Instance> groups[GroupCount];
+    int tilesDrawn = 0;
+    int drawCalls = 0;
+
+    bool LoadBallTextures();
+    void ResizeAtlas(int width, int height);
+    void AppendTable(const TableState &table);
+    void DrawGroup(Group group, MeshId mesh, GLintptr offset);
+
+    static void AddInstance(std::vector<Instance> &out, const glm::mat4 &model, const glm::vec4 &color);
+};
+
+inline bool TableWall::Init(const MeshRegistry &registry, const ShaderLibrary &library, const TableGeometry &table,
+                            int tableCount)
+{
+    meshes = &registry;
+    shaders = &library;
+    geometry = table;
+    tables.assign(std::clamp(tableCount, 1, kMaxTables), TableState());
+
+    // Свой VAO: вершины общих мешей плюс атрибуты экземпляров
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &instanceBuffer);
+    GLState::BindVertexArray(vao);
+    registry.BindAttributes();
+    GLState::BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+    for (GLuint attribute = 3; attribute <= 6; ++attribute)
+    {
+        glEnableVertexAttribArray(attribute);
+        glVertexAttribDivisor(attribute, 1);
+    }
+
+    if (!LoadBallTextures())
+        std::cerr << "[Wall] Ball textures unavailable, using plain colors" << std::endl;
+    return true;
+}
+
+inline void TableWall::Cleanup()
+{
+    if (vao)
+    {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &instanceBuffer);
+    }
+    if (ballTextures)
+        glDeleteTextures(1, &ballTextures);
+    if (fbo)
+        glDeleteFramebuffers(1, &fbo);
+    if (colorTexture)
+        glDeleteTextures(1, &colorTexture);
+    if (depthBuffer)
+        glDeleteRenderbuffers(1, &depthBuffer);
+    vao = instanceBuffer = ballTextures = fbo = colorTexture = depthBuffer = 0;
+    GLState::Invalidate();
+    instanceCapacity = 0;
+    atlasWidth = atlasHeight = 0;
+}
+
+inline bool TableWall::LoadBallTextures()
+{
+    std::vector<std::string> paths;
+    for (int i = 0; i <= 15; ++i)
+    {
+        paths.push_back("textures/Ball" + std::to_string(i) + ".jpg");
+    }
+
+    TextureCache cache("cache/textures.bin");
+    std::vector<TextureImage> images;
+    if (!cache.Load(paths, images) || images.empty())
+        return false;
+
+    // Все слои массива одного размера — как у первой текстуры
+    const TextureImage &first = images[0];
+    glGenTextures(1, &ballTextures);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D_ARRAY, ballTextures);
+    for (uint32_t level = 0; level < first.levels; ++level)
+    {
+        glTexImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), GL_RGBA8,
+                     first.LevelWidth(level), first.LevelHeight(level), static_cast<GLsizei>(images.size()),
+                     0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    }
+    std::vector<uint8_t> fill;
+    for (size_t layer = 0; layer < images.size(); ++layer)
+    {
+        const TextureImage &image = images[layer];
+        if (image.width != first.width || image.height != first.height || image.levels != first.levels)
+        {
+            // Слой другого размера в массив не ложится; вместо неинициализированной памяти —
+            // средний цвет текстуры (её последний mip-уровень), без него — серый
+            std::cerr << "[Wall] " << paths[layer] << " is " << image.width << "x" << image.height << ", expected "
+                      << first.width << "x" << first.height << "; using a solid colour" << std::endl;
+            uint8_t colour[4] = {128, 128, 128, 255};
+            if (image.levels > 0)
+                std::memcpy(colour, image.Level(image.levels - 1), sizeof(colour));
+            fill.resize(static_cast<size_t>(first.width) * first.height * 4);
+            for (size_t i = 0; i < fill.size(); i += 4)
+                std::memcpy(&fill[i], colour, sizeof(colour));
+            for (uint32_t level = 0; level < first.levels; ++level)
+            {
+                glTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, static_cast<GLint>(layer),
+                                first.LevelWidth(level), first.LevelHeight(level), 1,
+                                GL_RGBA, GL_UNSIGNED_BYTE, fill.data());
+            }
+            continue;
+        }
+        for (uint32_t level = 0; level < image.levels; ++level)
+        {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, static_cast<GLint>(level), 0, 0, static_cast<GLint>(layer),
+                            image.LevelWidth(level), image.LevelHeight(level), 1,
+                            GL_RGBA, GL_UNSIGNED_BYTE, image.Level(level));
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(first.levels) - 1);
+
+    ballLayers = static_cast<int>(images.size());
+    return true;
+}
+
+inline void TableWall::UpdateTable(int index, const std::vector<Ball> &balls)
+{
+    if (index < 0 || index >= TableCount())
+        return;
+
+    TableState &table = tables[index];
+    bool changed = table.positions.size() != balls.size();
+    table.positions.resize(balls.size());
+    table.rotations.resize(balls.size());
+    for (size_t i = 0; i < balls.size(); ++i)
+    {
+        if (changed || table.positions[i] != balls[i].getPosition() || table.rotations[i] != balls[i].getRotation())
+        {
+            table.positions[i] = balls[i].getPosition();
+            table.rotations[i] = balls[i].getRotation();
+            changed = true;
+        }
+    }
+    if (!balls.empty())
+        ballRadius = balls[0].getRadius();
+    table.dirty |= changed;
+}
+
+inline void TableWall::ResizeAtlas(int width, int height)
+{
+    if (fbo)
+    {
+        glDeleteFramebuffers(1, &fbo);
+        glDeleteTextures(1, &colorTexture);
+        glDeleteRenderbuffers(1, &depthBuffer);
+        GLState::Invalidate();
+    }
+    atlasWidth = width;
+    atlasHeight = height;
+
+    glGenTextures(1, &colorTexture);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D, colorTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, colorTexture, 0);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "[Wall] Atlas framebuffer is incomplete" << std::endl;
+    GLState::ClearColor(0.05f, 0.05f, 0.05f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+    // Сетка плиток ближе всего к пропорциям стола с бортами
+    const float tableAspect = (geometry.width + 2.0f * railThickness) / (geometry.height + 2.0f * railThickness);
+    const int count = TableCount();
+    float bestScale = 0.0f;
+    for (int cols = 1; cols <= count; ++cols)
+    {
+        const int rows = (count + cols - 1) / cols;
+        const float tileWidth = static_cast<float>(width) / cols;
+        const float tileHeight = static_cast<float>(height) / rows;
+        const float scale = std::min(tileWidth / tableAspect, tileHeight);
+        if (scale > bestScale)
+        {
+            bestScale = scale;
+            columns = cols;
+            rowCount = rows;
+        }
+    }
+
+    // Вид сверху: x стола — вправо, z — вниз по экрану, высота — в глубину
+    const glm::vec2 extent(geometry.width * 0.5f + railThickness, geometry.height * 0.5f + railThickness);
+    const glm::vec2 tileSize(2.0f / columns, 2.0f / rowCount); // В NDC
+    const float pixelsPerUnit = std::min(static_cast<float>(width) / columns / (2.0f * extent.x),
+                                         static_cast<float>(height) / rowCount / (2.0f * extent.y)) * 0.95f;
+    const glm::vec2 scale(pixelsPerUnit * 2.0f / width, pixelsPerUnit * 2.0f / height);
+    glm::mat4 topDown(0.0f);
+    topDown[0] = glm::vec4(1.0f, 0.0f, 0.0f, 0.0f);
+    topDown[1] = glm::vec4(0.0f, 0.0f, -0.5f, 0.0f);
+    topDown[2] = glm::vec4(0.0f, -1.0f, 0.0f, 0.0f);
+    topDown[3] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    for (int i = 0; i < count; ++i)
+    {
+        const glm::vec2 center(-1.0f + tileSize.x * (i % columns + 0.5f), 1.0f - tileSize.y * (i / columns + 0.5f));
+        tables[i].tileTransform = glm::translate(glm::mat4(1.0f), glm::vec3(center, 0.0f)) *
+                                  glm::scale(glm::mat4(1.0f), glm::vec3(scale, 1.0f)) * topDown;
+        tables[i].dirty = true;
+    }
+}
+
+inline void TableWall::AddInstance(std::vector<Instance> &out, const glm::mat4 &model, const glm::vec4 &color)
+{
+    Instance instance;
+    for (int row = 0; row < 3; ++row)
+        instance.rows[row] = glm::vec4(model[0][row], model[1][row], model[2][row], model[3][row]);
+    instance.color = color;
+    out.push_back(instance);
+}
+
+inline void TableWall::AppendTable(const TableState &table)
+{
+    const glm::mat4 &tile = table.tileTransform;
+    const float w = geometry.width, h = geometry.height, t = railThickness;
+
+    // Сукно
+    AddInstance(groups[GroupFelt], tile * glm::scale(glm::mat4(1.0f), glm::vec3(w, 1.0f, h)),
+                glm::vec4(0.0f, 0.3f, 0.0f, 1.0f));
+
+    // Борта
+    const glm::vec4 railColor(0.3f, 0.15f, 0.05f, 1.0f);
+    const glm::vec3 rails[4][2] = {
+        {{0.0f, 0.05f, h * 0.5f + t * 0.5f}, {w + 2.0f * t, 0.1f, t}},
+        {{0.0f, 0.05f, -(h * 0.5f + t * 0.5f)}, {w + 2.0f * t, 0.1f, t}},
+        {{w * 0.5f + t * 0.5f, 0.05f, 0.0f}, {t, 0.1f, h}},
+        {{-(w * 0.5f + t * 0.5f), 0.05f, 0.0f}, {t, 0.1f, h}},
+    };
+    for (const auto &rail : rails)
+    {
+        AddInstance(groups[GroupRails],
+                    tile * glm::scale(glm::translate(glm::mat4(1.0f), rail[0]), rail[1]), railColor);
+    }
+
+    // Лунки чуть выше сукна
+    for (const glm::vec3 &pocket : geometry.pockets)
+    {
+        const glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(pocket.x, 0.002f, pocket.z));
+        AddInstance(groups[GroupPockets],
+                    tile * glm::scale(model, glm::vec3(geometry.pocketRadius, 1.0f, geometry.pocketRadius)),
+                    glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+    }
+
+    // Шары; забитые лежат под столом и не рисуются
+    for (size_t i = 0; i < table.positions.size(); ++i)
+    {
+        if (table.positions[i].y < -50.0f)
+            continue;
+        glm::mat4 model = glm::translate(glm::mat4(1.0f), table.positions[i]) * glm::toMat4(table.rotations[i]);
+        model = glm::scale(model, glm::vec3(ballRadius));
+        // Без текстур шары рисуются заливкой — тогда в color.a ничего не читается
+        const float layer = static_cast<float>(std::min<int>(static_cast<int>(i), std::max(ballLayers - 1, 0)));
+        const glm::vec3 color = i == 0 ? glm::vec3(0.95f) : glm::vec3(0.7f);
+        AddInstance(groups[GroupBalls], tile * model, glm::vec4(color, layer));
+    }
+}
+
+inline void TableWall::DrawGroup(Group group, MeshId mesh, GLintptr offset)
+{
+    const std::vector<Instance> &instances = groups[group];
+    if (instances.empty())
+        return;
+
+    // Атрибуты экземпляров указывают на участок группы в общем буфере
+    for (GLuint row = 0; row < 3; ++row)
+    {
+        glVertexAttribPointer(3 + row, 4, GL_FLOAT, GL_FALSE, sizeof(Instance),
+                              (void *)(offset + offsetof(Instance, rows) + row * sizeof(glm::vec4)));
+    }
+    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Instance), (void *)(offset + offsetof(Instance, color)));
+
+    const MeshRange &range = meshes->Get(mesh);
+    glDrawElementsInstancedBaseVertex(GL_TRIANGLES, range.indexCount, meshes->IndexType(),
+                                      meshes->IndexOffset(range.firstIndex),
+                                      static_cast<GLsizei>(instances.size()), range.baseVertex);
+    ++drawCalls;
+    ++RenderStats::Current().drawCalls;
+}
+
+inline void TableWall::Render(int screenWidth, int screenHeight)
+{
+    TRACE_SCOPE("TableWall::Render");
+    if (screenWidth <= 0 || screenHeight <= 0)
+        return;
+    if (screenWidth != atlasWidth || screenHeight != atlasHeight)
+        ResizeAtlas(screenWidth, screenHeight);
+
+    tilesDrawn = 0;
+    drawCalls = 0;
+    for (auto &group : groups)
+        group.clear();
+
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, fbo);
+    GLState::Viewport(0, 0, atlasWidth, atlasHeight);
+
+    // Очищаем только плитки, которые будут перерисованы
+    GLState::Enable(GL_SCISSOR_TEST);
+    GLState::ClearColor(0.05f, 0.05f, 0.05f, 1.0f);
+    const int tileWidth = atlasWidth / columns;
+    const int tileHeight = atlasHeight / rowCount;
+    for (int i = 0; i < TableCount(); ++i)
+    {
+        TableState &table = tables[i];
+        if (!table.dirty)
+            continue;
+        const int x = (i % columns) * tileWidth;
+        const int y = atlasHeight - (i / columns + 1) * tileHeight;
+        glScissor(x, y, tileWidth, tileHeight);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        AppendTable(table);
+        table.dirty = false;
+        ++tilesDrawn;
+    }
+    GLState::Disable(GL_SCISSOR_TEST);
+
+    if (tilesDrawn > 0)
+    {
+        // Все группы одним буфером; он переразмечается каждый кадр
+        GLintptr offsets[GroupCount];
+        GLsizeiptr total = 0;
+        for (int group = 0; group < GroupCount; ++group)
+        {
+            offsets[group] = total;
+            total += static_cast<GLsizeiptr>(groups[group].size() * sizeof(Instance));
+        }
+
+        GLState::BindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        instanceCapacity = std::max(instanceCapacity, total);
+        glBufferData(GL_ARRAY_BUFFER, instanceCapacity, nullptr, GL_STREAM_DRAW);
+        for (int group = 0; group < GroupCount; ++group)
+        {
+            if (!groups[group].empty())
+                glBufferSubData(GL_ARRAY_BUFFER, offsets[group], groups[group].size() * sizeof(Instance), groups[group].data());
+        }
+        ++RenderStats::Current().bufferUploads;
+
+        // LOD шаров по их размеру в плитке
+        const float ballPixels = ballRadius * tables[0].tileTransform[0][0] * 0.5f * atlasWidth;
+        const MeshId ballMesh = MeshRegistry::SphereLod(ballPixels);
+
+        GLState::BindVertexArray(vao);
+        shaders->Get(ShaderVariant::InstancedFlat).Use();
+        DrawGroup(GroupFelt, MeshId::Quad, offsets[GroupFelt]);
+        DrawGroup(GroupRails, MeshId::Box, offsets[GroupRails]);
+        DrawGroup(GroupPockets, MeshId::Disc, offsets[GroupPockets]);
+
+        if (ballLayers > 0)
+        {
+            const Shader &textured = shaders->Get(ShaderVariant::InstancedTextured);
+            textured.Use();
+            textured.SetInt("uTexture", 0);
+            GLState::ActiveTexture(GL_TEXTURE0);
+            GLState::BindTexture(GL_TEXTURE_2D_ARRAY, ballTextures);
+        }
+        DrawGroup(GroupBalls, ballMesh, offsets[GroupBalls]);
+    }
+
+    // Атлас совпадает с экраном по размеру — вывод одним копированием
+    GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, atlasWidth, atlasHeight, 0, 0, screenWidth, screenHeight,
+                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+}
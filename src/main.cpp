@@ -1,18 +1,467 @@
 #include <core/Window.hpp>
 #include <core/Camera.hpp>
+#include <core/Profiler.hpp>
+#include <core/FrameScheduler.hpp>
+#include <core/Tracer.hpp>
+#include <core/FrameArena.hpp>
+#include <core/AllocationTracker.hpp>
 #include <render/Shader.hpp>
 #include <render/Renderer.hpp>
 #include <game/Physics.hpp>
 #include <game/Ball.hpp>
 #include <game/Cue.hpp>
 #include <game/Scene.hpp>
+#include <game/Replay.hpp>
+#include <game/Table.hpp>
+#include <game/ShotSimulator.hpp>
+#include <game/ShotPreview.hpp>
+#include <game/TableWall.hpp>
+#include <game/PocketField.hpp>
+#include <game/ShotReferee.hpp>
+#include <render/FrameExporter.hpp>
+#include <render/FramePacer.hpp>
 #include <iostream>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <random>
+
+// Параметры командной строки
+//   --record <file>                 записать партию в файл повтора
+//   --export <replay> <output>      отрендерить повтор без окна в сырые RGBA-кадры;
+//                                   output вида "|команда" отдаёт кадры в stdin команды
+//   --size <W>x<H>, --fps <N>       параметры экспорта
+//   --wall <N>                      стена из N столов (до 64) в режиме автоигры, вид сверху
+//   --latency <N>                   режим низкой задержки: не больше N кадров в полёте (1-3)
+//   --fps-limit <N>                 ограничение частоты кадров (работает и без vsync)
+//   --vsync on|off                  синхронизация с экраном (по умолчанию — как в драйвере)
+//   --stats                         оверлей статистики с первого кадра (переключается F3)
+//   --profile-csv <file>            раз в секунду писать статистику кадров в CSV
+//   --shot-log                      печатать разбор каждого удара (первое касание, фолы)
+//   --trace-spikes                  писать трассу кадров и сохранять её при всплесках времени
+//                                   кадра (trace_spike_N.json); без флага трасса включается F4
+struct LaunchOptions
+{
+    bool recording = false;
+    bool exporting = false;
+    std::string recordPath;
+    std::string replayPath;
+    std::string exportOutput;
+    int exportWidth = 1280;
+    int exportHeight = 720;
+    float exportFps = 60.0f;
+    int wallTables = 0;
+    FramePacer::Options pacing;
+    int swapInterval = -1; // -1 — не менять
+    bool showStats = false;
+    std::string profileCsvPath; // Пусто — CSV не пишется
+    bool traceSpikes = false;
+    bool shotLog = false;
+};
+
+static bool ParseOptions(int argc, char **argv, LaunchOptions &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+        {
+            options.recording = true;
+            options.recordPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--export") == 0 && i + 2 < argc)
+        {
+            options.exporting = true;
+            options.replayPath = argv[++i];
+            options.exportOutput = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.exportWidth, &options.exportHeight) != 2 ||
+                options.exportWidth <= 0 || options.exportHeight <= 0)
+            {
+                return false;
+            }
+        }
+        else if (std::strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+        {
+            options.exportFps = static_cast<float>(std::atof(argv[++i]));
+            if (options.exportFps <= 0.0f)
+                return false;
+        }
+        else if (std::strcmp(argv[i], "--wall") == 0 && i + 1 < argc)
+        {
+            options.wallTables = std::atoi(argv[++i]);
+            if (options.wallTables <= 0 || options.wallTables > TableWall::kMaxTables)
+                return false;
+        }
+        else if (std::strcmp(argv[i], "--latency") == 0 && i + 1 < argc)
+        {
+            options.pacing.framesInFlight = std::atoi(argv[++i]);
+            if (options.pacing.framesInFlight <= 0 || options.pacing.framesInFlight >= FramePacer::kMaxFramesInFlight)
+                return false;
+        }
+        else if (std::strcmp(argv[i], "--fps-limit") == 0 && i + 1 < argc)
+        {
+            options.pacing.fpsLimit = static_cast<float>(std::atof(argv[++i]));
+            if (options.pacing.fpsLimit <= 0.0f)
+                return false;
+        }
+        else if (std::strcmp(argv[i], "--stats") == 0)
+        {
+            options.showStats = true;
+        }
+        else if (std::strcmp(argv[i], "--profile-csv") == 0 && i + 1 < argc)
+        {
+            options.profileCsvPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--trace-spikes") == 0)
+        {
+            options.traceSpikes = true;
+        }
+        else if (std::strcmp(argv[i], "--shot-log") == 0)
+        {
+            options.shotLog = true;
+        }
+        else if (std::strcmp(argv[i], "--vsync") == 0 && i + 1 < argc)
+        {
+            ++i;
+            if (std::strcmp(argv[i], "on") == 0)
+                options.swapInterval = 1;
+            else if (std::strcmp(argv[i], "off") == 0)
+                options.swapInterval = 0;
+            else
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Отправка в очередь рендера одного кадра игры — общая для живой игры и экспорта повтора
+static void SubmitFrame(Renderer &renderer, Scene &scene, const glm::vec3 &cameraPos,
+                        const std::vector<ReplayBall> &balls, float ballRadius, const ReplayCue &cue)
+{
+    // Рендеринг сцены
+    renderer.SetPass(RenderPass::Scene);
+    scene.Render(renderer, cameraPos);
+
+    // Отрисовка шаров с текстурами
+    {
+        TRACE_SCOPE("Draw balls");
+        renderer.SetPass(RenderPass::Balls);
+        for (size_t i = 0; i < balls.size(); ++i)
+        {
+            glm::vec3 color = (i == 0) ? glm::vec3(0.0f, 0.0f, 0.0f) : glm::vec3(0.7f, 0.7f, 0.7f);
+            renderer.DrawBall(balls[i].position, ballRadius, color, balls[i].rotation, static_cast<int>(i));
+        }
+    }
+
+    // Кий и вектор удара видны, только пока шары стоят
+    if (cue.visible)
+    {
+        TRACE_SCOPE("Draw cue and aim");
+        glm::vec3 cueColor = glm::mix(
+            glm::vec3(0.6f, 0.4f, 0.2f), // коричневый (без силы)
+            glm::vec3(1.0f, 0.2f, 0.2f), // красный (максимальная сила)
+            cue.power);
+
+        renderer.SetPass(RenderPass::Cue);
+        renderer.DrawCue(cue.start, cue.end, cue.radius, cueColor);
+
+        renderer.SetPass(RenderPass::Aim);
+        renderer.DrawLine(cue.hitPoint, cue.impact, {1.0f, 1.0f, 1.0f});
+    }
+}
+
+// Экспорт повтора: рендер в FBO с фиксированным шагом времени без синхронизации с экраном
+static int ExportReplay(const LaunchOptions &options, Renderer &renderer, Scene &scene, const Camera &camera)
+{
+    Replay replay;
+    if (!replay.Load(options.replayPath))
+    {
+        std::cerr << "[Export] Failed to load replay: " << options.replayPath << std::endl;
+        return -1;
+    }
+
+    FrameExporter exporter;
+    if (!exporter.Init(options.exportWidth, options.exportHeight, options.exportOutput))
+        return -1;
+
+    const float aspect = static_cast<float>(options.exportWidth) / options.exportHeight;
+    const glm::mat4 view = camera.getViewMatrix();
+    const glm::mat4 projection = camera.getProjectionMatrix(aspect);
+    const size_t frameCount = static_cast<size_t>(replay.Duration() * options.exportFps) + 1;
 
-int main()
+    std::vector<ReplayBall> balls;
+    ReplayCue cue;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t frame = 0; frame < frameCount; ++frame)
+    {
+        replay.Sample(frame / options.exportFps, balls, cue);
+
+        exporter.BeginFrame();
+        renderer.PrepareFrame(view, projection);
+        SubmitFrame(renderer, scene, camera.getPosition(), balls, replay.BallRadius(), cue);
+        renderer.Flush();
+        if (!exporter.EndFrame())
+            return -1;
+    }
+    if (!exporter.Finish())
+        return -1;
+
+    const float seconds = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[Export] " << exporter.FramesWritten() << " frames " << options.exportWidth << "x"
+              << options.exportHeight << " rgba in " << seconds << " s ("
+              << replay.Duration() / std::max(seconds, 1e-6f) << "x real time)" << std::endl;
+    return 0;
+}
+
+// Стена столов: каждый стол играет сам с собой, на экран идёт вид сверху. Удар выбирается
+// из поля забиваемости (лучшие по допуску кандидаты), если кандидатов нет — случайный.
+// Физика шагает только на столах, где шары движутся, а перерисовываются только их плитки.
+static int RunWall(const LaunchOptions &options, Window &window, Renderer &renderer,
+                   const TableGeometry &table, float friction)
 {
-    Window window(1280, 720, "3D Billiards");
+    struct WallTable
+    {
+        std::vector<Ball> balls;
+        Physics physics;
+        double nextShot = 0.0;
+        PocketLayout layout;
+    };
+
+    const float ballRadius = 0.05f;
+    const float ballMass = 1.0f;
+    const float maxForce = Cue().getMaxForce();
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    PocketField pocketField(table, ballRadius);
+    pocketField.Build();
+    std::cout << "[PocketField] " << pocketField.Columns() << "x" << pocketField.Rows() << " cells, "
+              << pocketField.PocketCount() << " pockets in " << pocketField.BuildMs() << " ms" << std::endl;
+    std::vector<ShotCandidate> candidates;
+
+    TableWall wall;
+    if (!wall.Init(renderer.GetMeshes(), renderer.GetShaders(), table, options.wallTables))
+        return -1;
+
+    std::vector<WallTable> tables;
+    for (int i = 0; i < wall.TableCount(); ++i)
+    {
+        // Первые удары разнесены во времени, чтобы столы не двигались синхронно
+        tables.push_back({RackBalls(ballRadius, ballMass), Physics(table.width, table.height, friction),
+                          glfwGetTime() + 0.5 + 3.0 * unit(rng), PocketLayout(pocketField)});
+    }
+
+    const double kTickSeconds = 1.0 / 240.0;
+    const double kMaxCatchUp = 0.25;
+    double simTime = glfwGetTime();
+    while (!window.shouldClose())
+    {
+        TRACE_SCOPE("Wall frame");
+        window.update();
+        window.processInput();
+
+        const double now = glfwGetTime();
+        simTime = std::max(simTime, now - kMaxCatchUp);
+        for (WallTable &wallTable : tables)
+        {
+            std::vector<Ball> &balls = wallTable.balls;
+            bool moving = false;
+            for (const Ball &ball : balls)
+                moving |= ball.isMoving();
+
+            if (!moving && now >= wallTable.nextShot)
+            {
+                // Биток забит или на столе почти пусто — новая партия
+                size_t remaining = 0;
+                for (size_t i = 1; i < balls.size(); ++i)
+                    remaining += IsPocketed(balls[i]) ? 0 : 1;
+                if (IsPocketed(balls[0]) || remaining < 2)
+                {
+                    balls = RackBalls(ballRadius, ballMass);
+                    wallTable.physics.ResetContacts();
+                }
+
+                // Окна уточняются только в тенях сдвинувшихся шаров; кандидаты — чтение из поля
+                wallTable.layout.Refine(balls);
+                wallTable.layout.Candidates(balls, friction, maxForce, candidates);
+
+                ShotParams shot;
+                if (!candidates.empty())
+                {
+                    // Один из трёх лучших, чтобы столы не играли одинаково
+                    const size_t pick = static_cast<size_t>(unit(rng) * std::min<size_t>(3, candidates.size()));
+                    shot = candidates[std::min(pick, candidates.size() - 1)].shot;
+                }
+                else
+                {
+                    shot.angle = static_cast<int32_t>(unit(rng) * 36000.0f) % 36000;
+                    shot.power = 96 + static_cast<int32_t>(unit(rng) * 160.0f);
+                }
+                ShotSimulator::ApplyShot(balls[0], shot, maxForce);
+                wallTable.nextShot = now + 1.0 + 2.0 * unit(rng);
+                moving = true;
+            }
+
+            if (!moving)
+                continue;
+            for (double t = simTime; t + kTickSeconds <= now; t += kTickSeconds)
+            {
+                wallTable.physics.Update(balls, static_cast<float>(kTickSeconds));
+                CollectPocketed(balls, table);
+            }
+        }
+        while (simTime + kTickSeconds <= now)
+            simTime += kTickSeconds;
+
+        for (int i = 0; i < wall.TableCount(); ++i)
+            wall.UpdateTable(i, tables[i].balls);
+
+        int fbWidth = 0, fbHeight = 0;
+        window.getFramebufferSize(fbWidth, fbHeight);
+        wall.Render(fbWidth, fbHeight);
+
+        char line[96];
+        std::snprintf(line, sizeof(line), "TABLES %d  REDRAWN %d  DRAWS %d",
+                      wall.TableCount(), wall.TilesDrawn(), wall.DrawCalls());
+        renderer.GetOverlay().AddText(10.0f, 10.0f, line, glm::vec4(1.0f, 1.0f, 0.6f, 1.0f), 2.0f);
+        GLState::Viewport(0, 0, fbWidth, fbHeight);
+        renderer.DrawOverlay(fbWidth, fbHeight);
+
+        window.swapBuffers();
+    }
+    return 0;
+}
+
+// Ломаная траектории отрезками; segments — переиспользуемый буфер
+static void DrawPath(Renderer &renderer, const std::vector<glm::vec3> &path, std::vector<glm::vec3> &segments,
+                     const glm::vec3 &color)
+{
+    segments.clear();
+    for (size_t i = 1; i < path.size(); ++i)
+    {
+        segments.push_back(path[i - 1]);
+        segments.push_back(path[i]);
+    }
+    renderer.DrawLines(segments.data(), segments.size(), color);
+}
+
+// Оверлей со временем кадра, этапами CPU/GPU и счётчиками рендера
+static void DrawStatsOverlay(Renderer &renderer, const FrameProfiler &profiler, const FramePacer &pacer,
+                             const ShotOutcomeCache::Stats &shots, const ShotPreview::Stats &preview,
+                             const ShotReferee::Totals &events, uint64_t droppedEvents, const FrameArena &arena)
+{
+    DebugOverlay &overlay = renderer.GetOverlay();
+    const FrameSample &frame = profiler.Last();
+    const float scale = 2.0f;
+    const float lineHeight = DebugOverlay::kLineHeight * scale;
+    const glm::vec4 textColor(1.0f, 1.0f, 0.6f, 1.0f);
+    float y = 10.0f;
+    char line[160];
+
+    std::snprintf(line, sizeof(line), "FPS %.1f  FRAME %.2f MS  P50 %.2f  P95 %.2f  P99 %.2f",
+                  profiler.AverageFps(), frame.frameMs, profiler.P50(), profiler.P95(), profiler.P99());
+    overlay.AddText(10.0f, y, line, textColor, scale);
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "CPU  INPUT %.2f  PHYSICS %.2f  SUBMIT %.2f",
+                  frame.cpuMs[static_cast<int>(CpuStage::Input)],
+                  frame.cpuMs[static_cast<int>(CpuStage::Physics)],
+                  frame.cpuMs[static_cast<int>(CpuStage::Submit)]);
+    overlay.AddText(10.0f, y, line, textColor, scale);
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "GPU  SCENE %.2f  BALLS %.2f  CUE %.2f  AIM %.2f",
+                  frame.gpuMs[static_cast<int>(RenderPass::Scene)],
+                  frame.gpuMs[static_cast<int>(RenderPass::Balls)],
+                  frame.gpuMs[static_cast<int>(RenderPass::Cue)],
+                  frame.gpuMs[static_cast<int>(RenderPass::Aim)]);
+    overlay.AddText(10.0f, y, line, textColor, scale);
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "LATENCY %.1f MS  AVG %.1f  P99 %.1f  IN FLIGHT %d  WAIT %.2f",
+                  frame.latencyMs, pacer.AverageLatencyMs(), pacer.P99LatencyMs(), pacer.FramesInFlight(),
+                  frame.pacingWaitMs);
+    overlay.AddText(10.0f, y, line, textColor, scale);
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "DRAWS %u  STATE %u (ELIDED %u)  UNIFORMS %u  UPLOADS %u",
+                  frame.render.drawCalls, frame.render.stateChanges, frame.render.elidedStateChanges,
+                  frame.render.uniformUploads, frame.render.bufferUploads);
+    overlay.AddText(10.0f, y, line, textColor, scale);
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "QUEUE %zu  CULLED %zu",
+                  frame.queue.submitted, frame.queue.culled);
+    overlay.AddText(10.0f, y, line, textColor, scale);
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "SHOTS  HITS %llu  MISSES %llu  EVICTED %llu",
+                  static_cast<unsigned long long>(shots.hits), static_cast<unsigned long long>(shots.misses),
+                  static_cast<unsigned long long>(shots.evictions));
+    overlay.AddText(10.0f, y, line, textColor, scale);
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "PREVIEW  DONE %llu  CANCELLED %llu  CACHED %llu",
+                  static_cast<unsigned long long>(preview.completed),
+                  static_cast<unsigned long long>(preview.cancelled),
+                  static_cast<unsigned long long>(preview.cached));
+    overlay.AddText(10.0f, y, line, textColor, scale);
+    y += lineHeight;
+
+    std::snprintf(line, sizeof(line), "EVENTS  CONTACTS %llu  CUSHIONS %llu  POCKETED %llu  FOULS %llu  DROPPED %llu",
+                  static_cast<unsigned long long>(events.contacts), static_cast<unsigned long long>(events.cushions),
+                  static_cast<unsigned long long>(events.pocketed), static_cast<unsigned long long>(events.fouls),
+                  static_cast<unsigned long long>(droppedEvents));
+    overlay.AddText(10.0f, y, line, textColor, scale);
+    y += lineHeight;
+
+    if (AllocationTracker::kEnabled)
+        std::snprintf(line, sizeof(line), "ARENA %zu/%zu KB  HEAP ALLOCS %u",
+                      arena.Peak() / 1024, arena.Capacity() / 1024, frame.allocations);
+    else
+        std::snprintf(line, sizeof(line), "ARENA %zu/%zu KB", arena.Peak() / 1024, arena.Capacity() / 1024);
+    overlay.AddText(10.0f, y, line, textColor, scale);
+    y += lineHeight + 4.0f;
+
+    // График времени кадра, верхняя граница — 33 мс
+    const auto &history = profiler.History();
+    overlay.AddGraph(10.0f, y, 300.0f, 60.0f, history.data(), history.size(),
+                     profiler.HistoryStart(), 33.3f, glm::vec4(0.3f, 1.0f, 0.3f, 1.0f));
+}
+
+int main(int argc, char **argv)
+{
+    LaunchOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--record <file>]"
+                  << " [--export <replay> <output|\"|command\"> [--size WxH] [--fps N]] [--wall N]"
+                  << " [--latency N] [--fps-limit N] [--vsync on|off]" << std::endl;
+        return -1;
+    }
+
+    using StartupClock = std::chrono::steady_clock;
+    const auto startupBegin = StartupClock::now();
+    auto elapsedMs = [](StartupClock::time_point from, StartupClock::time_point to)
+    {
+        return std::chrono::duration<float, std::milli>(to - from).count();
+    };
+
+    // При экспорте окно скрыто и нужно только для контекста GL
+    Window window(1280, 720, "3D Billiards", !options.exporting);
     if (!window.init())
         return -1;
+    const auto windowReady = StartupClock::now();
+    if (options.swapInterval >= 0 && !options.exporting)
+        window.setSwapInterval(options.swapInterval);
 
     auto camera = std::make_shared<Camera>(
         glm::vec3(0.0f, 2.0f, 3.0f), // позиция камеры
@@ -24,6 +473,7 @@ int main()
     Renderer renderer;
     if (!renderer.Init())
         return -1;
+    const auto rendererReady = StartupClock::now();
 
     // Добавьте этот блок сразу после инициализации renderer
     // После создания renderer
@@ -32,136 +482,207 @@ int main()
         std::cerr << "Failed to load ball textures!" << std::endl;
         return -1;
     }
+    const auto texturesReady = StartupClock::now();
+    bool firstFrame = true;
 
     // Создаем объект сцены
-    Scene scene;
-
-    Physics physics(2.0f, 1.0f, 0.1f);
+    // Геометрия стола общая для сцены, физики и симуляции ударов
+    TableGeometry table;
+    const float tableFriction = 0.1f;
+    Scene scene(table);
 
-    float ballRadius = 0.05f;
-    float ballMass = 1.0f;
-    std::vector<Ball> balls;
-
-    // Черный шар - кий-бол (используем конструктор нового класса)
-    balls.emplace_back(glm::vec3(-0.8f, ballRadius, 0.0f), ballRadius, ballMass);
-
-    // Треугольная расстановка белых шаров
-    int rows = 5;
-    float spacing = ballRadius * 2.05f;         // чуть больше диаметра, чтобы не перекрывались
-    glm::vec3 startPos(0.3f, ballRadius, 0.0f); // ближе к центру стола, справа
+    if (options.exporting)
+    {
+        return ExportReplay(options, renderer, scene, *camera);
+    }
 
-    for (int row = 0; row < rows; ++row)
+    if (options.wallTables > 0)
     {
-        for (int col = 0; col <= row; ++col)
-        {
-            float x = startPos.x + row * spacing * 0.866f; // cos(30°)
-            float z = startPos.z - row * spacing * 0.5f + col * spacing;
-            balls.emplace_back(glm::vec3(x, ballRadius, z), ballRadius, ballMass);
-        }
+        return RunWall(options, window, renderer, table, tableFriction);
     }
 
+    // События физики разбираются в своём потоке; лузы проверяет сама физика
+    PhysicsEventRing physicsEvents(4096);
+    ShotReferee referee(physicsEvents, options.shotLog);
+    referee.Start();
+    Physics physics(table.width, table.height, tableFriction);
+    physics.SetPockets(table);
+    physics.SetEventSink(&physicsEvents);
+
+    // Биток и треугольная расстановка
+    const float ballRadius = 0.05f;
+    const float ballMass = 1.0f;
+    std::vector<Ball> balls = RackBalls(ballRadius, ballMass);
+
     // Создаем объект кия
     Cue cue;
 
-    // Лунки теперь управляются классом Scene, но нам нужны координаты для физики
-    const float pocketRadius = 0.08f;
-    std::vector<glm::vec3> pockets = {
-        glm::vec3(-0.95f, 0.01f, -0.45f), // левый нижний угол
-        glm::vec3(-0.95f, 0.01f, 0.45f),  // левый верхний угол
-        glm::vec3(0.95f, 0.01f, -0.45f),  // правый нижний угол
-        glm::vec3(0.95f, 0.01f, 0.45f),   // правый верхний угол
-        glm::vec3(0.0f, 0.01f, -0.45f),   // середина нижней стороны
-        glm::vec3(0.0f, 0.01f, 0.45f)     // середина верхней стороны
-    };
+    // Предпросмотр удара считается в фоне; результаты кэшируются по расстановке и параметрам удара
+    ShotSimulator simulator(table, tableFriction, cue.getMaxForce());
+    ShotOutcomeCache shotCache;
+    ShotPreview preview(simulator, shotCache, [] { glfwPostEmptyEvent(); });
+    preview.Start();
+    std::vector<glm::vec3> previewSegments;
 
-    while (!window.shouldClose())
+    FrameProfiler profiler;
+    if (!options.profileCsvPath.empty() && !profiler.OpenCsv(options.profileCsvPath))
     {
-        window.update();
-        window.processInput();
+        std::cerr << "Failed to open " << options.profileCsvPath << ", CSV log disabled" << std::endl;
+    }
+    bool showStats = options.showStats;
+    bool statsKeyDown = false;
+
+    FrameScheduler scheduler;
+    FramePacer pacer;
+    pacer.Configure(options.pacing);
+    const bool lowLatency = options.pacing.framesInFlight > 0;
+
+    // Трасса этапов кадра: с --trace-spikes пишется с запуска и сохраняется при всплеске времени
+    // кадра (первые kSpikeWarmupFrames — загрузка и прогрев, их не считаем); без флага первое
+    // нажатие F4 включает запись, следующие сохраняют трассу
+    const size_t kSpikeWarmupFrames = 300;
+    Tracer::Get().SetEnabled(options.traceSpikes);
+    Tracer::Get().SetThreadName("main");
+    int traceDumps = 0;
+    bool traceKeyDown = false;
+    double lastSpikeDump = -100.0;
+    auto dumpTrace = [&traceDumps](const std::string &path)
+    {
+        Tracer::Get().Dump(path);
+        ++traceDumps;
+        std::cout << "[Trace] " << path << std::endl;
+    };
 
-        float dt = window.getDeltaTime();
+    // Тик симуляции и предел догоняющих тиков за кадр
+    const double kTickSeconds = 1.0 / 240.0;
+    const double kMaxCatchUp = 0.25;
+    InputTimeline input;
+    double simTime = glfwGetTime();
+    input.Skip(simTime);
+
+    Replay replay;
+    replay.Reset(static_cast<uint32_t>(balls.size()), ballRadius);
+    std::vector<ReplayBall> frameBalls;
+    ReplayCue frameCue;
+
+    // Временные данные кадра; после прогрева установившийся кадр не должен обращаться к куче
+    FrameArena frameArena;
+    const size_t kWarmupFrames = 120;
+    size_t renderedFrames = 0;
+    uint64_t lastCueRevision = cue.getRevision();
+    uint64_t lastPreviewRevision = preview.Revision();
 
-        // Управление кием: поворот влево/вправо
-        if (window.isKeyPressed(GLFW_KEY_LEFT))
-        {
-            cue.rotate(90.0f * dt);
-        }
-        if (window.isKeyPressed(GLFW_KEY_RIGHT))
+    while (!window.shouldClose())
+    {
+        TRACE_SCOPE("Frame");
+        const uint64_t allocationsAtStart = AllocationTracker::Allocations();
+        const int traceDumpsAtStart = traceDumps;
+        profiler.BeginFrame();
+
+        // Ввод снимается только после того, как GPU разобрал очередь и подошёл срок кадра:
+        // иначе он ждал бы показа в очереди драйвера
+        const bool idle = scheduler.IsIdle();
+        if (!idle)
         {
-            cue.rotate(-90.0f * dt);
+            TRACE_SCOPE("Frame pacing");
+            pacer.WaitForFrame();
         }
+        profiler.BeginStage(CpuStage::Input);
 
-        // Управление смещением точки удара
-        if (window.isKeyPressed(GLFW_KEY_Q))
-        {
-            cue.adjustOffset(glm::vec2(-dt, 0.0f));
-        }
-        if (window.isKeyPressed(GLFW_KEY_E))
+        // В простое ждём событий вместо опроса; время ожидания в статистику не идёт
+        window.update(idle ? FrameScheduler::kIdleTimeout : 0.0);
+        pacer.InputSampled();
+        if (idle)
         {
-            cue.adjustOffset(glm::vec2(dt, 0.0f));
+            profiler.SkipFrame();
+            profiler.BeginStage(CpuStage::Input);
         }
-        if (window.isKeyPressed(GLFW_KEY_R))
         {
-            cue.adjustOffset(glm::vec2(0.0f, dt));
-        }
-        if (window.isKeyPressed(GLFW_KEY_F))
-        {
-            cue.adjustOffset(glm::vec2(0.0f, -dt));
+            TRACE_SCOPE("Input");
+            window.processInput();
+
+            // Переключение оверлея статистики
+            if (window.isKeyPressed(GLFW_KEY_F3))
+            {
+                if (!statsKeyDown)
+                    showStats = !showStats;
+                statsKeyDown = true;
+            }
+            else
+            {
+                statsKeyDown = false;
+            }
+
+            // Выгрузка трассы последних кадров по запросу
+            if (window.isKeyPressed(GLFW_KEY_F4))
+            {
+                if (!traceKeyDown && !Tracer::Get().IsEnabled())
+                {
+                    Tracer::Get().SetEnabled(true);
+                    std::cout << "[Trace] recording, press F4 again to save" << std::endl;
+                }
+                else if (!traceKeyDown)
+                {
+                    dumpTrace("trace_" + std::to_string(traceDumps) + ".json");
+                }
+                traceKeyDown = true;
+            }
+            else
+            {
+                traceKeyDown = false;
+            }
         }
 
-        // Зарядка силы удара при зажатом пробеле
-        if (window.isKeyPressed(GLFW_KEY_SPACE))
+        profiler.EndStage(CpuStage::Input);
+        profiler.BeginStage(CpuStage::Physics);
+
+        // Симуляция идёт фиксированными тиками; событие ввода применяется в тике, куда попала его
+        // отметка времени. Отметка — момент опроса событий, а не нажатия, поэтому время удержания
+        // квантовано периодом опроса (кадром): от частоты кадров не зависит масштаб силы и поворота,
+        // но момент отпускания известен лишь с точностью до кадра
+        const double now = glfwGetTime();
+        if (now - simTime > kMaxCatchUp)
         {
-            cue.charge(dt);
+            // После простоя не догоняем пропущенное время (шары всё равно стояли)
+            simTime = now - kMaxCatchUp;
+            input.Skip(simTime);
         }
-        else
+        while (simTime + kTickSeconds <= now)
         {
+            TRACE_SCOPE("Simulation tick");
+            simTime += kTickSeconds;
+            input.Advance(window.getInputQueue(), simTime);
+
+            // Управление кием: поворот влево/вправо
+            const float turn = input.HeldSeconds(GLFW_KEY_LEFT) - input.HeldSeconds(GLFW_KEY_RIGHT);
+            if (turn != 0.0f)
+            {
+                cue.rotate(90.0f * turn);
+            }
+
+            // Управление смещением точки удара
+            cue.adjustOffset(glm::vec2(input.HeldSeconds(GLFW_KEY_E) - input.HeldSeconds(GLFW_KEY_Q),
+                                       input.HeldSeconds(GLFW_KEY_R) - input.HeldSeconds(GLFW_KEY_F)));
+
+            // Зарядка силы удара — на время удержания пробела внутри тика
+            cue.charge(input.HeldSeconds(GLFW_KEY_SPACE));
+
             // Отпуск пробела — наносим удар, если сила > 0
-            if (cue.getPower() > 0.01f && !balls[0].isMoving())
+            if (!input.IsDown(GLFW_KEY_SPACE) && cue.getPower() > 0.01f && !balls[0].isMoving())
             {
                 glm::vec3 impulse = cue.release();
                 glm::vec3 hitPoint = cue.getHitPoint(balls[0].getPosition(), balls[0].getRadius());
                 balls[0].applyImpulse(impulse);
                 balls[0].applyAngularImpulse(hitPoint, impulse);
             }
-        }
-
-        // Обновление физики
-        physics.Update(balls, dt);
 
-        // Проверка попадания в лунки
-        for (auto &ball : balls)
-        {
-            for (const auto &pocket : pockets)
+            // Обновление физики вместе с лузами
             {
-                if (physics.CheckPocketCollision(ball, pocket, pocketRadius))
-                {
-                    ball.setPosition(glm::vec3(-100.0f, -100.0f, -100.0f));
-                    ball.setVelocity(glm::vec3(0.0f));
-                    break;
-                }
+                TRACE_SCOPE("Physics::Update");
+                physics.Update(balls, static_cast<float>(kTickSeconds));
             }
         }
 
-        glm::mat4 view = camera->getViewMatrix();
-        glm::mat4 projection = camera->getProjectionMatrix(window.getAspectRatio());
-
-        renderer.PrepareFrame(); // Сброс состояний
-
-        // Рендеринг сцены
-        scene.Render(renderer, view, projection, camera->getPosition());
-
-        // Отрисовка шаров с текстурами
-        for (size_t i = 0; i < balls.size(); ++i)
-        {
-            glm::vec3 color = (i == 0) ? glm::vec3(0.0f, 0.0f, 0.0f) : glm::vec3(0.7f, 0.7f, 0.7f);
-            renderer.DrawBall(balls[i].getPosition(), balls[i].getRadius(), color,
-                              view, projection, balls[i].getRotation(), static_cast<int>(i));
-        }
-
-        // Отрисовка кия
-        const Ball &cueBall = balls[0];
-
         // Проверяем, движутся ли шары
         bool ballsMoving = false;
         for (const auto &ball : balls)
@@ -173,36 +694,162 @@ int main()
             }
         }
 
-        if (!ballsMoving)
+        profiler.EndStage(CpuStage::Physics);
+
+        // Ничего не изменилось — кадр не перерисовываем, на экране остаётся предыдущий
+        scheduler.Update(camera->getRevision(), cue.getRevision(), ballsMoving, window.consumeActivity());
+        // Фоновый предпросмотр досчитал прицел уже после последнего кадра
+        const uint64_t previewRevision = preview.Revision();
+        const bool previewPublished = previewRevision != lastPreviewRevision;
+        if (previewPublished)
+        {
+            lastPreviewRevision = previewRevision;
+            scheduler.Invalidate();
+        }
+        if (!scheduler.ShouldRender())
         {
-            // Получаем точки кия
-            glm::vec3 hitPoint = cue.getHitPoint(cueBall.getPosition(), cueBall.getRadius());
-            glm::vec3 cueStart = cue.getCueStart(hitPoint);
-            glm::vec3 cueEnd = cue.getCueEnd(hitPoint);
+            continue;
+        }
+
+        frameArena.Reset();
+        ++renderedFrames;
+        profiler.BeginStage(CpuStage::Submit);
 
-            glm::vec3 cueColor = glm::mix(
-                glm::vec3(0.6f, 0.4f, 0.2f), // коричневый (без силы)
-                glm::vec3(1.0f, 0.2f, 0.2f), // красный (максимальная сила)
-                cue.getPower());
+        // Камера — по самым свежим движениям мыши, пришедшим за время физики
+        if (lowLatency)
+            window.pollEvents();
 
-            // Рисуем цилиндрический кий
-            renderer.DrawCue(cueStart, cueEnd, cue.getRadius(), cueColor, view, projection);
+        glm::mat4 view = camera->getViewMatrix();
+        glm::mat4 projection = camera->getProjectionMatrix(window.getAspectRatio());
+
+        renderer.PrepareFrame(view, projection); // Сброс состояний
+
+        // Состояние кадра: то же, что пишется в повтор
+        Replay::Capture(balls, frameBalls);
+        frameCue = ReplayCue();
+        if (!ballsMoving)
+        {
+            const Ball &cueBall = balls[0];
+            frameCue.hitPoint = cue.getHitPoint(cueBall.getPosition(), cueBall.getRadius());
+            frameCue.start = cue.getCueStart(frameCue.hitPoint);
+            frameCue.end = cue.getCueEnd(frameCue.hitPoint);
+            frameCue.radius = cue.getRadius();
+            frameCue.power = cue.getPower();
+            frameCue.visible = 1;
 
             // Вектор удара
-            std::vector<glm::vec3> positions;
+            ArenaVector<glm::vec3> positions{ArenaAllocator<glm::vec3>(frameArena)};
+            positions.reserve(balls.size());
             for (const auto &b : balls)
             {
                 positions.push_back(b.getPosition());
             }
 
-            float tableWidth = 2.0f;
-            float tableHeight = 1.0f;
-            glm::vec3 impact = cue.computeImpactPoint(hitPoint, positions,
-                                                      cueBall.getRadius(), tableWidth, tableHeight);
-            renderer.DrawLine(hitPoint, impact, {1.0f, 1.0f, 1.0f}, view, projection);
+            frameCue.impact = cue.computeImpactPoint(frameCue.hitPoint, positions.data(), positions.size(),
+                                                     cueBall.getRadius(), table.width, table.height);
+        }
+        if (options.recording)
+        {
+            replay.Record(static_cast<float>(simTime), frameBalls, frameCue);
         }
 
+        SubmitFrame(renderer, scene, camera->getPosition(), frameBalls, ballRadius, frameCue);
+
+        // Траектории битка и первого задетого шара при заряженном ударе. Прицел уходит в фоновую
+        // симуляцию, рисуется последний готовый результат — кадр его не ждёт
+        if (frameCue.visible && cue.getPower() > 0.01f)
+        {
+            TRACE_SCOPE("Shot preview");
+            preview.Request(balls, ShotParams::FromCue(cue));
+            if (auto outcome = preview.Latest())
+            {
+                renderer.SetPass(RenderPass::Aim);
+                DrawPath(renderer, outcome->cuePath, previewSegments, {1.0f, 0.9f, 0.2f});
+                DrawPath(renderer, outcome->objectPath, previewSegments, {0.4f, 0.8f, 1.0f});
+            }
+        }
+
+        renderer.Flush();
+
+        profiler.EndStage(CpuStage::Submit);
+
+        FrameSample &sample = profiler.Current();
+        for (int pass = 0; pass < kRenderPassCount; ++pass)
+        {
+            sample.gpuMs[pass] = renderer.GetGpuMilliseconds(static_cast<RenderPass>(pass));
+        }
+        sample.render = renderer.GetFrameStats();
+        sample.queue = renderer.GetQueueStats();
+        sample.latencyMs = pacer.LatencyMs();
+        sample.pacingWaitMs = pacer.WaitMs();
+
+        if (showStats)
+        {
+            int fbWidth = 0, fbHeight = 0;
+            window.getFramebufferSize(fbWidth, fbHeight);
+            DrawStatsOverlay(renderer, profiler, pacer, shotCache.GetStats(), preview.GetStats(),
+                             referee.GetTotals(), physicsEvents.Dropped(), frameArena);
+            renderer.DrawOverlay(fbWidth, fbHeight);
+        }
+
+        // Кадр без изменений сцены, кроме камеры: повторные запросы предпросмотра идут из кэша,
+        // буферы уже прогреты, и ни одной аллокации в куче быть не должно
+        if (AllocationTracker::kEnabled)
+        {
+            const uint64_t frameAllocations = AllocationTracker::Allocations() - allocationsAtStart;
+            sample.allocations = static_cast<uint32_t>(frameAllocations);
+            const bool steadyFrame = renderedFrames > kWarmupFrames && !ballsMoving && !options.recording &&
+                                     cue.getRevision() == lastCueRevision && !previewPublished &&
+                                     traceDumps == traceDumpsAtStart;
+            if (steadyFrame && frameAllocations != 0)
+            {
+                std::cerr << "[Alloc] " << frameAllocations << " heap allocations in a steady-state frame" << std::endl;
+                assert(frameAllocations == 0 && "steady-state frame must not allocate");
+            }
+        }
+        lastCueRevision = cue.getRevision();
+
+        profiler.EndFrame();
+
         window.swapBuffers();
+        pacer.FramePresented();
+        scheduler.FrameRendered();
+
+        // Всплеск времени кадра — сохраняем трассу, чтобы увидеть, чем был занят кадр
+        const float spikeMs = std::max(50.0f, profiler.P50() * 4.0f);
+        if (options.traceSpikes && renderedFrames > kSpikeWarmupFrames && profiler.Last().frameMs > spikeMs &&
+            glfwGetTime() - lastSpikeDump > 10.0)
+        {
+            lastSpikeDump = glfwGetTime();
+            dumpTrace("trace_spike_" + std::to_string(traceDumps) + ".json");
+        }
+
+        if (firstFrame)
+        {
+            // Время до первого кадра по этапам запуска
+            firstFrame = false;
+            glFinish();
+            const auto firstFrameReady = StartupClock::now();
+            const ProgramCache::Stats &programs = ProgramCache::GetStats();
+            std::cout << "[Startup] window " << elapsedMs(startupBegin, windowReady)
+                      << " ms, renderer " << elapsedMs(windowReady, rendererReady)
+                      << " ms (programs: " << programs.hits << " cached, " << programs.misses << " compiled)"
+                      << ", textures " << elapsedMs(rendererReady, texturesReady)
+                      << " ms, first frame " << elapsedMs(texturesReady, firstFrameReady)
+                      << " ms, total " << elapsedMs(startupBegin, firstFrameReady) << " ms" << std::endl;
+        }
+    }
+
+    std::cout << "[Pacing] input-to-present avg " << pacer.AverageLatencyMs() << " ms, p99 "
+              << pacer.P99LatencyMs() << " ms (frames in flight: "
+              << (lowLatency ? std::to_string(options.pacing.framesInFlight) : std::string("driver")) << ")" << std::endl;
+
+    if (options.recording)
+    {
+        if (replay.Save(options.recordPath))
+            std::cout << "[Replay] " << replay.FrameCount() << " frames saved to " << options.recordPath << std::endl;
+        else
+            std::cerr << "[Replay] Failed to save " << options.recordPath << std::endl;
     }
 
     return 0;
@@ -0,0 +1,332 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "GLState.hpp"
+#include "Shader.hpp"
+#include "RenderStats.hpp"
+
+// Экранный оверлей отладки: текст встроенным шрифтом 5x7 и простые графики.
+// Вся геометрия кадра собирается на CPU и рисуется одним вызовом.
+class DebugOverlay
+{
+public:
+    DebugOverlay() = default;
+    ~DebugOverlay();
+
+    DebugOverlay(const DebugOverlay &) = delete;
+    DebugOverlay &operator=(const DebugOverlay &) = delete;
+
+    bool Init();
+    void Cleanup();
+
+    // Координаты в пикселях от левого верхнего угла
+    void AddText(float x, float y, const char *text, const glm::vec4 &color = glm::vec4(1.0f), float scale = 2.0f);
+    void AddRect(float x, float y, float width, float height, const glm::vec4 &color);
+
+    // Столбчатый график: values — кольцевой буфер, start — индекс самого старого значения
+    void AddGraph(float x, float y, float width, float height,
+                  const float *values, size_t count, size_t start,
+                  float maxValue, const glm::vec4 &color);
+
+    void Draw(int screenWidth, int screenHeight);
+
+    static constexpr float kLineHeight = 9.0f; // Высота строки при масштабе 1
+
+private:
+    struct Vertex
+    {
+        float x, y;
+        float u, v;
+        uint8_t color[4];
+    };
+
+    static constexpr int kGlyphWidth = 5;
+    static constexpr int kGlyphHeight = 7;
+    static constexpr int kCellWidth = 6;
+    static constexpr int kCellHeight = 8;
+
+    Shader shader;
+    GLuint vao = 0, vbo = 0, fontTexture = 0;
+    int glyphCount = 0;
+    std::vector<Vertex> vertices;
+
+    static const char *Glyphs();
+    static const uint8_t *GlyphRows(int index);
+    int GlyphIndex(char c) const;
+    void AddQuad(float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1, const glm::vec4 &color);
+};
+
+inline DebugOverlay::~DebugOverlay()
+{
+    Cleanup();
+}
+
+inline const char *DebugOverlay::Glyphs()
+{
+    // Последний символ — сплошной блок для прямоугольников и графиков
+    return " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ.:/-%()=_\x7f";
+}
+
+inline const uint8_t *DebugOverlay::GlyphRows(int index)
+{
+    // Строки глифов сверху вниз, младшие 5 бит — пиксели слева направо
+    static const uint8_t rows[][kGlyphHeight] = {
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+        {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E}, // 0
+        {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E}, // 1
+        {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F}, // 2
+        {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E}, // 3
+        {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02}, // 4
+        {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E}, // 5
+        {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E}, // 6
+        {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08}, // 7
+        {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E}, // 8
+        {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C}, // 9
+        {0x0E, 0x11, 0x11, 0x11, 0x1F, 0x11, 0x11}, // A
+        {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E}, // B
+        {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E}, // C
+        {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C}, // D
+        {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F}, // E
+        {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10}, // F
+        {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F}, // G
+        {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11}, // H
+        {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E}, // I
+        {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C}, // J
+        {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11}, // K
+        {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F}, // L
+        {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11}, // M
+        {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11}, // N
+        {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // O
+        {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10}, // P
+        {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D}, // Q
+        {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11}, // R
+        {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E}, // S
+        {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04}, // T
+        {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E}, // U
+        {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04}, // V
+        {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A}, // W
+        {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11}, // X
+        {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04}, // Y
+        {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F}, // Z
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C}, // .
+        {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00}, // :
+        {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00}, // /
+        {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00}, // -
+        {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03}, // %
+        {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02}, // (
+        {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08}, // )
+        {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00}, // =
+        {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F}, // _
+        {0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F, 0x1F}, // блок
+    };
+    return rows[index];
+}
+
+inline bool DebugOverlay::Init()
+{
+    const char *vertexSource = R"(
+#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in vec4 aColor;
+
+uniform vec2 uScreenSize;
+
+out vec2 TexCoord;
+out vec4 Color;
+
+void main() {
+    vec2 ndc = aPos / uScreenSize * 2.0 - 1.0;
+    gl_Position = vec4(ndc.x, -ndc.y, 0.0, 1.0);
+    TexCoord = aTexCoord;
+    Color = aColor;
+}
+)";
+
+    const char *fragmentSource = R"(
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+in vec4 Color;
+
+uniform sampler2D uFont;
+
+void main() {
+    if (texture(uFont, TexCoord).r < 0.5)
+        discard;
+    FragColor = Color;
+}
+)";
+
+    if (!shader.InitFromSource(vertexSource, fragmentSource))
+        return false;
+
+    // Атлас шрифта: глифы в одну строку, по ячейке 6x8 пикселей
+    glyphCount = static_cast<int>(std::strlen(Glyphs()));
+    const int atlasWidth = glyphCount * kCellWidth;
+    std::vector<uint8_t> pixels(atlasWidth * kCellHeight, 0);
+    for (int g = 0; g < glyphCount; ++g)
+    {
+        const uint8_t *rows = GlyphRows(g);
+        for (int y = 0; y < kGlyphHeight; ++y)
+        {
+            for (int x = 0; x < kGlyphWidth; ++x)
+            {
+                if (rows[y] & (0x10 >> x))
+                    pixels[y * atlasWidth + g * kCellWidth + x] = 255;
+            }
+        }
+    }
+
+    glGenTextures(1, &fontTexture);
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D, fontTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, atlasWidth, kCellHeight, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+
+    GLState::BindVertexArray(vao);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void *)offsetof(Vertex, u));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void *)offsetof(Vertex, color));
+
+    vertices.reserve(16 * 1024);
+    return true;
+}
+
+inline void DebugOverlay::Cleanup()
+{
+    if (vao)
+    {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &vbo);
+        glDeleteTextures(1, &fontTexture);
+        GLState::Invalidate();
+        vao = 0;
+        vbo = 0;
+        fontTexture = 0;
+    }
+}
+
+inline int DebugOverlay::GlyphIndex(char c) const
+{
+    const char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    const char *found = std::strchr(Glyphs(), upper);
+    return (found && upper != '\0') ? static_cast<int>(found - Glyphs()) : 0;
+}
+
+inline void DebugOverlay::AddQuad(float x0, float y0, float x1, float y1,
+                                  float u0, float v0, float u1, float v1, const glm::vec4 &color)
+{
+    Vertex corners[4] = {
+        {x0, y0, u0, v0, {}},
+        {x1, y0, u1, v0, {}},
+        {x1, y1, u1, v1, {}},
+        {x0, y1, u0, v1, {}},
+    };
+    for (auto &corner : corners)
+    {
+        for (int i = 0; i < 4; ++i)
+            corner.color[i] = static_cast<uint8_t>(glm::clamp(color[i], 0.0f, 1.0f) * 255.0f);
+    }
+
+    vertices.push_back(corners[0]);
+    vertices.push_back(corners[1]);
+    vertices.push_back(corners[2]);
+    vertices.push_back(corners[2]);
+    vertices.push_back(corners[3]);
+    vertices.push_back(corners[0]);
+}
+
+inline void DebugOverlay::AddText(float x, float y, const char *text, const glm::vec4 &color, float scale)
+{
+    const float atlasWidth = static_cast<float>(glyphCount * kCellWidth);
+    float penX = x;
+    for (const char *c = text; *c; ++c)
+    {
+        const int glyph = GlyphIndex(*c);
+        if (glyph != 0)
+        {
+            const float u0 = glyph * kCellWidth / atlasWidth;
+            const float u1 = (glyph * kCellWidth + kGlyphWidth) / atlasWidth;
+            const float v1 = static_cast<float>(kGlyphHeight) / kCellHeight;
+            AddQuad(penX, y, penX + kGlyphWidth * scale, y + kGlyphHeight * scale,
+                    u0, 0.0f, u1, v1, color);
+        }
+        penX += kCellWidth * scale;
+    }
+}
+
+inline void DebugOverlay::AddRect(float x, float y, float width, float height, const glm::vec4 &color)
+{
+    // Берём середину сплошного глифа, чтобы не зависеть от фильтрации на границах
+    const float atlasWidth = static_cast<float>(glyphCount * kCellWidth);
+    const float u = ((glyphCount - 1) * kCellWidth + 2.5f) / atlasWidth;
+    const float v = 3.5f / kCellHeight;
+    AddQuad(x, y, x + width, y + height, u, v, u, v, color);
+}
+
+inline void DebugOverlay::AddGraph(float x, float y, float width, float height,
+                                   const float *values, size_t count, size_t start,
+                                   float maxValue, const glm::vec4 &color)
+{
+    if (count == 0 || maxValue <= 0.0f)
+        return;
+
+    AddRect(x, y, width, height, glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
+
+    const float barWidth = width / count;
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float value = values[(start + i) % count];
+        const float barHeight = glm::min(value / maxValue, 1.0f) * height;
+        AddRect(x + i * barWidth, y + height - barHeight, glm::max(barWidth, 1.0f), barHeight, color);
+    }
+}
+
+inline void DebugOverlay::Draw(int screenWidth, int screenHeight)
+{
+    if (vertices.empty())
+        return;
+
+    GLState::Disable(GL_DEPTH_TEST);
+
+    shader.Use();
+    shader.SetVec2("uScreenSize", glm::vec2(static_cast<float>(screenWidth), static_cast<float>(screenHeight)));
+    shader.SetInt("uFont", 0);
+
+    GLState::ActiveTexture(GL_TEXTURE0);
+    GLState::BindTexture(GL_TEXTURE_2D, fontTexture);
+
+    GLState::BindVertexArray(vao);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_STREAM_DRAW);
+    ++RenderStats::Current().bufferUploads;
+
+    glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices.size()));
+    ++RenderStats::Current().drawCalls;
+
+    GLState::Enable(GL_DEPTH_TEST);
+
+    vertices.clear();
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "GLState.hpp"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+// Рендер во внеэкранный буфер кадра и выгрузка кадров в поток сырых RGBA.
+// Чтение идёт через кольцо PBO: glReadPixels кадра N только ставит копирование в очередь,
+// а в память отображается кадр N - kRingSize, который GPU к этому времени уже закончил.
+// Вывод — файл или, если путь начинается с '|', stdin внешней команды (например, ffmpeg).
+class FrameExporter
+{
+public:
+    static constexpr int kRingSize = 3;
+
+    FrameExporter() = default;
+    ~FrameExporter() { Cleanup(); }
+
+    FrameExporter(const FrameExporter &) = delete;
+    FrameExporter &operator=(const FrameExporter &) = delete;
+
+    bool Init(int width, int height, const std::string &output);
+    void Cleanup();
+
+    // Делает внеэкранный буфер целевым для рисования
+    void BeginFrame();
+    // Ставит чтение кадра в очередь и выгружает самый старый готовый
+    bool EndFrame();
+    // Дописывает оставшиеся в кольце кадры
+    bool Finish();
+
+    size_t FramesWritten() const { return framesWritten; }
+
+private:
+    int width = 0;
+    int height = 0;
+    size_t frameBytes = 0;
+
+    GLuint fbo = 0;
+    GLuint colorBuffer = 0;
+    GLuint depthBuffer = 0;
+    GLuint pbos[kRingSize] = {};
+    GLsync fences[kRingSize] = {};
+
+    size_t framesQueued = 0;
+    size_t framesWritten = 0;
+
+    FILE *stream = nullptr;
+    bool isPipe = false;
+    std::vector<uint8_t> flipped;
+
+    bool WriteSlot(int slot);
+};
+
+inline bool FrameExporter::Init(int w, int h, const std::string &output)
+{
+    width = w;
+    height = h;
+    frameBytes = static_cast<size_t>(w) * h * 4;
+
+    isPipe = !output.empty() && output[0] == '|';
+    stream = isPipe ? popen(output.c_str() + 1, "w") : std::fopen(output.c_str(), "wb");
+    if (!stream)
+    {
+        std::cerr << "[Export] Failed to open output: " << output << std::endl;
+        return false;
+    }
+
+    glGenRenderbuffers(1, &colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+    glGenRenderbuffers(1, &depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &fbo);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+    const bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    if (!complete)
+    {
+        std::cerr << "[Export] Framebuffer is incomplete" << std::endl;
+        return false;
+    }
+
+    glGenBuffers(kRingSize, pbos);
+    for (GLuint pbo : pbos)
+    {
+        GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+    }
+
+    flipped.resize(frameBytes);
+    return true;
+}
+
+inline void FrameExporter::Cleanup()
+{
+    for (GLsync &fence : fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+        fence = nullptr;
+    }
+    if (pbos[0])
+    {
+        glDeleteBuffers(kRingSize, pbos);
+        std::memset(pbos, 0, sizeof(pbos));
+    }
+    if (fbo)
+        glDeleteFramebuffers(1, &fbo);
+    if (colorBuffer)
+        glDeleteRenderbuffers(1, &colorBuffer);
+    if (depthBuffer)
+        glDeleteRenderbuffers(1, &depthBuffer);
+    fbo = colorBuffer = depthBuffer = 0;
+    GLState::Invalidate();
+
+    if (stream)
+    {
+        if (isPipe)
+            pclose(stream);
+        else
+            std::fclose(stream);
+        stream = nullptr;
+    }
+}
+
+inline void FrameExporter::BeginFrame()
+{
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, fbo);
+    GLState::Viewport(0, 0, width, height);
+}
+
+inline bool FrameExporter::EndFrame()
+{
+    const int slot = static_cast<int>(framesQueued % kRingSize);
+
+    // Слот занят кадром kRingSize назад — сначала выгружаем его
+    if (framesQueued >= kRingSize && !WriteSlot(slot))
+        return false;
+
+    GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    fences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    glFlush();
+    ++framesQueued;
+    return true;
+}
+
+inline bool FrameExporter::Finish()
+{
+    const size_t pending = std::min<size_t>(framesQueued, kRingSize);
+    for (size_t i = framesQueued - pending; i < framesQueued; ++i)
+    {
+        if (!WriteSlot(static_cast<int>(i % kRingSize)))
+            return false;
+    }
+    framesQueued = 0;
+
+    if (stream)
+        std::fflush(stream);
+    GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
+    return true;
+}
+
+inline bool FrameExporter::WriteSlot(int slot)
+{
+    if (!fences[slot])
+        return true;
+
+    // Обычно копирование уже завершено и ожидание мгновенное
+    glClientWaitSync(fences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+    glDeleteSync(fences[slot]);
+    fences[slot] = nullptr;
+
+    GLState::BindBuffer(GL_PIXEL_PACK_BUFFER, pbos[slot]);
+    const auto *pixels = static_cast<const uint8_t *>(
+        glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, GL_MAP_READ_BIT));
+    if (!pixels)
+        return false;
+
+    // GL хранит строки снизу вверх, видеокодеры ждут сверху вниз
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    for (int y = 0; y < height; ++y)
+    {
+        std::memcpy(flipped.data() + y * rowBytes, pixels + (height - 1 - y) * rowBytes, rowBytes);
+    }
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+
+    if (std::fwrite(flipped.data(), 1, frameBytes, stream) != frameBytes)
+    {
+        std::cerr << "[Export] Write failed after " << framesWritten << " frames" << std::endl;
+        return false;
+    }
+    ++framesWritten;
+    return true;
+}
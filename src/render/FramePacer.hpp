@@ -0,0 +1,204 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+// Темп кадров для низкой задержки. Драйвер может поставить в очередь несколько кадров
+// после swapBuffers, и ввод, снятый сейчас, появится на экране на несколько кадров позже.
+// После каждого swapBuffers ставится забор (glFenceSync); перед опросом ввода следующего
+// кадра дожидаемся, пока в полёте останется не больше заданного числа кадров.
+// Ограничитель частоты спит до дедлайна с запасом и докручивает остаток — работает и без vsync.
+// Задержка ввод -> показ: от снятия ввода до срабатывания забора кадра (приблизительно момент
+// показа: забор стоит после команд swapBuffers). Без ограничения очереди готовность кадра
+// замечается только при следующей проверке, и замер завышен не больше чем на кадр.
+class FramePacer
+{
+public:
+    static constexpr int kMaxFramesInFlight = 4;
+    static constexpr size_t kLatencyHistory = 240;
+
+    struct Options
+    {
+        int framesInFlight = 0; // 0 — очередь драйвера не ограничивается (только замер)
+        float fpsLimit = 0.0f;  // 0 — без ограничения частоты
+    };
+
+    FramePacer();
+    ~FramePacer();
+
+    FramePacer(const FramePacer &) = delete;
+    FramePacer &operator=(const FramePacer &) = delete;
+
+    void Configure(const Options &options);
+    const Options &GetOptions() const { return options; }
+
+    // Перед опросом ввода: ограничение частоты и ожидание GPU
+    void WaitForFrame();
+    // Ввод для кадра снят — от этого момента считается задержка
+    void InputSampled() { inputTime = Clock::now(); }
+    // Сразу после swapBuffers
+    void FramePresented();
+
+    int FramesInFlight() const { return inFlight; }
+    float LatencyMs() const { return lastLatency; } // Последний замер
+    float AverageLatencyMs() const { return averageLatency; }
+    float P99LatencyMs() const { return p99Latency; }
+    float WaitMs() const { return waitMs; } // Простой в WaitForFrame за последний кадр
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // sleep_until просыпается с опозданием до ~1 мс (на Windows — до такта планировщика),
+    // последний отрезок до дедлайна докручивается
+    static constexpr std::chrono::microseconds kSpinMargin{1500};
+    static constexpr GLuint64 kFenceTimeoutNs = 100'000'000; // Дольше — GPU завис, кадр не ждём
+
+    struct Frame
+    {
+        GLsync fence = nullptr;
+        Clock::time_point inputTime;
+    };
+
+    Options options;
+    Clock::duration period = Clock::duration::zero();
+    Clock::time_point deadline;
+    Clock::time_point inputTime;
+
+    Frame frames[kMaxFramesInFlight];
+    int oldest = 0;
+    int inFlight = 0;
+
+    std::vector<float> latencies; // Кольцо замеров, мс
+    size_t latencyHead = 0;
+    size_t latencyCount = 0;
+    size_t samplesSinceUpdate = 0;
+    std::vector<float> sorted;
+    float lastLatency = 0.0f;
+    float averageLatency = 0.0f;
+    float p99Latency = 0.0f;
+    float waitMs = 0.0f;
+
+    void LimitRate();
+    void RetireFrames(int keep);
+    void AddLatency(float ms);
+    void UpdateStatistics();
+};
+
+inline FramePacer::FramePacer()
+    : latencies(kLatencyHistory, 0.0f)
+{
+    sorted.reserve(kLatencyHistory);
+}
+
+inline FramePacer::~FramePacer()
+{
+    // Заборы удаляются при ещё текущем контексте: объект живёт внутри главного цикла
+    for (int i = 0; i < inFlight; ++i)
+        glDeleteSync(frames[(oldest + i) % kMaxFramesInFlight].fence);
+}
+
+inline void FramePacer::Configure(const Options &newOptions)
+{
+    options = newOptions;
+    options.framesInFlight = std::clamp(options.framesInFlight, 0, kMaxFramesInFlight - 1);
+    period = options.fpsLimit > 0.0f
+                 ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / options.fpsLimit))
+                 : Clock::duration::zero();
+    deadline = Clock::now();
+}
+
+inline void FramePacer::WaitForFrame()
+{
+    const Clock::time_point start = Clock::now();
+
+    // Без ограничения очередь всё равно не длиннее кольца заборов
+    RetireFrames(options.framesInFlight > 0 ? options.framesInFlight - 1 : kMaxFramesInFlight - 1);
+    LimitRate();
+
+    waitMs = std::chrono::duration<float, std::milli>(Clock::now() - start).count();
+}
+
+inline void FramePacer::FramePresented()
+{
+    if (inFlight == kMaxFramesInFlight)
+        RetireFrames(kMaxFramesInFlight - 1);
+
+    Frame &frame = frames[(oldest + inFlight) % kMaxFramesInFlight];
+    frame.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    frame.inputTime = inputTime;
+    ++inFlight;
+
+    // Забор должен дойти до GPU, иначе ожидание перед следующим кадром его не дождётся
+    glFlush();
+}
+
+inline void FramePacer::LimitRate()
+{
+    if (period == Clock::duration::zero())
+        return;
+
+    // Отстали больше чем на кадр (простой, долгий кадр) — расписание начинается заново
+    const Clock::time_point now = Clock::now();
+    if (deadline + period < now)
+        deadline = now;
+
+    if (now < deadline - kSpinMargin)
+        std::this_thread::sleep_until(deadline - kSpinMargin);
+    while (Clock::now() < deadline)
+        std::this_thread::yield();
+
+    deadline += period;
+}
+
+inline void FramePacer::RetireFrames(int keep)
+{
+    while (inFlight > 0)
+    {
+        Frame &frame = frames[oldest];
+        const bool mustWait = inFlight > keep;
+        const GLenum status = glClientWaitSync(frame.fence, GL_SYNC_FLUSH_COMMANDS_BIT, mustWait ? kFenceTimeoutNs : 0);
+        if (status == GL_TIMEOUT_EXPIRED && !mustWait)
+            break;
+
+        // Готовые кадры дают замер; зависший или ошибочный забор отбрасывается без замера
+        if (status == GL_ALREADY_SIGNALED || status == GL_CONDITION_SATISFIED)
+            AddLatency(std::chrono::duration<float, std::milli>(Clock::now() - frame.inputTime).count());
+
+        glDeleteSync(frame.fence);
+        frame.fence = nullptr;
+        oldest = (oldest + 1) % kMaxFramesInFlight;
+        --inFlight;
+    }
+}
+
+inline void FramePacer::AddLatency(float ms)
+{
+    lastLatency = ms;
+    latencies[latencyHead] = ms;
+    latencyHead = (latencyHead + 1) % latencies.size();
+    latencyCount = std::min(latencyCount + 1, latencies.size());
+
+    // Статистика раз в 60 замеров: nth_element по всему кольцу каждый кадр не нужен
+    if (++samplesSinceUpdate >= 60)
+    {
+        samplesSinceUpdate = 0;
+        UpdateStatistics();
+    }
+}
+
+inline void FramePacer::UpdateStatistics()
+{
+    sorted.assign(latencies.begin(), latencies.begin() + latencyCount);
+    float sum = 0.0f;
+    for (float value : sorted)
+        sum += value;
+    averageLatency = sum / sorted.size();
+
+    const size_t index = std::min(sorted.size() - 1, static_cast<size_t>(0.99f * sorted.size()));
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    p99Latency = sorted[index];
+}
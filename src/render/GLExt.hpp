@@ -0,0 +1,98 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <cstring>
+
+// Константы из GL 4.x / расширений, которых нет в профиле 3.3 core glad
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+#ifndef GL_DYNAMIC_STORAGE_BIT
+#define GL_DYNAMIC_STORAGE_BIT 0x0100
+#endif
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+// Необязательные функции OpenGL, загружаемые вручную после создания контекста.
+// Если функция недоступна, указатель остаётся nullptr и код использует запасной путь.
+class GLExt
+{
+public:
+    typedef void(APIENTRYP BufferStorageProc)(GLenum target, GLsizeiptr size, const void *data, GLbitfield flags);
+    typedef void(APIENTRYP GetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+    typedef void(APIENTRYP ProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+    typedef void(APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+    typedef void(APIENTRYP MaxShaderCompilerThreadsProc)(GLuint count);
+
+    static void Load();
+    static bool HasExtension(const char *name);
+    static bool HasVersion(int major, int minor);
+
+    static inline BufferStorageProc BufferStorage = nullptr;
+    static inline GetProgramBinaryProc GetProgramBinary = nullptr;
+    static inline ProgramBinaryProc ProgramBinary = nullptr;
+    static inline ProgramParameteriProc ProgramParameteri = nullptr;
+
+    // GL_KHR_parallel_shader_compile: компиляция в потоках драйвера и опрос готовности
+    static inline MaxShaderCompilerThreadsProc MaxShaderCompilerThreads = nullptr;
+    static inline bool ParallelShaderCompile = false;
+
+private:
+    static inline bool s_loaded = false;
+};
+
+inline void GLExt::Load()
+{
+    if (s_loaded)
+        return;
+    s_loaded = true;
+
+    if (HasVersion(4, 4) || HasExtension("GL_ARB_buffer_storage"))
+    {
+        BufferStorage = reinterpret_cast<BufferStorageProc>(glfwGetProcAddress("glBufferStorage"));
+    }
+
+    if (HasVersion(4, 1) || HasExtension("GL_ARB_get_program_binary"))
+    {
+        GetProgramBinary = reinterpret_cast<GetProgramBinaryProc>(glfwGetProcAddress("glGetProgramBinary"));
+        ProgramBinary = reinterpret_cast<ProgramBinaryProc>(glfwGetProcAddress("glProgramBinary"));
+        ProgramParameteri = reinterpret_cast<ProgramParameteriProc>(glfwGetProcAddress("glProgramParameteri"));
+    }
+
+    if (HasExtension("GL_KHR_parallel_shader_compile"))
+    {
+        MaxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(glfwGetProcAddress("glMaxShaderCompilerThreadsKHR"));
+        ParallelShaderCompile = MaxShaderCompilerThreads != nullptr;
+    }
+    else if (HasExtension("GL_ARB_parallel_shader_compile"))
+    {
+        MaxShaderCompilerThreads = reinterpret_cast<MaxShaderCompilerThreadsProc>(glfwGetProcAddress("glMaxShaderCompilerThreadsARB"));
+        ParallelShaderCompile = MaxShaderCompilerThreads != nullptr;
+    }
+}
+
+inline bool GLExt::HasExtension(const char *name)
+{
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+    for (GLint i = 0; i < count; ++i)
+    {
+        const char *ext = reinterpret_cast<const char *>(glGetStringi(GL_EXTENSIONS, i));
+        if (ext && std::strcmp(ext, name) == 0)
+            return true;
+    }
+    return false;
+}
+
+inline bool GLExt::HasVersion(int major, int minor)
+{
+    GLint glMajor = 0, glMinor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &glMajor);
+    glGetIntegerv(GL_MINOR_VERSION, &glMinor);
+    return glMajor > major || (glMajor == major && glMinor >= minor);
+}
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "RenderStats.hpp"
+
+// Тонкая прослойка над состоянием OpenGL: помнит привязанные программу, VAO, буферы,
+// текстуры, фреймбуферы и флаги глубины/смешивания и не передаёт драйверу вызов, который
+// ничего не меняет. Выполненные вызовы считаются в RenderStats::stateChanges, пропущенные —
+// в elidedStateChanges.
+// Теневое состояние верно, только пока всё состояние меняется через GLState. После удаления
+// объектов (GL сам отвязывает удалённое) и чужого кода вызывается Invalidate().
+class GLState
+{
+public:
+    static constexpr int kTextureUnits = 8;
+
+    static void UseProgram(GLuint program);
+    static void BindVertexArray(GLuint vao);
+
+    // GL_ELEMENT_ARRAY_BUFFER — часть состояния VAO, его привязка передаётся всегда
+    static void BindBuffer(GLenum target, GLuint buffer);
+    static void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+    static void ActiveTexture(GLenum unit);
+    // Текстура на активном блоке
+    static void BindTexture(GLenum target, GLuint texture);
+
+    static void Enable(GLenum capability) { SetCapability(capability, true); }
+    static void Disable(GLenum capability) { SetCapability(capability, false); }
+    static void DepthFunc(GLenum func);
+    static void DepthMask(GLboolean mask);
+    static void BlendFunc(GLenum source, GLenum destination);
+    static void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+    static void ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a);
+
+    // Всё теневое состояние неизвестно: следующие вызовы уйдут в драйвер
+    static void Invalidate();
+
+private:
+    static constexpr GLuint kUnknown = ~0u;
+    static constexpr GLenum kUnknownEnum = ~0u;
+
+    enum Capability
+    {
+        CapDepthTest,
+        CapBlend,
+        CapScissorTest,
+        CapCullFace,
+        CapCount
+    };
+
+    // 0 — выключено, 1 — включено, -1 — неизвестно
+    static inline signed char s_capabilities[CapCount] = {-1, -1, -1, -1};
+
+    static inline GLuint s_program = kUnknown;
+    static inline GLuint s_vao = kUnknown;
+    static inline GLuint s_arrayBuffer = kUnknown;
+    static inline GLuint s_pixelPackBuffer = kUnknown;
+    static inline GLuint s_drawFramebuffer = kUnknown;
+    static inline GLuint s_readFramebuffer = kUnknown;
+    static inline GLenum s_activeUnit = kUnknownEnum;
+    static inline GLuint s_textures2D[kTextureUnits] = {kUnknown, kUnknown, kUnknown, kUnknown,
+                                                         kUnknown, kUnknown, kUnknown, kUnknown};
+    static inline GLuint s_texturesArray[kTextureUnits] = {kUnknown, kUnknown, kUnknown, kUnknown,
+                                                            kUnknown, kUnknown, kUnknown, kUnknown};
+    static inline GLenum s_depthFunc = kUnknownEnum;
+    static inline int s_depthMask = -1;
+    static inline GLenum s_blendSource = kUnknownEnum;
+    static inline GLenum s_blendDestination = kUnknownEnum;
+    static inline GLint s_viewport[4] = {-1, -1, -1, -1};
+    static inline GLfloat s_clearColor[4] = {-1.0f, -1.0f, -1.0f, -1.0f};
+
+    static void SetCapability(GLenum capability, bool enabled);
+    static int CapabilityIndex(GLenum capability);
+    static GLuint *TextureSlot(GLenum target);
+
+    // true — значение новое, вызов нужно передать драйверу
+    template <typename T>
+    static bool Update(T &shadow, T value);
+    static void Issued() { ++RenderStats::Current().stateChanges; }
+};
+
+template <typename T>
+inline bool GLState::Update(T &shadow, T value)
+{
+    if (shadow == value)
+    {
+        ++RenderStats::Current().elidedStateChanges;
+        return false;
+    }
+    shadow = value;
+    Issued();
+    return true;
+}
+
+inline void GLState::UseProgram(GLuint program)
+{
+    if (Update(s_program, program))
+        glUseProgram(program);
+}
+
+inline void GLState::BindVertexArray(GLuint vao)
+{
+    if (Update(s_vao, vao))
+        glBindVertexArray(vao);
+}
+
+inline void GLState::BindBuffer(GLenum target, GLuint buffer)
+{
+    GLuint *shadow = nullptr;
+    if (target == GL_ARRAY_BUFFER)
+        shadow = &s_arrayBuffer;
+    else if (target == GL_PIXEL_PACK_BUFFER)
+        shadow = &s_pixelPackBuffer;
+
+    if (!shadow)
+    {
+        Issued();
+        glBindBuffer(target, buffer);
+    }
+    else if (Update(*shadow, buffer))
+    {
+        glBindBuffer(target, buffer);
+    }
+}
+
+inline void GLState::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+    if (target == GL_FRAMEBUFFER)
+    {
+        // Привязка к обеим точкам одним вызовом — пропускаем, только если совпадают обе
+        if (s_drawFramebuffer == framebuffer && s_readFramebuffer == framebuffer)
+        {
+            ++RenderStats::Current().elidedStateChanges;
+            return;
+        }
+        s_drawFramebuffer = s_readFramebuffer = framebuffer;
+        Issued();
+        glBindFramebuffer(target, framebuffer);
+        return;
+    }
+
+    GLuint &shadow = target == GL_READ_FRAMEBUFFER ? s_readFramebuffer : s_drawFramebuffer;
+    if (Update(shadow, framebuffer))
+        glBindFramebuffer(target, framebuffer);
+}
+
+inline void GLState::ActiveTexture(GLenum unit)
+{
+    if (Update(s_activeUnit, unit))
+        glActiveTexture(unit);
+}
+
+inline void GLState::BindTexture(GLenum target, GLuint texture)
+{
+    GLuint *slot = TextureSlot(target);
+    if (!slot)
+    {
+        Issued();
+        glBindTexture(target, texture);
+    }
+    else if (Update(*slot, texture))
+    {
+        glBindTexture(target, texture);
+    }
+}
+
+inline void GLState::SetCapability(GLenum capability, bool enabled)
+{
+    const int index = CapabilityIndex(capability);
+    const signed char value = enabled ? 1 : 0;
+    if (index >= 0 && !Update(s_capabilities[index], value))
+        return;
+    if (index < 0)
+        Issued();
+
+    if (enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+}
+
+inline void GLState::DepthFunc(GLenum func)
+{
+    if (Update(s_depthFunc, func))
+        glDepthFunc(func);
+}
+
+inline void GLState::DepthMask(GLboolean mask)
+{
+    if (Update(s_depthMask, mask ? 1 : 0))
+        glDepthMask(mask);
+}
+
+inline void GLState::BlendFunc(GLenum source, GLenum destination)
+{
+    if (s_blendSource == source && s_blendDestination == destination)
+    {
+        ++RenderStats::Current().elidedStateChanges;
+        return;
+    }
+    s_blendSource = source;
+    s_blendDestination = destination;
+    Issued();
+    glBlendFunc(source, destination);
+}
+
+inline void GLState::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+    if (s_viewport[0] == x && s_viewport[1] == y && s_viewport[2] == width && s_viewport[3] == height)
+    {
+        ++RenderStats::Current().elidedStateChanges;
+        return;
+    }
+    s_viewport[0] = x;
+    s_viewport[1] = y;
+    s_viewport[2] = width;
+    s_viewport[3] = height;
+    Issued();
+    glViewport(x, y, width, height);
+}
+
+inline void GLState::ClearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+{
+    if (s_clearColor[0] == r && s_clearColor[1] == g && s_clearColor[2] == b && s_clearColor[3] == a)
+    {
+        ++RenderStats::Current().elidedStateChanges;
+        return;
+    }
+    s_clearColor[0] = r;
+    s_clearColor[1] = g;
+    s_clearColor[2] = b;
+    s_clearColor[3] = a;
+    Issued();
+    glClearColor(r, g, b, a);
+}
+
+inline void GLState::Invalidate()
+{
+    for (signed char &capability : s_capabilities)
+        capability = -1;
+    s_program = s_vao = s_arrayBuffer = s_pixelPackBuffer = kUnknown;
+    s_drawFramebuffer = s_readFramebuffer = kUnknown;
+    s_activeUnit = kUnknownEnum;
+    for (int i = 0; i < kTextureUnits; ++i)
+        s_textures2D[i] = s_texturesArray[i] = kUnknown;
+    s_depthFunc = kUnknownEnum;
+    s_depthMask = -1;
+    s_blendSource = s_blendDestination = kUnknownEnum;
+    for (int i = 0; i < 4; ++i)
+    {
+        s_viewport[i] = -1;
+        s_clearColor[i] = -1.0f;
+    }
+}
+
+inline int GLState::CapabilityIndex(GLenum capability)
+{
+    switch (capability)
+    {
+    case GL_DEPTH_TEST:
+        return CapDepthTest;
+    case GL_BLEND:
+        return CapBlend;
+    case GL_SCISSOR_TEST:
+        return CapScissorTest;
+    case GL_CULL_FACE:
+        return CapCullFace;
+    default:
+        return -1;
+    }
+}
+
+inline GLuint *GLState::TextureSlot(GLenum target)
+{
+    const int unit = static_cast<int>(s_activeUnit - GL_TEXTURE0);
+    // Блок неизвестен (до первого ActiveTexture) или вне таблицы — не кэшируем
+    if (s_activeUnit == kUnknownEnum || unit < 0 || unit >= kTextureUnits)
+        return nullptr;
+    if (target == GL_TEXTURE_2D)
+        return &s_textures2D[unit];
+    if (target == GL_TEXTURE_2D_ARRAY)
+        return &s_texturesArray[unit];
+    return nullptr;
+}
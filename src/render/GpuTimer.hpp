@@ -0,0 +1,107 @@
+#pragma once
+
+#include <glad/glad.h>
+#include "RenderQueue.hpp"
+
+// Таймеры GPU на запросах GL_TIME_ELAPSED. Два набора запросов чередуются по кадрам:
+// результаты прошлого кадра читаются только если уже готовы, поэтому ожидания нет.
+// Проход, который в кадре ничего не рисовал, получает 0, а не время из прежних кадров.
+class GpuTimer
+{
+public:
+    GpuTimer() = default;
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer &) = delete;
+    GpuTimer &operator=(const GpuTimer &) = delete;
+
+    bool Init();
+    void Cleanup();
+
+    void BeginFrame();
+    void Begin(RenderPass pass);
+    void End();
+
+    float GetMilliseconds(RenderPass pass) const { return results[static_cast<int>(pass)]; }
+
+private:
+    GLuint queries[2][kRenderPassCount] = {};
+    bool issued[2][kRenderPassCount] = {}; // Запрос отправлен, результат ещё не прочитан
+    bool ran[2][kRenderPassCount] = {};    // Проход был в кадре, использовавшем набор
+    float results[kRenderPassCount] = {};
+    int current = 0;
+    int active = -1;
+};
+
+inline GpuTimer::~GpuTimer()
+{
+    Cleanup();
+}
+
+inline bool GpuTimer::Init()
+{
+    glGenQueries(2 * kRenderPassCount, &queries[0][0]);
+    return queries[0][0] != 0;
+}
+
+inline void GpuTimer::Cleanup()
+{
+    if (queries[0][0])
+    {
+        glDeleteQueries(2 * kRenderPassCount, &queries[0][0]);
+        queries[0][0] = 0;
+    }
+}
+
+inline void GpuTimer::BeginFrame()
+{
+    current ^= 1;
+
+    // Забираем результаты кадра, использовавшего этот набор, если GPU их уже посчитал
+    for (int pass = 0; pass < kRenderPassCount; ++pass)
+    {
+        const bool passRan = ran[current][pass];
+        ran[current][pass] = false;
+        if (!passRan)
+            results[pass] = 0.0f;
+
+        if (!issued[current][pass])
+            continue;
+
+        GLint available = 0;
+        glGetQueryObjectiv(queries[current][pass], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(queries[current][pass], GL_QUERY_RESULT, &nanoseconds);
+        issued[current][pass] = false;
+        // Запрос из более раннего кадра, а в том кадре проход не рисовал — остаётся 0
+        if (passRan)
+            results[pass] = static_cast<float>(nanoseconds) / 1.0e6f;
+    }
+}
+
+inline void GpuTimer::Begin(RenderPass pass)
+{
+    End();
+
+    const int index = static_cast<int>(pass);
+    ran[current][index] = true;
+    // Результат прошлого использования ещё не готов — пропускаем замер, чтобы не ждать
+    if (issued[current][index])
+        return;
+
+    glBeginQuery(GL_TIME_ELAPSED, queries[current][index]);
+    issued[current][index] = true;
+    active = index;
+}
+
+inline void GpuTimer::End()
+{
+    if (active < 0)
+        return;
+
+    glEndQuery(GL_TIME_ELAPSED);
+    active = -1;
+}
@@ -0,0 +1,349 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "GLState.hpp"
+#include "VertexFormat.hpp"
+
+// Статические меши сцены
+enum class MeshId : uint8_t
+{
+    SphereLod0, // Уровни детализации шара, от подробного к грубому
+    SphereLod1,
+    SphereLod2,
+    SphereLod3,
+    Cylinder, // Радиус 1, от y = 0 до y = 1
+    Disc,     // Радиус 1 в плоскости XZ, нормаль +Y
+    Box,      // Куб со стороной 1
+    Quad,     // Квадрат 1x1 в плоскости XZ
+    Count
+};
+
+constexpr int kMeshCount = static_cast<int>(MeshId::Count);
+constexpr int kSphereLodCount = 4;
+
+// Диапазон меша в общих буферах: индексы локальные, смещение вершин — baseVertex
+struct MeshRange
+{
+    GLint firstIndex = 0;
+    GLsizei indexCount = 0;
+    GLint baseVertex = 0;
+};
+
+// Все статические меши в одном VBO/EBO с одним VAO (позиция, нормаль, UV).
+// Рисуются через glDrawElementsBaseVertex, поэтому между мешами VAO не переключается.
+// Меши строятся во float и при загрузке упаковываются в PackedVertex; индексы 16-битные,
+// если каждый меш укладывается в 65536 вершин (индексы локальные, baseVertex у каждого свой).
+class MeshRegistry
+{
+public:
+    MeshRegistry() = default;
+    ~MeshRegistry() { Cleanup(); }
+
+    MeshRegistry(const MeshRegistry &) = delete;
+    MeshRegistry &operator=(const MeshRegistry &) = delete;
+
+    bool Init();
+    void Cleanup();
+
+    GLuint GetVAO() const { return vao; }
+
+    // Тип индексов в общем EBO и смещение первого индекса меша для glDraw*
+    GLenum IndexType() const { return indexType; }
+    const void *IndexOffset(GLint firstIndex) const
+    {
+        const size_t size = indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+        return (const void *)(static_cast<size_t>(firstIndex) * size);
+    }
+
+    // Подключает общие буферы и атрибуты 0–2 к текущему VAO (для VAO с дополнительными атрибутами)
+    void BindAttributes() const;
+    const MeshRange &Get(MeshId id) const { return ranges[static_cast<int>(id)]; }
+
+    // Уровень детализации шара по радиусу его проекции на экран в пикселях
+    static MeshId SphereLod(float projectedRadiusPx);
+
+private:
+    // Вершина при построении меша; в GPU уходит PackedVertex
+    struct Vertex
+    {
+        glm::vec3 position;
+        glm::vec3 normal;
+        glm::vec2 uv;
+    };
+
+    GLuint vao = 0, vbo = 0, ebo = 0;
+    MeshRange ranges[kMeshCount];
+    PositionFormat positionFormat = PositionFormat::Snorm16;
+    GLenum indexType = GL_UNSIGNED_INT;
+
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+
+    void BeginMesh(MeshId id);
+    void EndMesh(MeshId id);
+
+    void AddSphere(MeshId id, unsigned int xSegments, unsigned int ySegments);
+    void AddCylinder(unsigned int segments);
+    void AddDisc(unsigned int segments);
+    void AddBox();
+    void AddQuad();
+};
+
+inline MeshId MeshRegistry::SphereLod(float projectedRadiusPx)
+{
+    if (projectedRadiusPx > 48.0f)
+        return MeshId::SphereLod0;
+    if (projectedRadiusPx > 16.0f)
+        return MeshId::SphereLod1;
+    if (projectedRadiusPx > 6.0f)
+        return MeshId::SphereLod2;
+    return MeshId::SphereLod3;
+}
+
+inline bool MeshRegistry::Init()
+{
+    vertices.clear();
+    indices.clear();
+
+    AddSphere(MeshId::SphereLod0, 32, 24);
+    AddSphere(MeshId::SphereLod1, 16, 12);
+    AddSphere(MeshId::SphereLod2, 10, 8);
+    AddSphere(MeshId::SphereLod3, 6, 4);
+    AddCylinder(16);
+    AddDisc(64);
+    AddBox();
+    AddQuad();
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+    glGenBuffers(1, &ebo);
+
+    // Все меши единичного размера — позиции в snorm16; иначе half
+    float maxCoordinate = 0.0f;
+    for (const Vertex &vertex : vertices)
+    {
+        const glm::vec3 extent = glm::abs(vertex.position);
+        maxCoordinate = std::max({maxCoordinate, extent.x, extent.y, extent.z});
+    }
+    positionFormat = VertexFormat::ChoosePositionFormat(maxCoordinate);
+
+    std::vector<PackedVertex> packed;
+    packed.reserve(vertices.size());
+    for (const Vertex &vertex : vertices)
+        packed.push_back(VertexFormat::Pack(vertex.position, vertex.normal, vertex.uv, positionFormat));
+
+    uint32_t maxIndex = 0;
+    for (uint32_t index : indices)
+        maxIndex = std::max(maxIndex, index);
+    indexType = maxIndex <= 0xFFFF ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, packed.size() * sizeof(PackedVertex), packed.data(), GL_STATIC_DRAW);
+
+    GLState::BindVertexArray(vao);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    size_t indexBytes = 0;
+    if (indexType == GL_UNSIGNED_SHORT)
+    {
+        const std::vector<uint16_t> shortIndices(indices.begin(), indices.end());
+        indexBytes = shortIndices.size() * sizeof(uint16_t);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, shortIndices.data(), GL_STATIC_DRAW);
+    }
+    else
+    {
+        indexBytes = indices.size() * sizeof(uint32_t);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indices.data(), GL_STATIC_DRAW);
+    }
+    BindAttributes();
+
+    const size_t bytes = packed.size() * sizeof(PackedVertex) + indexBytes;
+    const size_t floatBytes = vertices.size() * sizeof(Vertex) + indices.size() * sizeof(uint32_t);
+    std::cout << "[Meshes] " << vertices.size() << " vertices, " << indices.size() << " indices in "
+              << bytes / 1024.0f << " KB (" << floatBytes / 1024.0f << " KB unpacked), "
+              << VertexFormat::Name(positionFormat) << " positions, "
+              << (indexType == GL_UNSIGNED_SHORT ? 16 : 32) << "-bit indices" << std::endl;
+
+    // Данные уже в GPU
+    vertices = std::vector<Vertex>();
+    indices = std::vector<uint32_t>();
+    return true;
+}
+
+inline void MeshRegistry::BindAttributes() const
+{
+    GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+    GLState::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+    VertexFormat::BindAttributes(positionFormat);
+}
+
+inline void MeshRegistry::Cleanup()
+{
+    if (vao)
+    {
+        glDeleteVertexArrays(1, &vao);
+        glDeleteBuffers(1, &vbo);
+        glDeleteBuffers(1, &ebo);
+        GLState::Invalidate();
+    }
+    vao = vbo = ebo = 0;
+}
+
+inline void MeshRegistry::BeginMesh(MeshId id)
+{
+    MeshRange &range = ranges[static_cast<int>(id)];
+    range.firstIndex = static_cast<GLint>(indices.size());
+    range.baseVertex = static_cast<GLint>(vertices.size());
+}
+
+inline void MeshRegistry::EndMesh(MeshId id)
+{
+    MeshRange &range = ranges[static_cast<int>(id)];
+    range.indexCount = static_cast<GLsizei>(indices.size()) - range.firstIndex;
+}
+
+inline void MeshRegistry::AddSphere(MeshId id, unsigned int xSegments, unsigned int ySegments)
+{
+    BeginMesh(id);
+
+    for (unsigned int y = 0; y <= ySegments; ++y)
+    {
+        for (unsigned int x = 0; x <= xSegments; ++x)
+        {
+            float xSegment = (float)x / xSegments;
+            float ySegment = (float)y / ySegments;
+            float xPos = std::cos(xSegment * glm::two_pi<float>()) * std::sin(ySegment * glm::pi<float>());
+            float yPos = std::cos(ySegment * glm::pi<float>());
+            float zPos = std::sin(xSegment * glm::two_pi<float>()) * std::sin(ySegment * glm::pi<float>());
+
+            // Нормаль совпадает с позицией на единичной сфере
+            glm::vec3 position(xPos, yPos, zPos);
+            vertices.push_back({position, position, glm::vec2(1.0f - xSegment, ySegment)});
+        }
+    }
+
+    for (unsigned int y = 0; y < ySegments; ++y)
+    {
+        for (unsigned int x = 0; x < xSegments; ++x)
+        {
+            uint32_t first = y * (xSegments + 1) + x;
+            uint32_t second = first + xSegments + 1;
+
+            indices.insert(indices.end(), {first, second, first + 1, second, second + 1, first + 1});
+        }
+    }
+
+    EndMesh(id);
+}
+
+inline void MeshRegistry::AddCylinder(unsigned int segments)
+{
+    BeginMesh(MeshId::Cylinder);
+
+    // Боковая поверхность
+    for (unsigned int i = 0; i <= segments; ++i)
+    {
+        float u = (float)i / segments;
+        float angle = u * glm::two_pi<float>();
+        glm::vec3 normal(std::cos(angle), 0.0f, std::sin(angle));
+        vertices.push_back({normal, normal, glm::vec2(u, 0.0f)});
+        vertices.push_back({normal + glm::vec3(0.0f, 1.0f, 0.0f), normal, glm::vec2(u, 1.0f)});
+    }
+    for (uint32_t i = 0; i < segments; ++i)
+    {
+        uint32_t bottom = i * 2;
+        indices.insert(indices.end(), {bottom, bottom + 1, bottom + 2, bottom + 1, bottom + 3, bottom + 2});
+    }
+
+    // Торцы: центр и кольцо для каждого
+    for (int cap = 0; cap < 2; ++cap)
+    {
+        const float y = static_cast<float>(cap);
+        const glm::vec3 normal(0.0f, cap ? 1.0f : -1.0f, 0.0f);
+        const uint32_t center = static_cast<uint32_t>(vertices.size()) - ranges[static_cast<int>(MeshId::Cylinder)].baseVertex;
+        vertices.push_back({glm::vec3(0.0f, y, 0.0f), normal, glm::vec2(0.5f)});
+        for (unsigned int i = 0; i <= segments; ++i)
+        {
+            float angle = (float)i / segments * glm::two_pi<float>();
+            vertices.push_back({glm::vec3(std::cos(angle), y, std::sin(angle)), normal,
+                                glm::vec2(0.5f + 0.5f * std::cos(angle), 0.5f + 0.5f * std::sin(angle))});
+        }
+        for (uint32_t i = 0; i < segments; ++i)
+        {
+            indices.insert(indices.end(), {center, center + 1 + i, center + 2 + i});
+        }
+    }
+
+    EndMesh(MeshId::Cylinder);
+}
+
+inline void MeshRegistry::AddDisc(unsigned int segments)
+{
+    BeginMesh(MeshId::Disc);
+
+    const glm::vec3 normal(0.0f, 1.0f, 0.0f);
+    vertices.push_back({glm::vec3(0.0f), normal, glm::vec2(0.5f)});
+    for (unsigned int i = 0; i <= segments; ++i)
+    {
+        float angle = (float)i / segments * glm::two_pi<float>();
+        vertices.push_back({glm::vec3(std::cos(angle), 0.0f, std::sin(angle)), normal,
+                            glm::vec2(0.5f + 0.5f * std::cos(angle), 0.5f + 0.5f * std::sin(angle))});
+    }
+    for (uint32_t i = 0; i < segments; ++i)
+    {
+        indices.insert(indices.end(), {0u, i + 1, i + 2});
+    }
+
+    EndMesh(MeshId::Disc);
+}
+
+inline void MeshRegistry::AddBox()
+{
+    BeginMesh(MeshId::Box);
+
+    // 6 граней по 4 вершины: нормаль грани и два вектора в её плоскости
+    const glm::vec3 faces[6][3] = {
+        {{0, 0, 1}, {1, 0, 0}, {0, 1, 0}},   // передняя
+        {{0, 0, -1}, {-1, 0, 0}, {0, 1, 0}}, // задняя
+        {{0, 1, 0}, {1, 0, 0}, {0, 0, -1}},  // верхняя
+        {{0, -1, 0}, {1, 0, 0}, {0, 0, 1}},  // нижняя
+        {{1, 0, 0}, {0, 0, -1}, {0, 1, 0}},  // правая
+        {{-1, 0, 0}, {0, 0, 1}, {0, 1, 0}},  // левая
+    };
+    const glm::vec2 corners[4] = {{-0.5f, -0.5f}, {0.5f, -0.5f}, {0.5f, 0.5f}, {-0.5f, 0.5f}};
+
+    for (uint32_t face = 0; face < 6; ++face)
+    {
+        const glm::vec3 &normal = faces[face][0];
+        for (const glm::vec2 &corner : corners)
+        {
+            glm::vec3 position = normal * 0.5f + faces[face][1] * corner.x + faces[face][2] * corner.y;
+            vertices.push_back({position, normal, corner + glm::vec2(0.5f)});
+        }
+        uint32_t first = face * 4;
+        indices.insert(indices.end(), {first, first + 1, first + 2, first + 2, first + 3, first});
+    }
+
+    EndMesh(MeshId::Box);
+}
+
+inline void MeshRegistry::AddQuad()
+{
+    BeginMesh(MeshId::Quad);
+
+    const glm::vec3 normal(0.0f, 1.0f, 0.0f);
+    vertices.push_back({glm::vec3(-0.5f, 0.0f, -0.5f), normal, glm::vec2(0.0f, 0.0f)});
+    vertices.push_back({glm::vec3(0.5f, 0.0f, -0.5f), normal, glm::vec2(1.0f, 0.0f)});
+    vertices.push_back({glm::vec3(0.5f, 0.0f, 0.5f), normal, glm::vec2(1.0f, 1.0f)});
+    vertices.push_back({glm::vec3(-0.5f, 0.0f, 0.5f), normal, glm::vec2(0.0f, 1.0f)});
+    indices.insert(indices.end(), {0u, 1u, 2u, 2u, 3u, 0u});
+
+    EndMesh(MeshId::Quad);
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "GLExt.hpp"
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+// Дисковый кэш слинкованных программ (glGetProgramBinary / glProgramBinary).
+// Ключ — хэш строк производителя, рендерера и версии драйвера вместе с исходниками шейдеров,
+// поэтому обновление драйвера или шейдеров просто даёт промах и перекомпиляцию.
+class ProgramCache
+{
+public:
+    struct Stats
+    {
+        int hits = 0;
+        int misses = 0;
+    };
+
+    static uint64_t Key(const char *vertexSource, const char *fragmentSource);
+
+    // Пытается загрузить программу из кэша; false — нужно компилировать
+    static bool Load(GLuint program, uint64_t key);
+
+    // Вызывается до glLinkProgram, чтобы драйвер сохранил бинарник
+    static void PrepareForRetrieval(GLuint program);
+    static void Store(GLuint program, uint64_t key);
+
+    static const Stats &GetStats() { return Counters(); }
+
+    static inline std::string directory = "cache/shaders";
+
+private:
+    struct FileHeader
+    {
+        char magic[4];
+        uint32_t format;
+        uint32_t length;
+        uint32_t reserved;
+        uint64_t key;
+    };
+
+    static Stats &Counters()
+    {
+        static Stats stats;
+        return stats;
+    }
+
+    static bool Supported();
+    static std::string PathFor(uint64_t key);
+    static uint64_t Hash(uint64_t hash, const char *text);
+};
+
+inline uint64_t ProgramCache::Hash(uint64_t hash, const char *text)
+{
+    // FNV-1a 64, нулевой байт-разделитель между строками
+    for (const char *c = text ? text : ""; ; ++c)
+    {
+        hash ^= static_cast<uint8_t>(*c);
+        hash *= 1099511628211ull;
+        if (*c == '\0')
+            break;
+    }
+    return hash;
+}
+
+inline uint64_t ProgramCache::Key(const char *vertexSource, const char *fragmentSource)
+{
+    uint64_t hash = 14695981039346656037ull;
+    hash = Hash(hash, reinterpret_cast<const char *>(glGetString(GL_VENDOR)));
+    hash = Hash(hash, reinterpret_cast<const char *>(glGetString(GL_RENDERER)));
+    hash = Hash(hash, reinterpret_cast<const char *>(glGetString(GL_VERSION)));
+    hash = Hash(hash, vertexSource);
+    hash = Hash(hash, fragmentSource);
+    return hash;
+}
+
+inline bool ProgramCache::Supported()
+{
+    if (!GLExt::GetProgramBinary || !GLExt::ProgramBinary || !GLExt::ProgramParameteri)
+        return false;
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    return formats > 0;
+}
+
+inline std::string ProgramCache::PathFor(uint64_t key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return directory + "/" + name;
+}
+
+inline bool ProgramCache::Load(GLuint program, uint64_t key)
+{
+    if (!Supported())
+    {
+        ++Counters().misses;
+        return false;
+    }
+
+    // Длина из заголовка сверяется с размером файла до выделения памяти: испорченный или чужой
+    // файл иначе мог бы запросить до 4 ГБ
+    const std::string path = PathFor(key);
+    std::error_code error;
+    const uintmax_t fileSize = std::filesystem::file_size(path, error);
+    std::ifstream file(path, std::ios::binary);
+    FileHeader header;
+    if (error || !file.read(reinterpret_cast<char *>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, "BPGB", 4) != 0 || header.key != key || header.length == 0 ||
+        header.length != fileSize - sizeof(header))
+    {
+        ++Counters().misses;
+        return false;
+    }
+
+    std::vector<char> binary(header.length);
+    if (!file.read(binary.data(), binary.size()))
+    {
+        ++Counters().misses;
+        return false;
+    }
+
+    GLExt::ProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+
+    // Драйвер вправе отвергнуть бинарник (например, после обновления) — тогда компилируем заново
+    GLint success = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success)
+    {
+        ++Counters().misses;
+        return false;
+    }
+
+    ++Counters().hits;
+    return true;
+}
+
+inline void ProgramCache::PrepareForRetrieval(GLuint program)
+{
+    if (Supported())
+        GLExt::ProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+inline void ProgramCache::Store(GLuint program, uint64_t key)
+{
+    if (!Supported())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    GLsizei written = 0;
+    GLExt::GetProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0)
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    // Запись во временный файл и переименование: прерванная запись не оставляет обрезанный кэш
+    const std::string path = PathFor(key);
+    const std::string tempPath = path + ".tmp";
+    FileHeader header = {{'B', 'P', 'G', 'B'}, format, static_cast<uint32_t>(written), 0, key};
+    std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(binary.data(), written);
+    file.close();
+
+    if (file)
+        std::filesystem::rename(tempPath, path, error);
+    if (!file || error)
+        std::filesystem::remove(tempPath, error);
+}
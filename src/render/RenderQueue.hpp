@@ -0,0 +1,185 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Проходы кадра: старшие биты ключа сортировки, отдельные замеры времени GPU
+enum class RenderPass : uint8_t
+{
+    Scene,
+    Balls,
+    Cue,
+    Aim,
+    Count
+};
+
+constexpr int kRenderPassCount = static_cast<int>(RenderPass::Count);
+
+inline const char *RenderPassName(RenderPass pass)
+{
+    switch (pass)
+    {
+    case RenderPass::Scene:
+        return "scene";
+    case RenderPass::Balls:
+        return "balls";
+    case RenderPass::Cue:
+        return "cue";
+    case RenderPass::Aim:
+        return "aim";
+    default:
+        return "?";
+    }
+}
+
+// Команда отрисовки: что рисовать (VAO, диапазон), чем (программа, текстура) и где (матрица).
+struct DrawCommand
+{
+    RenderPass pass = RenderPass::Scene;
+    GLuint program = 0;
+    GLuint texture = 0; // 0 — заливка цветом uColor
+    GLuint vao = 0;
+
+    GLenum mode = GL_TRIANGLES;
+    GLint first = 0;
+    GLsizei count = 0;
+    GLint baseVertex = 0; // Смещение вершин меша в общем буфере
+    bool indexed = true;  // glDrawElementsBaseVertex (индексы MeshRegistry) или glDrawArrays
+
+    glm::mat4 model = glm::mat4(1.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+
+    // Ограничивающая сфера в мировых координатах
+    glm::vec3 boundsCenter = glm::vec3(0.0f);
+    float boundsRadius = 0.0f;
+
+    uint64_t key = 0;
+};
+
+// Пирамида видимости, извлечённая из матрицы projection * view (метод Gribb–Hartmann)
+class Frustum
+{
+public:
+    void Extract(const glm::mat4 &viewProjection);
+    bool IntersectsSphere(const glm::vec3 &center, float radius) const;
+
+private:
+    glm::vec4 planes[6];
+};
+
+// Очередь отрисовки кадра: отсекает невидимое, сортирует по 64-битному ключу
+// (проход, программа, текстура, VAO, глубина), чтобы исполнять команды с минимумом смен состояния.
+class RenderQueue
+{
+public:
+    struct Stats
+    {
+        size_t submitted = 0;
+        size_t culled = 0;
+    };
+
+    void Begin(const glm::mat4 &view, const glm::mat4 &projection);
+    void Submit(DrawCommand command);
+    void Sort();
+    void Clear();
+
+    const std::vector<DrawCommand> &Commands() const { return commands; }
+    const Stats &GetStats() const { return stats; }
+
+    const glm::mat4 &GetView() const { return view; }
+    const glm::mat4 &GetProjection() const { return projection; }
+
+private:
+    std::vector<DrawCommand> commands;
+    Stats stats;
+
+    glm::mat4 view = glm::mat4(1.0f);
+    glm::mat4 projection = glm::mat4(1.0f);
+    Frustum frustum;
+
+    static uint64_t MakeKey(const DrawCommand &command, float viewDepth);
+};
+
+inline void Frustum::Extract(const glm::mat4 &m)
+{
+    // glm хранит матрицы по столбцам: строка i — (m[0][i], m[1][i], m[2][i], m[3][i])
+    const glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[0] = row3 + row0; // левая
+    planes[1] = row3 - row0; // правая
+    planes[2] = row3 + row1; // нижняя
+    planes[3] = row3 - row1; // верхняя
+    planes[4] = row3 + row2; // ближняя
+    planes[5] = row3 - row2; // дальняя
+
+    for (auto &plane : planes)
+    {
+        plane /= glm::length(glm::vec3(plane));
+    }
+}
+
+inline bool Frustum::IntersectsSphere(const glm::vec3 &center, float radius) const
+{
+    for (const auto &plane : planes)
+    {
+        if (glm::dot(glm::vec3(plane), center) + plane.w < -radius)
+            return false;
+    }
+    return true;
+}
+
+inline void RenderQueue::Begin(const glm::mat4 &viewMatrix, const glm::mat4 &projectionMatrix)
+{
+    view = viewMatrix;
+    projection = projectionMatrix;
+    frustum.Extract(projection * view);
+    Clear();
+}
+
+inline void RenderQueue::Submit(DrawCommand command)
+{
+    ++stats.submitted;
+
+    if (!frustum.IntersectsSphere(command.boundsCenter, command.boundsRadius))
+    {
+        ++stats.culled;
+        return;
+    }
+
+    const float viewDepth = -(view * glm::vec4(command.boundsCenter, 1.0f)).z;
+    command.key = MakeKey(command, viewDepth);
+    commands.push_back(command);
+}
+
+inline void RenderQueue::Sort()
+{
+    std::sort(commands.begin(), commands.end(),
+              [](const DrawCommand &a, const DrawCommand &b)
+              { return a.key < b.key; });
+}
+
+inline void RenderQueue::Clear()
+{
+    commands.clear();
+    stats = Stats();
+}
+
+inline uint64_t RenderQueue::MakeKey(const DrawCommand &command, float viewDepth)
+{
+    // [63..60] проход | [59..52] программа | [51..36] текстура | [35..20] VAO | [19..0] глубина (спереди назад)
+    const float farPlane = 100.0f;
+    const float normalized = std::clamp(viewDepth / farPlane, 0.0f, 1.0f);
+    const uint64_t depth = static_cast<uint64_t>(normalized * 0xFFFFF);
+
+    return (static_cast<uint64_t>(command.pass) << 60) |
+           (static_cast<uint64_t>(command.program & 0xFF) << 52) |
+           (static_cast<uint64_t>(command.texture & 0xFFFF) << 36) |
+           (static_cast<uint64_t>(command.vao & 0xFFFF) << 20) |
+           depth;
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+// Счётчики обращений к драйверу за кадр
+struct RenderStats
+{
+    unsigned drawCalls = 0;
+    unsigned stateChanges = 0;   // Смены программы, VAO, текстур, буферов, флагов (GLState)
+    unsigned elidedStateChanges = 0; // Избыточные смены, не переданные драйверу
+    unsigned uniformUploads = 0; // Вызовы glUniform*
+    unsigned bufferUploads = 0;  // Загрузки данных в буферы
+
+    // Счётчики текущего (ещё не завершённого) кадра
+    static RenderStats &Current()
+    {
+        static RenderStats stats;
+        return stats;
+    }
+};
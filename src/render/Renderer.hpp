@@ -1,14 +1,7 @@
 #pragma once
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-
 #include <cmath>
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glad/glad.h>
 #include <glm/glm.hpp>
@@ -17,8 +10,20 @@
 #include <vector>
 #include <iostream>
 #include <map>
+#include <algorithm>
+#include <chrono>
 #include <string>
-#include "Shader.hpp"
+#include "ShaderLibrary.hpp"
+#include "GLExt.hpp"
+#include "GLState.hpp"
+#include "StreamBuffer.hpp"
+#include "RenderQueue.hpp"
+#include "RenderStats.hpp"
+#include "GpuTimer.hpp"
+#include "DebugOverlay.hpp"
+#include "TextureCache.hpp"
+#include "MeshRegistry.hpp"
+#include <core/Tracer.hpp>
 
 class Renderer
 {
@@ -28,54 +33,69 @@ public:
 
     bool Init();
 
-    void DrawLine(const glm::vec3 &start, const glm::vec3 &end, const glm::vec3 &color,
-                  const glm::mat4 &view, const glm::mat4 &projection);
+    void DrawLine(const glm::vec3 &start, const glm::vec3 &end, const glm::vec3 &color);
+
+    // Пакетная отрисовка отрезков: каждая пара точек — отдельная линия
+    void DrawLines(const glm::vec3 *points, size_t pointCount, const glm::vec3 &color);
 
     void DrawBall(const glm::vec3 &position, float radius, const glm::vec3 &color,
-                  const glm::mat4 &view, const glm::mat4 &projection,
                   const glm::quat &rotation, int ballNumber = -1);
 
-    void DrawTable(const glm::vec3 &position, const glm::vec2 &size, const glm::vec3 &color,
-                   const glm::mat4 &view, const glm::mat4 &projection);
+    void DrawTable(const glm::vec3 &position, const glm::vec2 &size, const glm::vec3 &color);
 
-    void DrawPocket(const glm::vec3 &position, float radius,
-                    const glm::mat4 &view, const glm::mat4 &projection);
+    void DrawPocket(const glm::vec3 &position, float radius);
 
-    void DrawBox(const glm::vec3 &position, const glm::vec3 &size, const glm::vec3 &color,
-                 const glm::mat4 &view, const glm::mat4 &projection);
+    void DrawBox(const glm::vec3 &position, const glm::vec3 &size, const glm::vec3 &color);
 
-    void DrawCue(const glm::vec3 &start, const glm::vec3 &end, float radius, const glm::vec3 &color,
-                 const glm::mat4 &view, const glm::mat4 &projection);
+    void DrawCue(const glm::vec3 &start, const glm::vec3 &end, float radius, const glm::vec3 &color);
 
     void SetCameraPos(const glm::vec3 &pos) { cameraPos = pos; }
 
-    void InitCube();
-
     bool LoadTextures(); // Метод для загрузки текстур
 
-    void Renderer::PrepareFrame();
+    // Начало кадра: матрицы камеры для очереди отрисовки и отсечения
+    void PrepareFrame(const glm::mat4 &view, const glm::mat4 &projection);
+
+    // Исполнение накопленных команд кадра
+    void Flush();
+
+    const RenderQueue::Stats &GetQueueStats() const { return queue.GetStats(); }
+
+    // Проход, к которому относятся следующие команды (для замеров GPU)
+    void SetPass(RenderPass pass) { currentPass = pass; }
 
-    void ResetMaterialStates();
+    // Счётчики текущего кадра на момент Flush (без оверлея) и время проходов на GPU
+    const RenderStats &GetFrameStats() const { return frameStats; }
+    float GetGpuMilliseconds(RenderPass pass) const { return gpuTimer.GetMilliseconds(pass); }
 
-    Shader &GetShader();
+    DebugOverlay &GetOverlay() { return overlay; }
+    const MeshRegistry &GetMeshes() const { return meshes; }
+    const ShaderLibrary &GetShaders() const { return shaders; }
+    void DrawOverlay(int screenWidth, int screenHeight) { overlay.Draw(screenWidth, screenHeight); }
 
 private:
     glm::vec3 cameraPos;
-    Shader shader;
+    ShaderLibrary shaders;
 
-    GLuint sphereVAO = 0, sphereVBO = 0, sphereEBO = 0;
-    GLuint quadVAO = 0, quadVBO = 0, quadEBO = 0;
-    GLuint cubeVAO = 0, cubeVBO = 0, cubeEBO = 0;
+    MeshRegistry meshes;       // Статические меши в общих буферах
+    StreamBuffer streamBuffer; // Динамическая геометрия без создания GL-объектов в кадре
+    RenderQueue queue;
+    RenderPass currentPass = RenderPass::Scene;
 
-    GLuint cueVAO = 0, cueVBO = 0, cueEBO = 0;
+    GpuTimer gpuTimer;
+    RenderStats frameStats;
+    DebugOverlay overlay;
 
     std::map<int, GLuint> ballTextures; // Карта текстур шаров (ключ - номер шара)
+    TextureCache textureCache{"cache/textures.bin"};
 
-    unsigned int indexCount = 0;
+    float viewportHeight = 720.0f;
 
-    void CreateSphere();
-    void CreateQuad();
-    void CreateCue();
+    void SubmitMesh(MeshId mesh, const glm::mat4 &model, const glm::vec3 &color, GLuint texture,
+                    const glm::vec3 &boundsCenter, float boundsRadius);
+
+    // Радиус проекции сферы на экран в пикселях (для выбора LOD)
+    float ProjectedRadius(const glm::vec3 &center, float radius) const;
 
     void Cleanup();
 };
@@ -91,421 +111,248 @@ Renderer::~Renderer()
 
 bool Renderer::Init()
 {
-    if (!shader.Init())
+    GLExt::Load();
+
+    // Варианты шейдеров собираются драйвером, пока создаются буферы
+    if (!shaders.Begin())
     {
-        std::cerr << "Failed to initialize shader\n";
+        std::cerr << "Failed to initialize shaders\n";
         return false;
     }
 
-    CreateSphere();
-    CreateQuad();
-    CreateCue();
-    InitCube();
-
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glDisable(GL_BLEND);
-
-    return true;
-}
-
-void Renderer::DrawLine(const glm::vec3 &start, const glm::vec3 &end, const glm::vec3 &color,
-                        const glm::mat4 &view, const glm::mat4 &projection)
-{
-
-    shader.Use(); // Заменяем simpleShader на shader
-    glm::mat4 model = glm::mat4(1.0f);
-    glm::mat4 mvp = projection * view * model;
-    shader.SetMat4("uModel", model); // Используем shader вместо simpleShader
-    shader.SetMat4("uView", view);
-    shader.SetMat4("uProjection", projection);
-    shader.SetVec3("uColor", color);
-
-    float vertices[] = {
-        start.x, start.y, start.z,
-        end.x, end.y, end.z};
-
-    GLuint VAO, VBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
-    glEnableVertexAttribArray(0);
-
-    glDrawArrays(GL_LINES, 0, 2);
-
-    glDeleteBuffers(1, &VBO);
-    glDeleteVertexArrays(1, &VAO);
-}
-
-void Renderer::CreateSphere()
-{
-
-    if (sphereVAO == 0)
+    if (!meshes.Init())
     {
-        glGenVertexArrays(1, &sphereVAO);
-        glGenBuffers(1, &sphereVBO);
-        glGenBuffers(1, &sphereEBO);
+        std::cerr << "Failed to initialize meshes\n";
+        return false;
     }
-    const unsigned int X_SEGMENTS = 16;
-    const unsigned int Y_SEGMENTS = 16;
-    std::vector<float> vertices;
 
-    for (unsigned int y = 0; y <= Y_SEGMENTS; ++y)
+    if (!streamBuffer.Init())
     {
-        for (unsigned int x = 0; x <= X_SEGMENTS; ++x)
-        {
-            float xSegment = (float)x / X_SEGMENTS;
-            float ySegment = (float)y / Y_SEGMENTS;
-            float xPos = std::cos(xSegment * 2.0f * M_PI) * std::sin(ySegment * M_PI);
-            float yPos = std::cos(ySegment * M_PI);
-            float zPos = std::sin(xSegment * 2.0f * M_PI) * std::sin(ySegment * M_PI);
-
-            // Позиция
-            vertices.push_back(xPos);
-            vertices.push_back(yPos);
-            vertices.push_back(zPos);
-
-            // Нормаль (направление от центра — совпадает с позицией)
-            vertices.push_back(xPos);
-            vertices.push_back(yPos);
-            vertices.push_back(zPos);
-
-            // Текстурные координаты (u, v)
-            float u = 1.0f - xSegment;
-            float v = ySegment;
-            vertices.push_back(u);
-            vertices.push_back(v);
-        }
+        std::cerr << "Failed to initialize stream buffer\n";
+        return false;
     }
 
-    std::vector<unsigned int> indices;
-    for (unsigned int y = 0; y < Y_SEGMENTS; ++y)
+    if (!gpuTimer.Init() || !overlay.Init())
     {
-        for (unsigned int x = 0; x < X_SEGMENTS; ++x)
-        {
-            unsigned int first = y * (X_SEGMENTS + 1) + x;
-            unsigned int second = first + X_SEGMENTS + 1;
-
-            indices.push_back(first);
-            indices.push_back(second);
-            indices.push_back(first + 1);
-
-            indices.push_back(second);
-            indices.push_back(second + 1);
-            indices.push_back(first + 1);
-        }
+        std::cerr << "Failed to initialize profiling overlay\n";
+        return false;
     }
 
-    indexCount = static_cast<unsigned int>(indices.size());
-
-    glBindVertexArray(sphereVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, sphereVBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, sphereEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-    // Позиция
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)0);
-
-    // Нормаль
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(3 * sizeof(float)));
+    if (!shaders.Finish())
+    {
+        std::cerr << "Failed to initialize shaders\n";
+        return false;
+    }
 
-    // Текстурные координаты
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(6 * sizeof(float)));
+    GLState::Enable(GL_DEPTH_TEST);
+    GLState::DepthFunc(GL_LESS);
+    GLState::Disable(GL_BLEND);
 
-    glBindVertexArray(0);
+    return true;
 }
 
-void Renderer::CreateQuad()
+void Renderer::DrawLine(const glm::vec3 &start, const glm::vec3 &end, const glm::vec3 &color)
 {
-    float quadVertices[] = {
-        -0.5f,
-        0.0f,
-        -0.5f,
-        0.5f,
-        0.0f,
-        -0.5f,
-        0.5f,
-        0.0f,
-        0.5f,
-        -0.5f,
-        0.0f,
-        0.5f,
-    };
-
-    unsigned int quadIndices[] = {
-        0, 1, 2,
-        2, 3, 0};
-
-    glGenVertexArrays(1, &quadVAO);
-    glGenBuffers(1, &quadVBO);
-    glGenBuffers(1, &quadEBO);
-
-    glBindVertexArray(quadVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
-
-    glBindVertexArray(0);
+    const glm::vec3 points[] = {start, end};
+    DrawLines(points, 2, color);
 }
 
-void Renderer::CreateCue()
+void Renderer::DrawLines(const glm::vec3 *points, size_t pointCount, const glm::vec3 &color)
 {
-    glGenVertexArrays(1, &cueVAO);
-    glGenBuffers(1, &cueVBO);
-    glGenBuffers(1, &cueEBO);
-
-    glBindVertexArray(cueVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, cueVBO);
-    float emptyCue[12] = {}; // 4 вершины * 3 координаты
-    glBufferData(GL_ARRAY_BUFFER, sizeof(emptyCue), emptyCue, GL_DYNAMIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cueEBO);
-    unsigned int indices[] = {0, 1, 2, 2, 3, 0};
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void *)0);
+    // Режем на куски, помещающиеся в сегмент буфера (чётное число вершин)
+    const size_t chunk = static_cast<size_t>(streamBuffer.MaxVertices()) & ~size_t(1);
+    for (size_t offset = 0; offset + 1 < pointCount; offset += chunk)
+    {
+        GLsizei count = static_cast<GLsizei>(std::min(chunk, pointCount - offset) & ~size_t(1));
+        GLint first = streamBuffer.Push(points + offset, count);
+        if (first < 0)
+            break;
+
+        // Ограничивающая сфера куска линий
+        glm::vec3 minPoint = points[offset], maxPoint = points[offset];
+        for (GLsizei i = 1; i < count; ++i)
+        {
+            minPoint = glm::min(minPoint, points[offset + i]);
+            maxPoint = glm::max(maxPoint, points[offset + i]);
+        }
 
-    glBindVertexArray(0);
+        DrawCommand command;
+        command.pass = currentPass;
+        command.program = shaders.Get(ShaderVariant::Lines).GetID();
+        command.vao = streamBuffer.GetVAO();
+        command.mode = GL_LINES;
+        command.first = first;
+        command.count = count;
+        command.indexed = false;
+        command.color = color;
+        command.boundsCenter = (minPoint + maxPoint) * 0.5f;
+        command.boundsRadius = glm::length(maxPoint - minPoint) * 0.5f;
+        queue.Submit(command);
+    }
 }
 
 bool Renderer::LoadTextures()
 {
+    const auto start = std::chrono::steady_clock::now();
 
     ballTextures.clear();
 
     // Загрузка текстур для всех шаров (0-15)
+    std::vector<std::string> paths;
     for (int i = 0; i <= 15; ++i)
     {
-        std::string path = "textures/Ball" + std::to_string(i) + ".jpg";
+        paths.push_back("textures/Ball" + std::to_string(i) + ".jpg");
+    }
+
+    // Декодирование (или чтение из кэша) идёт параллельно, в GL загружаем готовые уровни
+    std::vector<TextureImage> images;
+    if (!textureCache.Load(paths, images))
+        return false;
+
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        const TextureImage &image = images[i];
 
         // Создание текстуры
         GLuint textureID;
         glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
+        GLState::ActiveTexture(GL_TEXTURE0);
+        GLState::BindTexture(GL_TEXTURE_2D, textureID);
 
         // Настройки текстуры
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(image.levels) - 1);
 
-        // Загрузка изображения (используйте stb_image или другую библиотеку)
-        int width, height, nrChannels;
-        unsigned char *data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-        if (data)
-        {
-            GLenum format = nrChannels == 4 ? GL_RGBA : GL_RGB;
-            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
-            ballTextures[i] = textureID;
-        }
-        else
+        for (uint32_t level = 0; level < image.levels; ++level)
         {
-            std::cerr << "Failed to load texture: " << path << std::endl;
-            return false;
+            glTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), GL_RGBA8,
+                         image.LevelWidth(level), image.LevelHeight(level), 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, image.Level(level));
         }
-        stbi_image_free(data);
+        ballTextures[static_cast<int>(i)] = textureID;
     }
+
+    textureCache.Release();
+
+    const auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start);
+    std::cout << "[Textures] " << images.size() << " loaded in " << elapsed.count() << " ms ("
+              << textureCache.CachedCount() << " from cache)" << std::endl;
     return true;
 }
 
-void Renderer::PrepareFrame()
+void Renderer::PrepareFrame(const glm::mat4 &view, const glm::mat4 &projection)
 {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    shader.Use();
+    RenderStats::Current() = RenderStats();
+    gpuTimer.BeginFrame();
+    currentPass = RenderPass::Scene;
 
-    // Сбрасываем все текстуры
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLint viewport[4];
+    glGetIntegerv(GL_VIEWPORT, viewport);
+    viewportHeight = static_cast<float>(viewport[3]);
 
-    // Сбрасываем состояния шейдера
-    shader.SetBool("uUseTexture", false);
-    shader.SetVec3("uColor", glm::vec3(1.0f));
-}
+    // Очистку делает Scene::drawSkyBackground, вторая здесь была бы лишней
 
-void Renderer::ResetMaterialStates()
-{
-    shader.SetBool("uUseTexture", false);
-    shader.SetVec3("uColor", glm::vec3(1.0f)); // Белый по умолчанию
+    queue.Begin(view, projection);
 }
 
-void Renderer::DrawBox(const glm::vec3 &position, const glm::vec3 &size, const glm::vec3 &color,
-                       const glm::mat4 &view, const glm::mat4 &projection)
+void Renderer::Flush()
 {
-    shader.Use();
+    TRACE_SCOPE("Renderer::Flush");
+    queue.Sort();
+
+    RenderStats &stats = RenderStats::Current();
+    int pass = -1;
+    GLuint currentProgram = 0;
+    const Shader *shader = nullptr;
+    uint32_t features = 0;
+    glm::vec3 currentColor(-1.0f);
+    const glm::mat4 viewProjection = queue.GetProjection() * queue.GetView();
+
+    for (const DrawCommand &command : queue.Commands())
+    {
+        if (static_cast<int>(command.pass) != pass)
+        {
+            pass = static_cast<int>(command.pass);
+            gpuTimer.Begin(command.pass);
+        }
 
-    glm::mat4 model = glm::mat4(1.0f);
-    model = glm::translate(model, position);
-    model = glm::scale(model, size);
+        if (command.program != currentProgram)
+        {
+            // Общие для всего кадра uniform-ы задаём один раз на программу
+            const ShaderVariant variant = shaders.VariantOf(command.program);
+            shader = &shaders.Get(variant);
+            features = ShaderLibrary::Features(variant);
+            shader->Use();
+            shader->SetMat4("uViewProjection", viewProjection);
+            if (features & ShaderTextured)
+                shader->SetInt("uTexture", 0);
+            GLState::ActiveTexture(GL_TEXTURE0);
+            currentProgram = command.program;
+            currentColor = glm::vec3(-1.0f);
+        }
 
-    shader.SetMat4("uModel", model);
-    shader.SetMat4("uView", view);
-    shader.SetMat4("uProjection", projection);
-    shader.SetVec3("uColor", color);
+        // Повторные привязки отсекает GLState
+        if (command.texture)
+            GLState::BindTexture(GL_TEXTURE_2D, command.texture);
 
-    glBindVertexArray(cubeVAO);
-    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-}
+        if (!(features & ShaderTextured) && command.color != currentColor)
+        {
+            shader->SetVec3("uColor", command.color);
+            currentColor = command.color;
+        }
 
-void Renderer::InitCube()
-{
-    // Вершины куба с нормалями (6 граней × 4 вершины × 6 атрибутов)
-    float vertices[] = {
-        // Передняя грань
-        -0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, -0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-        -0.5f, 0.5f, 0.5f, 0.0f, 0.0f, 1.0f,
-
-        // Задняя грань
-        -0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        0.5f, -0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-        -0.5f, 0.5f, -0.5f, 0.0f, 0.0f, -1.0f,
-
-        // Верхняя грань
-        -0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.5f, -0.5f, 0.0f, 1.0f, 0.0f,
-        0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
-        -0.5f, 0.5f, 0.5f, 0.0f, 1.0f, 0.0f,
-
-        // Нижняя грань
-        -0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
-        0.5f, -0.5f, -0.5f, 0.0f, -1.0f, 0.0f,
-        0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f,
-        -0.5f, -0.5f, 0.5f, 0.0f, -1.0f, 0.0f,
-
-        // Правая грань
-        0.5f, -0.5f, -0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, 0.5f, -0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, 0.5f, 0.5f, 1.0f, 0.0f, 0.0f,
-        0.5f, -0.5f, 0.5f, 1.0f, 0.0f, 0.0f,
-
-        // Левая грань
-        -0.5f, -0.5f, -0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, 0.5f, -0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, 0.5f, 0.5f, -1.0f, 0.0f, 0.0f,
-        -0.5f, -0.5f, 0.5f, -1.0f, 0.0f, 0.0f};
-
-    // Индексы для всех граней
-    unsigned int indices[] = {
-        0, 1, 2, 2, 3, 0,       // передняя
-        4, 5, 6, 6, 7, 4,       // задняя
-        8, 9, 10, 10, 11, 8,    // верхняя
-        12, 13, 14, 14, 15, 12, // нижняя
-        16, 17, 18, 18, 19, 16, // правая
-        20, 21, 22, 22, 23, 20  // левая
-    };
-
-    glGenVertexArrays(1, &cubeVAO);
-    glGenBuffers(1, &cubeVBO);
-    glGenBuffers(1, &cubeEBO);
-
-    glBindVertexArray(cubeVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, cubeEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    // Позиции
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)0);
-
-    // Нормали
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void *)(3 * sizeof(float)));
-
-    glBindVertexArray(0);
-}
+        GLState::BindVertexArray(command.vao);
 
-void Renderer::DrawPocket(const glm::vec3 &position, float radius,
-                          const glm::mat4 &view, const glm::mat4 &projection)
-{
-    shader.Use();
+        if (!(features & ShaderLines))
+            shader->SetMat4("uModel", command.model);
 
-    const int segments = 64;
-    std::vector<glm::vec3> vertices;
+        if (command.indexed)
+        {
+            glDrawElementsBaseVertex(command.mode, command.count, meshes.IndexType(),
+                                     meshes.IndexOffset(command.first), command.baseVertex);
+        }
+        else
+        {
+            glDrawArrays(command.mode, command.first, command.count);
+        }
+        ++stats.drawCalls;
+    }
 
-    vertices.push_back(position);
+    gpuTimer.End();
 
-    for (int i = 0; i <= segments; ++i)
-    {
-        float angle = glm::two_pi<float>() * i / segments;
-        float x = radius * cos(angle);
-        float z = radius * sin(angle);
-        vertices.emplace_back(position.x + x, position.y, position.z + z);
-    }
+    streamBuffer.EndFrame();
+    frameStats = RenderStats::Current();
+}
 
-    GLuint vao, vbo;
-    glGenVertexArrays(1, &vao);
-    glGenBuffers(1, &vbo);
+void Renderer::DrawBox(const glm::vec3 &position, const glm::vec3 &size, const glm::vec3 &color)
+{
+    glm::mat4 model = glm::mat4(1.0f);
+    model = glm::translate(model, position);
+    model = glm::scale(model, size);
 
-    glBindVertexArray(vao);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
+    SubmitMesh(MeshId::Box, model, color, 0, position, glm::length(size) * 0.5f);
+}
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), (void *)0);
+void Renderer::DrawPocket(const glm::vec3 &position, float radius)
+{
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
+    model = glm::scale(model, glm::vec3(radius, 1.0f, radius));
 
-    glm::mat4 model = glm::mat4(1.0f);
-    shader.SetMat4("uModel", model);
-    shader.SetMat4("uView", view);
-    shader.SetMat4("uProjection", projection);
-    shader.SetVec3("uColor", glm::vec3(0.0f, 0.0f, 0.0f));
-
-    glDrawArrays(GL_TRIANGLE_FAN, 0, static_cast<GLsizei>(vertices.size()));
-
-    glDisableVertexAttribArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    glDeleteBuffers(1, &vbo);
-    glDeleteVertexArrays(1, &vao);
+    SubmitMesh(MeshId::Disc, model, glm::vec3(0.0f, 0.0f, 0.0f), 0, position, radius);
 }
 
 void Renderer::DrawBall(const glm::vec3 &position, float radius, const glm::vec3 &color,
-                        const glm::mat4 &view, const glm::mat4 &projection,
                         const glm::quat &rotation, int ballNumber)
 {
-    // Оптимизированная проверка текстуры
-    bool useTexture = false;
+    GLuint texture = 0;
     if (ballNumber >= 0 && ballNumber <= 15)
     {
         auto it = ballTextures.find(ballNumber);
         if (it != ballTextures.end())
-        {
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, it->second);
-            shader.SetInt("uTexture", 0);
-            shader.SetBool("uUseTexture", true);
-            useTexture = true;
-        }
-    }
-
-    if (!useTexture)
-    {
-        shader.SetBool("uUseTexture", false);
-        shader.SetVec3("uColor", color);
+            texture = it->second;
     }
 
     // Матрицы преобразования
@@ -513,85 +360,76 @@ void Renderer::DrawBall(const glm::vec3 &position, float radius, const glm::vec3
     model = model * glm::toMat4(rotation);
     model = glm::scale(model, glm::vec3(radius));
 
-    shader.SetMat4("uModel", model);
-
-    // Отрисовка
-    glBindVertexArray(sphereVAO);
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    // Далёкие и мелкие шары рисуются более грубой сферой
+    const MeshId lod = MeshRegistry::SphereLod(ProjectedRadius(position, radius));
+    SubmitMesh(lod, model, color, texture, position, radius);
 }
 
-void Renderer::DrawTable(const glm::vec3 &position, const glm::vec2 &size, const glm::vec3 &color,
-                         const glm::mat4 &view, const glm::mat4 &projection)
+void Renderer::DrawTable(const glm::vec3 &position, const glm::vec2 &size, const glm::vec3 &color)
 {
-    shader.Use();
-
     glm::mat4 model = glm::translate(glm::mat4(1.0f), position);
     model = glm::scale(model, glm::vec3(size.x, 1.0f, size.y));
 
-    shader.SetMat4("uModel", model);
-    shader.SetMat4("uView", view);
-    shader.SetMat4("uProjection", projection);
-    shader.SetVec3("uColor", color);
-
-    glBindVertexArray(quadVAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    SubmitMesh(MeshId::Quad, model, color, 0, position, glm::length(size) * 0.5f);
 }
 
-void Renderer::DrawCue(const glm::vec3 &start, const glm::vec3 &end, float radius, const glm::vec3 &color,
-                       const glm::mat4 &view, const glm::mat4 &projection)
+void Renderer::DrawCue(const glm::vec3 &start, const glm::vec3 &end, float radius, const glm::vec3 &color)
 {
-    shader.Use();
-    shader.SetBool("uUseTexture", false);
-    shader.SetVec3("uColor", color);
-
     glm::vec3 direction = end - start;
     float length = glm::length(direction);
-    direction = glm::normalize(direction);
+    if (length <= 0.0f)
+        return;
+    direction /= length;
 
     glm::mat4 model = glm::mat4(1.0f);
     model = glm::translate(model, start);
 
-    // Выравнивание по направлению
-    glm::vec3 axis = glm::cross(glm::vec3(0.0f, 1.0f, 0.0f), direction);
-    float angle = acos(glm::dot(glm::vec3(0.0f, 1.0f, 0.0f), direction));
-    model = glm::rotate(model, angle, axis);
+    // Выравнивание оси цилиндра (+Y) по направлению кия
+    const glm::vec3 up(0.0f, 1.0f, 0.0f);
+    glm::vec3 axis = glm::cross(up, direction);
+    float angle = std::acos(glm::clamp(glm::dot(up, direction), -1.0f, 1.0f));
+    if (glm::length(axis) > 1e-6f)
+        model = glm::rotate(model, angle, glm::normalize(axis));
+    else if (angle > 0.0f)
+        model = glm::rotate(model, angle, glm::vec3(1.0f, 0.0f, 0.0f));
 
     model = glm::scale(model, glm::vec3(radius, length, radius));
 
-    shader.SetMat4("uModel", model);
-    shader.SetMat4("uView", view);
-    shader.SetMat4("uProjection", projection);
+    SubmitMesh(MeshId::Cylinder, model, color, 0, (start + end) * 0.5f, length * 0.5f + radius);
+}
 
-    glBindVertexArray(sphereVAO);
-    glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+void Renderer::SubmitMesh(MeshId mesh, const glm::mat4 &model, const glm::vec3 &color, GLuint texture,
+                          const glm::vec3 &boundsCenter, float boundsRadius)
+{
+    const MeshRange &range = meshes.Get(mesh);
+
+    DrawCommand command;
+    command.pass = currentPass;
+    command.program = shaders.Get(texture ? ShaderVariant::Textured : ShaderVariant::Flat).GetID();
+    command.texture = texture;
+    command.vao = meshes.GetVAO();
+    command.first = range.firstIndex;
+    command.count = range.indexCount;
+    command.baseVertex = range.baseVertex;
+    command.model = model;
+    command.color = color;
+    command.boundsCenter = boundsCenter;
+    command.boundsRadius = boundsRadius;
+    queue.Submit(command);
 }
 
-Shader &Renderer::GetShader()
+float Renderer::ProjectedRadius(const glm::vec3 &center, float radius) const
 {
-    return shader;
+    const float depth = -(queue.GetView() * glm::vec4(center, 1.0f)).z;
+    if (depth <= radius)
+        return viewportHeight; // Камера внутри или вплотную — максимальная детализация
+    return radius * queue.GetProjection()[1][1] * 0.5f * viewportHeight / depth;
 }
 
 void Renderer::Cleanup()
 {
-    if (sphereVAO)
-    {
-        glDeleteVertexArrays(1, &sphereVAO);
-        glDeleteBuffers(1, &sphereVBO);
-        glDeleteBuffers(1, &sphereEBO);
-    }
-    if (quadVAO)
-    {
-        glDeleteVertexArrays(1, &quadVAO);
-        glDeleteBuffers(1, &quadVBO);
-        glDeleteBuffers(1, &quadEBO);
-    }
-    if (cueVAO)
-    {
-        glDeleteVertexArrays(1, &cueVAO);
-        glDeleteBuffers(1, &cueVBO);
-        glDeleteBuffers(1, &cueEBO);
-    }
+    meshes.Cleanup();
+    streamBuffer.Cleanup();
+    gpuTimer.Cleanup();
+    overlay.Cleanup();
 }
\ No newline at end of file
@@ -2,10 +2,16 @@
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstring>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include "RenderStats.hpp"
+#include "GLState.hpp"
+#include "GLExt.hpp"
+#include "ProgramCache.hpp"
 
 class Shader
 {
@@ -14,16 +20,40 @@ public:
     Shader(const char *vertexPath, const char *fragmentPath);
     ~Shader();
 
-    bool Init();
+    bool InitFromSource(const char *vertexShaderSource, const char *fragmentShaderSource);
+
+    // Сборка в два шага: BeginFromSource отдаёт компиляцию и линковку драйверу, не дожидаясь
+    // результата, FinishCompile проверяет итог. Между ними можно запустить другие программы.
+    bool BeginFromSource(const char *vertexShaderSource, const char *fragmentShaderSource);
+    bool IsCompileReady() const; // Без GL_KHR_parallel_shader_compile — всегда true
+    bool FinishCompile();
+
     void Use() const;
-    void SetBool(const std::string &name, bool value) const;
-    void SetInt(const std::string &name, int value) const;
-    void SetFloat(const std::string &name, float value) const;
-    void SetVec3(const std::string &name, const glm::vec3 &value) const;
-    void SetMat4(const std::string &name, const glm::mat4 &value) const;
+    GLuint GetID() const { return programID; }
+    void SetBool(const char *name, bool value) const;
+    void SetInt(const char *name, int value) const;
+    void SetFloat(const char *name, float value) const;
+    void SetVec2(const char *name, const glm::vec2 &value) const;
+    void SetVec3(const char *name, const glm::vec3 &value) const;
+    void SetMat4(const char *name, const glm::mat4 &value) const;
 
 private:
-    GLuint programID;
+    GLuint programID = 0;
+
+    // Незавершённая сборка
+    GLuint pendingVertex = 0;
+    GLuint pendingFragment = 0;
+    uint64_t pendingKey = 0;
+
+    // Кэш расположений uniform: поиск по имени без обращения к драйверу и без аллокаций
+    struct UniformSlot
+    {
+        std::string name;
+        GLint location;
+    };
+    mutable std::vector<UniformSlot> uniforms;
+
+    GLint GetUniformLocation(const char *name) const;
 
     std::string readFile(const char *path);
     GLuint compileShader(GLenum type, const std::string &source);
@@ -59,144 +89,146 @@ Shader::Shader(const char *vertexPath, const char *fragmentPath)
 Shader::~Shader()
 {
     glDeleteProgram(programID);
+    // Номер программы может достаться новой
+    GLState::Invalidate();
 }
 
-bool Shader::Init()
-{
-    // Встроенные шейдеры для базового рендеринга
-    const char *vertexShaderSource = R"(
-#version 330 core
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aNormal;
-layout (location = 2) in vec2 aTexCoord;
-
-uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
-uniform mat4 uRotation;
-
-out vec3 FragPos;
-out vec3 Normal;
-out vec2 TexCoord;
-
-void main() {
-    FragPos = vec3(uModel * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(uModel))) * aNormal;
-    TexCoord = aTexCoord;
-    gl_Position = uProjection * uView * vec4(FragPos, 1.0);
-}
-)";
-
-    const char *fragmentShaderSource = R"(
-#version 330 core
-out vec4 FragColor;
-
-in vec3 FragPos;
-in vec3 Normal;
-in vec2 TexCoord;
-
-uniform vec3 uColor;
-uniform sampler2D uTexture;
-uniform bool uUseTexture;
-
-void main() {
-    if (uUseTexture) {
-        vec4 texColor = texture(uTexture, TexCoord);
-        FragColor = vec4(texColor.rgb, 1.0);
-    } else {
-        FragColor = vec4(uColor, 1.0); // Непрозрачный цвет
-    }
+bool Shader::InitFromSource(const char *vertexShaderSource, const char *fragmentShaderSource)
+{
+    return BeginFromSource(vertexShaderSource, fragmentShaderSource) && FinishCompile();
 }
-)";
 
-    // Компиляция вершинного шейдера
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, nullptr);
-    glCompileShader(vertexShader);
-
-    GLint success;
-    glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        char infoLog[512];
-        glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        std::cerr << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
-        glDeleteShader(vertexShader);
-        return false;
-    }
+bool Shader::BeginFromSource(const char *vertexShaderSource, const char *fragmentShaderSource)
+{
+    // Сначала пробуем готовый бинарник из кэша
+    pendingKey = ProgramCache::Key(vertexShaderSource, fragmentShaderSource);
+    uniforms.clear();
+    programID = glCreateProgram();
+    if (ProgramCache::Load(programID, pendingKey))
+        return true;
+    glDeleteProgram(programID);
 
-    // Компиляция фрагментного шейдера
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, nullptr);
-    glCompileShader(fragmentShader);
+    // Статус компиляции не запрашиваем: драйвер волен собирать программу в фоне
+    pendingVertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(pendingVertex, 1, &vertexShaderSource, nullptr);
+    glCompileShader(pendingVertex);
 
-    glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
-    if (!success)
-    {
-        char infoLog[512];
-        glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        std::cerr << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n"
-                  << infoLog << std::endl;
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
-        return false;
-    }
+    pendingFragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(pendingFragment, 1, &fragmentShaderSource, nullptr);
+    glCompileShader(pendingFragment);
 
-    // Создание и линковка шейдерной программы
     programID = glCreateProgram();
-    glAttachShader(programID, vertexShader);
-    glAttachShader(programID, fragmentShader);
+    glAttachShader(programID, pendingVertex);
+    glAttachShader(programID, pendingFragment);
+    ProgramCache::PrepareForRetrieval(programID);
     glLinkProgram(programID);
+    return true;
+}
+
+bool Shader::IsCompileReady() const
+{
+    if (!pendingVertex || !GLExt::ParallelShaderCompile)
+        return true;
+    GLint done = GL_TRUE;
+    glGetProgramiv(programID, GL_COMPLETION_STATUS_KHR, &done);
+    return done == GL_TRUE;
+}
+
+bool Shader::FinishCompile()
+{
+    // Программа из кэша уже готова
+    if (!pendingVertex)
+        return programID != 0;
 
+    GLint success;
     glGetProgramiv(programID, GL_LINK_STATUS, &success);
     if (!success)
     {
         char infoLog[512];
+        const struct
+        {
+            GLuint shader;
+            const char *name;
+        } stages[] = {{pendingVertex, "VERTEX"}, {pendingFragment, "FRAGMENT"}};
+        for (const auto &stage : stages)
+        {
+            glGetShaderiv(stage.shader, GL_COMPILE_STATUS, &success);
+            if (!success)
+            {
+                glGetShaderInfoLog(stage.shader, 512, nullptr, infoLog);
+                std::cerr << "ERROR::SHADER::" << stage.name << "::COMPILATION_FAILED\n"
+                          << infoLog << std::endl;
+            }
+        }
         glGetProgramInfoLog(programID, 512, nullptr, infoLog);
         std::cerr << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n"
                   << infoLog << std::endl;
-        glDeleteShader(vertexShader);
-        glDeleteShader(fragmentShader);
         glDeleteProgram(programID);
-        return false;
+        programID = 0;
+    }
+    else
+    {
+        ProgramCache::Store(programID, pendingKey);
     }
 
     // Удаление шейдеров после линковки
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-
-    return true;
+    glDeleteShader(pendingVertex);
+    glDeleteShader(pendingFragment);
+    pendingVertex = pendingFragment = 0;
+    return programID != 0;
 }
 
 void Shader::Use() const
 {
-    glUseProgram(programID);
+    GLState::UseProgram(programID);
+}
+
+GLint Shader::GetUniformLocation(const char *name) const
+{
+    for (const UniformSlot &slot : uniforms)
+    {
+        if (std::strcmp(slot.name.c_str(), name) == 0)
+            return slot.location;
+    }
+    const GLint location = glGetUniformLocation(programID, name);
+    uniforms.push_back({name, location});
+    return location;
+}
+
+void Shader::SetBool(const char *name, bool value) const
+{
+    glUniform1i(GetUniformLocation(name), (int)value);
+    ++RenderStats::Current().uniformUploads;
 }
 
-void Shader::SetBool(const std::string &name, bool value) const
+void Shader::SetInt(const char *name, int value) const
 {
-    glUniform1i(glGetUniformLocation(programID, name.c_str()), (int)value);
+    glUniform1i(GetUniformLocation(name), value);
+    ++RenderStats::Current().uniformUploads;
 }
 
-void Shader::SetInt(const std::string &name, int value) const
+void Shader::SetFloat(const char *name, float value) const
 {
-    glUniform1i(glGetUniformLocation(programID, name.c_str()), value);
+    glUniform1f(GetUniformLocation(name), value);
+    ++RenderStats::Current().uniformUploads;
 }
 
-void Shader::SetFloat(const std::string &name, float value) const
+void Shader::SetVec2(const char *name, const glm::vec2 &value) const
 {
-    glUniform1f(glGetUniformLocation(programID, name.c_str()), value);
+    glUniform2fv(GetUniformLocation(name), 1, &value[0]);
+    ++RenderStats::Current().uniformUploads;
 }
 
-void Shader::SetVec3(const std::string &name, const glm::vec3 &value) const
+void Shader::SetVec3(const char *name, const glm::vec3 &value) const
 {
-    glUniform3fv(glGetUniformLocation(programID, name.c_str()), 1, &value[0]);
+    glUniform3fv(GetUniformLocation(name), 1, &value[0]);
+    ++RenderStats::Current().uniformUploads;
 }
 
-void Shader::SetMat4(const std::string &name, const glm::mat4 &value) const
+void Shader::SetMat4(const char *name, const glm::mat4 &value) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(programID, name.c_str()), 1, GL_FALSE, &value[0][0]);
+    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &value[0][0]);
+    ++RenderStats::Current().uniformUploads;
 }
 
 std::string Shader::readFile(const char *path)
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "GLExt.hpp"
+#include "Shader.hpp"
+
+// Признаки варианта шейдера — #define в начале исходника
+enum ShaderFeature : uint32_t
+{
+    ShaderTextured = 1u << 0,  // Цвет из текстуры вместо uColor
+    ShaderLines = 1u << 1,     // Вершины уже в мировых координатах, без uModel
+    ShaderInstanced = 1u << 2, // Матрица и цвет — атрибуты экземпляра (TableWall)
+};
+
+enum class ShaderVariant : uint8_t
+{
+    Flat,              // Заливка uColor
+    Textured,          // Шар с текстурой
+    Lines,             // Отрезки из потокового буфера
+    InstancedFlat,     // Экземпляры с цветом атрибута
+    InstancedTextured, // Экземпляры со слоем массива текстур в color.a
+    Count
+};
+
+constexpr int kShaderVariantCount = static_cast<int>(ShaderVariant::Count);
+
+// Специализированные варианты общего шейдера. Вместо ветвлений по uniform в каждом пикселе
+// и лишних вычислений в каждой вершине каждый вариант собирается только со своими
+// признаками; рендерер выбирает вариант по команде. Все варианты компилируются сразу
+// при запуске — драйвер собирает их параллельно.
+class ShaderLibrary
+{
+public:
+    // Отдаёт все варианты на компиляцию, не дожидаясь результата
+    bool Begin();
+
+    // Дожидается сборки; false — хотя бы один вариант не собрался
+    bool Finish();
+
+    bool Init() { return Begin() && Finish(); }
+
+    const Shader &Get(ShaderVariant variant) const { return shaders[static_cast<int>(variant)]; }
+
+    // Вариант по программе команды отрисовки
+    ShaderVariant VariantOf(GLuint program) const;
+
+    static uint32_t Features(ShaderVariant variant);
+    static const char *Name(ShaderVariant variant);
+
+private:
+    Shader shaders[kShaderVariantCount];
+    std::chrono::steady_clock::time_point compileStart;
+
+    static std::string Source(uint32_t features, const char *body);
+};
+
+inline uint32_t ShaderLibrary::Features(ShaderVariant variant)
+{
+    switch (variant)
+    {
+    case ShaderVariant::Textured:
+        return ShaderTextured;
+    case ShaderVariant::Lines:
+        return ShaderLines;
+    case ShaderVariant::InstancedFlat:
+        return ShaderInstanced;
+    case ShaderVariant::InstancedTextured:
+        return ShaderInstanced | ShaderTextured;
+    default:
+        return 0;
+    }
+}
+
+inline const char *ShaderLibrary::Name(ShaderVariant variant)
+{
+    switch (variant)
+    {
+    case ShaderVariant::Flat:
+        return "flat";
+    case ShaderVariant::Textured:
+        return "textured";
+    case ShaderVariant::Lines:
+        return "lines";
+    case ShaderVariant::InstancedFlat:
+        return "instanced flat";
+    case ShaderVariant::InstancedTextured:
+        return "instanced textured";
+    default:
+        return "?";
+    }
+}
+
+inline std::string ShaderLibrary::Source(uint32_t features, const char *body)
+{
+    std::string source = "#version 330 core\n";
+    if (features & ShaderTextured)
+        source += "#define TEXTURED\n";
+    if (features & ShaderLines)
+        source += "#define LINES\n";
+    if (features & ShaderInstanced)
+        source += "#define INSTANCED\n";
+    return source + body;
+}
+
+inline bool ShaderLibrary::Begin()
+{
+    const char *vertexBody = R"(
+layout (location = 0) in vec3 aPos;
+
+#ifdef TEXTURED
+layout (location = 2) in vec2 aTexCoord;
+out vec2 TexCoord;
+#endif
+
+#ifdef INSTANCED
+// Аффинная матрица меш -> NDC тремя строками и цвет (у текстурных — слой в w)
+layout (location = 3) in vec4 iRow0;
+layout (location = 4) in vec4 iRow1;
+layout (location = 5) in vec4 iRow2;
+layout (location = 6) in vec4 iColor;
+flat out vec4 Color;
+#else
+uniform mat4 uViewProjection;
+#ifndef LINES
+uniform mat4 uModel;
+#endif
+#endif
+
+void main() {
+#if defined(INSTANCED)
+    vec4 p = vec4(aPos, 1.0);
+    gl_Position = vec4(dot(iRow0, p), dot(iRow1, p), dot(iRow2, p), 1.0);
+    Color = iColor;
+#elif defined(LINES)
+    gl_Position = uViewProjection * vec4(aPos, 1.0);
+#else
+    gl_Position = uViewProjection * (uModel * vec4(aPos, 1.0));
+#endif
+#ifdef TEXTURED
+    TexCoord = aTexCoord;
+#endif
+}
+)";
+
+    const char *fragmentBody = R"(
+out vec4 FragColor;
+
+#ifdef TEXTURED
+in vec2 TexCoord;
+#endif
+
+#if defined(INSTANCED)
+flat in vec4 Color;
+#ifdef TEXTURED
+uniform sampler2DArray uTexture;
+#endif
+#elif defined(TEXTURED)
+uniform sampler2D uTexture;
+#else
+uniform vec3 uColor;
+#endif
+
+void main() {
+#if defined(INSTANCED) && defined(TEXTURED)
+    FragColor = vec4(texture(uTexture, vec3(TexCoord, Color.a)).rgb, 1.0);
+#elif defined(INSTANCED)
+    FragColor = vec4(Color.rgb, 1.0);
+#elif defined(TEXTURED)
+    FragColor = vec4(texture(uTexture, TexCoord).rgb, 1.0);
+#else
+    FragColor = vec4(uColor, 1.0);
+#endif
+}
+)";
+
+    compileStart = std::chrono::steady_clock::now();
+    if (GLExt::MaxShaderCompilerThreads)
+        GLExt::MaxShaderCompilerThreads(0xFFFFFFFFu); // Число потоков выбирает драйвер
+
+    bool ok = true;
+    for (int i = 0; i < kShaderVariantCount; ++i)
+    {
+        const uint32_t features = Features(static_cast<ShaderVariant>(i));
+        const std::string vertexSource = Source(features, vertexBody);
+        const std::string fragmentSource = Source(features, fragmentBody);
+        ok &= shaders[i].BeginFromSource(vertexSource.c_str(), fragmentSource.c_str());
+    }
+    return ok;
+}
+
+inline bool ShaderLibrary::Finish()
+{
+    bool ok = true;
+    for (int i = 0; i < kShaderVariantCount; ++i)
+    {
+        if (!shaders[i].FinishCompile())
+        {
+            std::cerr << "[Shaders] Variant '" << Name(static_cast<ShaderVariant>(i)) << "' failed" << std::endl;
+            ok = false;
+        }
+    }
+
+    const auto elapsed = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - compileStart);
+    std::cout << "[Shaders] " << kShaderVariantCount << " variants ready in " << elapsed.count() << " ms"
+              << (GLExt::ParallelShaderCompile ? " (parallel compile)" : "") << std::endl;
+    return ok;
+}
+
+inline ShaderVariant ShaderLibrary::VariantOf(GLuint program) const
+{
+    for (int i = 0; i < kShaderVariantCount; ++i)
+    {
+        if (shaders[i].GetID() == program)
+            return static_cast<ShaderVariant>(i);
+    }
+    return ShaderVariant::Flat;
+}
@@ -0,0 +1,229 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <cstring>
+#include <iostream>
+#include "GLExt.hpp"
+#include "GLState.hpp"
+#include "RenderStats.hpp"
+
+// Кольцевой буфер вершин для динамической геометрии (линии, лунки, отладочные примитивы).
+// Один VBO разбит на сегменты. При наличии glBufferStorage буфер отображается в память
+// постоянно, а повторное использование сегмента защищено fence-объектом.
+// Без него данные пишутся через glMapBufferRange, а буфер "осиротевает" в EndFrame() кадра,
+// который в него писал; следующий кадр заполняет новое хранилище с начала.
+// Отрисовка может быть отложена (очередь кадра), поэтому и fence, и осиротевание — в EndFrame(),
+// после отправки всех команд: раньше сегменты этого кадра ещё не прочитаны.
+class StreamBuffer
+{
+public:
+    StreamBuffer() = default;
+    ~StreamBuffer();
+
+    StreamBuffer(const StreamBuffer &) = delete;
+    StreamBuffer &operator=(const StreamBuffer &) = delete;
+
+    bool Init(GLsizeiptr capacityBytes = 4 * 1024 * 1024);
+    void Cleanup();
+
+    // Копирует вершины в буфер и возвращает индекс первой из них (или -1, если не влезли)
+    GLint Push(const glm::vec3 *vertices, GLsizei count);
+
+    // Вызывается после отправки всех команд кадра, читающих буфер
+    void EndFrame();
+
+    void Bind() const;
+    GLuint GetVAO() const { return vao; }
+
+    GLsizei MaxVertices() const;
+    bool IsPersistent() const { return persistent; }
+
+private:
+    static constexpr int kSegments = 4;
+    static constexpr GLsizeiptr kStride = sizeof(glm::vec3);
+
+    GLuint vao = 0, vbo = 0;
+    GLsizeiptr capacity = 0;
+    GLsizeiptr segmentSize = 0;
+    GLsizeiptr head = 0; // Смещение следующей записи в байтах
+    int segment = 0;
+
+    GLsync fences[kSegments] = {};
+    bool pending[kSegments] = {}; // Сегмент заполнен в этом кадре и ещё не защищён fence
+    char *mapped = nullptr;
+    bool persistent = false;
+
+    bool AdvanceSegment();
+};
+
+inline StreamBuffer::~StreamBuffer()
+{
+    Cleanup();
+}
+
+inline bool StreamBuffer::Init(GLsizeiptr capacityBytes)
+{
+    // Сегмент должен вмещать целое число вершин
+    segmentSize = (capacityBytes / kSegments / kStride) * kStride;
+    capacity = segmentSize * kSegments;
+    if (segmentSize == 0)
+        return false;
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vbo);
+
+    GLState::BindVertexArray(vao);
+    GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    if (GLExt::BufferStorage)
+    {
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        GLExt::BufferStorage(GL_ARRAY_BUFFER, capacity, nullptr, flags);
+        mapped = static_cast<char *>(glMapBufferRange(GL_ARRAY_BUFFER, 0, capacity, flags));
+        persistent = mapped != nullptr;
+    }
+
+    if (!persistent)
+    {
+        glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+    }
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, kStride, (void *)0);
+
+    head = 0;
+    segment = 0;
+    return true;
+}
+
+inline void StreamBuffer::Cleanup()
+{
+    for (GLsync &fence : fences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (vbo)
+    {
+        if (mapped)
+        {
+            GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            mapped = nullptr;
+        }
+        glDeleteBuffers(1, &vbo);
+        glDeleteVertexArrays(1, &vao);
+        GLState::Invalidate();
+        vbo = 0;
+        vao = 0;
+    }
+}
+
+inline GLint StreamBuffer::Push(const glm::vec3 *vertices, GLsizei count)
+{
+    const GLsizeiptr bytes = static_cast<GLsizeiptr>(count) * kStride;
+    if (count <= 0 || bytes > segmentSize)
+        return -1;
+
+    const GLsizeiptr segmentEnd = static_cast<GLsizeiptr>(segment + 1) * segmentSize;
+    if (head + bytes > segmentEnd && !AdvanceSegment())
+        return -1;
+
+    const GLsizeiptr offset = head;
+    head += bytes;
+    ++RenderStats::Current().bufferUploads;
+
+    if (persistent)
+    {
+        std::memcpy(mapped + offset, vertices, bytes);
+    }
+    else
+    {
+        GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+        void *dst = glMapBufferRange(GL_ARRAY_BUFFER, offset, bytes,
+                                     GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+        if (dst)
+        {
+            std::memcpy(dst, vertices, bytes);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+        }
+        else
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, offset, bytes, vertices);
+        }
+    }
+
+    return static_cast<GLint>(offset / kStride);
+}
+
+inline bool StreamBuffer::AdvanceSegment()
+{
+    const int next = (segment + 1) % kSegments;
+
+    // Следующий сегмент ещё не отрисован в этом кадре — перезаписывать нельзя
+    if (pending[next])
+        return false;
+
+    pending[segment] = true;
+    segment = next;
+    head = static_cast<GLsizeiptr>(segment) * segmentSize;
+
+    if (persistent)
+    {
+        // Ждём, пока GPU дочитает следующий сегмент (обычно fence уже сработал)
+        if (fences[segment])
+        {
+            GLenum result = glClientWaitSync(fences[segment], 0, 0);
+            while (result == GL_TIMEOUT_EXPIRED)
+            {
+                result = glClientWaitSync(fences[segment], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+            }
+            glDeleteSync(fences[segment]);
+            fences[segment] = nullptr;
+        }
+    }
+    return true;
+}
+
+inline void StreamBuffer::EndFrame()
+{
+    const bool written = head != static_cast<GLsizeiptr>(segment) * segmentSize;
+    for (int i = 0; i < kSegments; ++i)
+    {
+        if (!pending[i])
+            continue;
+
+        // Все команды, читающие сегмент, уже отправлены — ставим за ними fence
+        if (persistent)
+        {
+            if (fences[i])
+                glDeleteSync(fences[i]);
+            fences[i] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        pending[i] = false;
+    }
+
+    if (!persistent && written)
+    {
+        // Осиротевание: драйвер выделит новое хранилище, старое освободится после отрисовки
+        // уже отправленных команд. Внутри кадра переход в начало невозможен (сегмент 0 занят)
+        GLState::BindBuffer(GL_ARRAY_BUFFER, vbo);
+        glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_STREAM_DRAW);
+        segment = 0;
+        head = 0;
+    }
+}
+
+inline void StreamBuffer::Bind() const
+{
+    GLState::BindVertexArray(vao);
+}
+
+inline GLsizei StreamBuffer::MaxVertices() const
+{
+    return static_cast<GLsizei>(segmentSize / kStride);
+}
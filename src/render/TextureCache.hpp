@@ -0,0 +1,362 @@
+#pragma once
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+#include <core/MappedFile.hpp>
+#include <core/Tracer.hpp>
+
+// Декодированная текстура RGBA8 с полной цепочкой mip-уровней.
+// Данные лежат либо в собственном буфере, либо в отображённом файле кэша.
+struct TextureImage
+{
+    static constexpr int kMaxLevels = 16;
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t levels = 0;
+    size_t levelOffset[kMaxLevels] = {};
+    size_t byteSize = 0;
+
+    std::vector<uint8_t> storage;     // Пусто, если данные в кэше
+    const uint8_t *mapped = nullptr;
+
+    const uint8_t *Level(uint32_t level) const
+    {
+        return (storage.empty() ? mapped : storage.data()) + levelOffset[level];
+    }
+    uint32_t LevelWidth(uint32_t level) const { return std::max(1u, width >> level); }
+    uint32_t LevelHeight(uint32_t level) const { return std::max(1u, height >> level); }
+};
+
+// Загрузка текстур с диска: JPEG декодируются параллельно в рабочих потоках,
+// mip-уровни строятся на CPU. Результат сохраняется в файл кэша, который при следующих
+// запусках отображается в память и загружается в GL без декодирования.
+// Запись ключуется хэшем содержимого исходного файла и временем его изменения.
+class TextureCache
+{
+public:
+    explicit TextureCache(std::string cachePath);
+    ~TextureCache();
+
+    TextureCache(const TextureCache &) = delete;
+    TextureCache &operator=(const TextureCache &) = delete;
+
+    bool Load(const std::vector<std::string> &paths, std::vector<TextureImage> &images);
+
+    // Освобождает отображение кэша (после загрузки текстур в GL)
+    void Release();
+
+    size_t CachedCount() const { return cachedCount; }
+
+private:
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t entryCount;
+        uint32_t reserved;
+    };
+
+    struct Entry
+    {
+        uint64_t sourceHash;
+        int64_t sourceTime;
+        uint32_t width;
+        uint32_t height;
+        uint32_t levels;
+        uint32_t reserved;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    static constexpr uint32_t kVersion = 1;
+
+    std::string cachePath;
+    MappedFile mapping;
+    std::thread writer;
+    size_t cachedCount = 0;
+
+    const Entry *FindEntries(size_t expectedCount) const;
+
+    static uint64_t HashBytes(const uint8_t *data, size_t size);
+    static int64_t SourceTime(const std::string &path);
+    static bool Decode(const std::vector<uint8_t> &file, TextureImage &image);
+    static void BuildMipChain(TextureImage &image);
+    static void LayoutLevels(TextureImage &image);
+    static void WriteCache(std::string path, std::vector<TextureImage> images,
+                           std::vector<uint64_t> hashes, std::vector<int64_t> times);
+};
+
+inline TextureCache::TextureCache(std::string cachePath)
+    : cachePath(std::move(cachePath))
+{
+}
+
+inline TextureCache::~TextureCache()
+{
+    if (writer.joinable())
+        writer.join();
+}
+
+inline void TextureCache::Release()
+{
+    mapping.Close();
+}
+
+inline uint64_t TextureCache::HashBytes(const uint8_t *data, size_t size)
+{
+    // FNV-1a 64
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; ++i)
+    {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+inline int64_t TextureCache::SourceTime(const std::string &path)
+{
+    std::error_code error;
+    auto time = std::filesystem::last_write_time(path, error);
+    return error ? 0 : static_cast<int64_t>(time.time_since_epoch().count());
+}
+
+inline void TextureCache::LayoutLevels(TextureImage &image)
+{
+    image.levels = 1;
+    while (image.levels < TextureImage::kMaxLevels &&
+           (image.LevelWidth(image.levels - 1) > 1 || image.LevelHeight(image.levels - 1) > 1))
+    {
+        ++image.levels;
+    }
+
+    size_t offset = 0;
+    for (uint32_t level = 0; level < image.levels; ++level)
+    {
+        image.levelOffset[level] = offset;
+        offset += static_cast<size_t>(image.LevelWidth(level)) * image.LevelHeight(level) * 4;
+    }
+    image.byteSize = offset;
+}
+
+inline bool TextureCache::Decode(const std::vector<uint8_t> &file, TextureImage &image)
+{
+    int width = 0, height = 0, channels = 0;
+    unsigned char *pixels = stbi_load_from_memory(file.data(), static_cast<int>(file.size()),
+                                                  &width, &height, &channels, 4);
+    if (!pixels)
+        return false;
+
+    image.width = static_cast<uint32_t>(width);
+    image.height = static_cast<uint32_t>(height);
+    LayoutLevels(image);
+
+    image.storage.resize(image.byteSize);
+    std::memcpy(image.storage.data(), pixels, static_cast<size_t>(width) * height * 4);
+    stbi_image_free(pixels);
+
+    BuildMipChain(image);
+    return true;
+}
+
+inline void TextureCache::BuildMipChain(TextureImage &image)
+{
+    // Бокс-фильтр 2x2; для нечётных размеров крайний пиксель повторяется
+    for (uint32_t level = 1; level < image.levels; ++level)
+    {
+        const uint32_t srcW = image.LevelWidth(level - 1);
+        const uint32_t srcH = image.LevelHeight(level - 1);
+        const uint32_t dstW = image.LevelWidth(level);
+        const uint32_t dstH = image.LevelHeight(level);
+        const uint8_t *src = image.storage.data() + image.levelOffset[level - 1];
+        uint8_t *dst = image.storage.data() + image.levelOffset[level];
+
+        for (uint32_t y = 0; y < dstH; ++y)
+        {
+            const uint32_t y0 = std::min(y * 2, srcH - 1);
+            const uint32_t y1 = std::min(y * 2 + 1, srcH - 1);
+            for (uint32_t x = 0; x < dstW; ++x)
+            {
+                const uint32_t x0 = std::min(x * 2, srcW - 1);
+                const uint32_t x1 = std::min(x * 2 + 1, srcW - 1);
+                for (uint32_t c = 0; c < 4; ++c)
+                {
+                    const uint32_t sum = src[(y0 * srcW + x0) * 4 + c] + src[(y0 * srcW + x1) * 4 + c] +
+                                         src[(y1 * srcW + x0) * 4 + c] + src[(y1 * srcW + x1) * 4 + c];
+                    dst[(y * dstW + x) * 4 + c] = static_cast<uint8_t>((sum + 2) / 4);
+                }
+            }
+        }
+    }
+}
+
+inline const TextureCache::Entry *TextureCache::FindEntries(size_t expectedCount) const
+{
+    if (!mapping.IsOpen() || mapping.Size() < sizeof(Header))
+        return nullptr;
+
+    Header header;
+    std::memcpy(&header, mapping.Data(), sizeof(header));
+    if (std::memcmp(header.magic, "BTXC", 4) != 0 || header.version != kVersion ||
+        header.entryCount != expectedCount ||
+        mapping.Size() < sizeof(Header) + expectedCount * sizeof(Entry))
+    {
+        return nullptr;
+    }
+    return reinterpret_cast<const Entry *>(mapping.Data() + sizeof(Header));
+}
+
+inline bool TextureCache::Load(const std::vector<std::string> &paths, std::vector<TextureImage> &images)
+{
+    const size_t count = paths.size();
+    images.clear();
+    images.resize(count);
+    cachedCount = 0;
+
+    mapping.Open(cachePath);
+    const Entry *entries = FindEntries(count);
+
+    std::vector<uint64_t> hashes(count, 0);
+    std::vector<int64_t> times(count, 0);
+    std::vector<char> fromCache(count, 0);
+    std::vector<char> failed(count, 0);
+
+    // Каждый поток берёт следующую текстуру из общего счётчика
+    std::atomic<size_t> next{0};
+    auto worker = [&]()
+    {
+        for (size_t i = next++; i < count; i = next++)
+        {
+            TRACE_SCOPE("TextureCache::Load");
+            std::ifstream file(paths[i], std::ios::binary);
+            std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            if (bytes.empty())
+            {
+                failed[i] = 1;
+                continue;
+            }
+
+            hashes[i] = HashBytes(bytes.data(), bytes.size());
+            times[i] = SourceTime(paths[i]);
+
+            if (entries)
+            {
+                const Entry &entry = entries[i];
+                if (entry.sourceHash == hashes[i] && entry.sourceTime == times[i] &&
+                    entry.offset + entry.size <= mapping.Size())
+                {
+                    TextureImage &image = images[i];
+                    image.width = entry.width;
+                    image.height = entry.height;
+                    LayoutLevels(image);
+                    if (image.levels == entry.levels && image.byteSize == entry.size)
+                    {
+                        image.mapped = mapping.Data() + entry.offset;
+                        fromCache[i] = 1;
+                        continue;
+                    }
+                }
+            }
+
+            if (!Decode(bytes, images[i]))
+                failed[i] = 1;
+        }
+    };
+
+    const size_t threadCount = std::max<size_t>(1, std::min<size_t>(std::thread::hardware_concurrency(), count));
+    std::vector<std::thread> threads;
+    for (size_t t = 1; t < threadCount; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &thread : threads)
+        thread.join();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        if (failed[i])
+        {
+            std::cerr << "Failed to load texture: " << paths[i] << std::endl;
+            return false;
+        }
+        cachedCount += fromCache[i];
+    }
+
+    if (cachedCount == count)
+        return true;
+
+    // Кэш устарел: переносим данные из отображения в память и пишем новый файл в фоне
+    std::vector<TextureImage> copies(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        TextureImage &image = images[i];
+        if (image.storage.empty())
+        {
+            image.storage.assign(image.mapped, image.mapped + image.byteSize);
+            image.mapped = nullptr;
+        }
+        copies[i] = image;
+    }
+    mapping.Close();
+
+    if (writer.joinable())
+        writer.join();
+    writer = std::thread(WriteCache, cachePath, std::move(copies), std::move(hashes), std::move(times));
+    return true;
+}
+
+inline void TextureCache::WriteCache(std::string path, std::vector<TextureImage> images,
+                                     std::vector<uint64_t> hashes, std::vector<int64_t> times)
+{
+    std::error_code error;
+    std::filesystem::path target(path);
+    if (target.has_parent_path())
+        std::filesystem::create_directories(target.parent_path(), error);
+
+    const std::string tempPath = path + ".tmp";
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out)
+        return;
+
+    Header header = {{'B', 'T', 'X', 'C'}, kVersion, static_cast<uint32_t>(images.size()), 0};
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    // Данные выравниваются по 16 байт после таблицы записей
+    uint64_t offset = sizeof(Header) + images.size() * sizeof(Entry);
+    std::vector<Entry> entries(images.size());
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        offset = (offset + 15) & ~uint64_t(15);
+        entries[i] = {hashes[i], times[i], images[i].width, images[i].height, images[i].levels, 0,
+                      offset, images[i].byteSize};
+        offset += images[i].byteSize;
+    }
+    out.write(reinterpret_cast<const char *>(entries.data()), entries.size() * sizeof(Entry));
+
+    uint64_t position = sizeof(Header) + images.size() * sizeof(Entry);
+    const char padding[16] = {};
+    for (size_t i = 0; i < images.size(); ++i)
+    {
+        out.write(padding, static_cast<std::streamsize>(entries[i].offset - position));
+        out.write(reinterpret_cast<const char *>(images[i].storage.data()), images[i].byteSize);
+        position = entries[i].offset + images[i].byteSize;
+    }
+    out.close();
+
+    if (out)
+        std::filesystem::rename(tempPath, target, error);
+    if (!out || error)
+        std::filesystem::remove(tempPath, error);
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Формат позиции упакованной вершины; оба занимают 8 байт (три компоненты и выравнивание)
+enum class PositionFormat : uint8_t
+{
+    Snorm16, // Точнее, но только для координат в [-1, 1]
+    Half,    // Любой масштаб, 11 бит мантиссы
+};
+
+// Упакованная вершина статического меша: 16 байт вместо 32 у float позиции, нормали и UV.
+// Нормаль — октаэдрическая развёртка единичного вектора в два snorm16,
+// UV — unorm16 (все UV мешей лежат в [0, 1]).
+struct PackedVertex
+{
+    uint16_t position[4];
+    int16_t normal[2];
+    uint16_t uv[2];
+};
+
+static_assert(sizeof(PackedVertex) == 16, "PackedVertex must stay 16 bytes");
+
+namespace VertexFormat
+{
+    // Единичный вектор -> точка квадрата [-1, 1]^2: проекция на октаэдр, нижняя половина
+    // отворачивается наружу
+    inline glm::vec2 OctEncode(const glm::vec3 &normal)
+    {
+        const glm::vec3 n = normal / (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z));
+        glm::vec2 encoded(n.x, n.y);
+        if (n.z < 0.0f)
+        {
+            encoded = (1.0f - glm::abs(glm::vec2(n.y, n.x))) *
+                      glm::vec2(n.x >= 0.0f ? 1.0f : -1.0f, n.y >= 0.0f ? 1.0f : -1.0f);
+        }
+        return encoded;
+    }
+
+    // Обратное преобразование — то же самое делает шейдер, которому нужна нормаль
+    inline glm::vec3 OctDecode(const glm::vec2 &encoded)
+    {
+        glm::vec3 n(encoded.x, encoded.y, 1.0f - std::abs(encoded.x) - std::abs(encoded.y));
+        const float fold = glm::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -fold : fold;
+        n.y += n.y >= 0.0f ? -fold : fold;
+        return glm::normalize(n);
+    }
+
+    // Snorm16 подходит, если все координаты в [-1, 1]
+    inline PositionFormat ChoosePositionFormat(float maxAbsCoordinate)
+    {
+        return maxAbsCoordinate <= 1.0f ? PositionFormat::Snorm16 : PositionFormat::Half;
+    }
+
+    inline PackedVertex Pack(const glm::vec3 &position, const glm::vec3 &normal, const glm::vec2 &uv,
+                             PositionFormat format)
+    {
+        PackedVertex vertex;
+        for (int i = 0; i < 3; ++i)
+        {
+            vertex.position[i] = format == PositionFormat::Snorm16
+                                     ? glm::packSnorm1x16(position[i])
+                                     : glm::packHalf1x16(position[i]);
+        }
+        vertex.position[3] = 0;
+
+        const glm::vec2 encoded = OctEncode(normal);
+        vertex.normal[0] = static_cast<int16_t>(glm::packSnorm1x16(encoded.x));
+        vertex.normal[1] = static_cast<int16_t>(glm::packSnorm1x16(encoded.y));
+
+        vertex.uv[0] = glm::packUnorm1x16(uv.x);
+        vertex.uv[1] = glm::packUnorm1x16(uv.y);
+        return vertex;
+    }
+
+    // Атрибуты 0–2 (позиция, нормаль, UV) для привязанных VAO и GL_ARRAY_BUFFER
+    inline void BindAttributes(PositionFormat format)
+    {
+        const GLsizei stride = sizeof(PackedVertex);
+
+        glEnableVertexAttribArray(0);
+        if (format == PositionFormat::Snorm16)
+            glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE, stride, (void *)offsetof(PackedVertex, position));
+        else
+            glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, stride, (void *)offsetof(PackedVertex, position));
+
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(1, 2, GL_SHORT, GL_TRUE, stride, (void *)offsetof(PackedVertex, normal));
+
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(2, 2, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void *)offsetof(PackedVertex, uv));
+    }
+
+    inline const char *Name(PositionFormat format)
+    {
+        return format == PositionFormat::Snorm16 ? "snorm16" : "half";
+    }
+}
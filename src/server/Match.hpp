@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <game/Ball.hpp>
+#include <game/Physics.hpp>
+#include <game/ShotCache.hpp>
+#include <game/ShotSimulator.hpp>
+#include <game/Table.hpp>
+
+// Матч на сервере: только состояние стола между ударами. Физика (с её буферами контактов)
+// принадлежит рабочему потоку и берётся на время удара, так что простаивающий матч —
+// это лишь расстановка шаров в памяти и не тратит процессор.
+struct Match
+{
+    static constexpr float kBallRadius = 0.05f;
+    static constexpr float kBallMass = 1.0f;
+
+    uint32_t id = 0;
+    uint64_t owner = 0; // Соединение, создавшее матч
+    std::vector<Ball> balls;
+    bool busy = false;    // Удар передан рабочему потоку
+    std::atomic<bool> closing{false}; // Владелец ушёл — удалить после текущего удара; читает и рабочий поток
+
+    // Память матча: сам объект и буфер шаров
+    size_t MemoryBytes() const { return sizeof(Match) + balls.capacity() * sizeof(Ball); }
+};
+
+// Итог удара для ответа клиенту
+struct MatchShotResult
+{
+    uint32_t pocketedMask = 0;
+    int32_t firstContact = -1;
+    float simulatedSeconds = 0.0f;
+};
+
+// Удар до полной остановки шаров. physics — рабочего потока, её контакты сбрасываются.
+inline MatchShotResult ResolveShot(Match &match, Physics &physics, const TableGeometry &table,
+                                   const ShotParams &shot, float maxForce)
+{
+    std::vector<Ball> &balls = match.balls;
+    MatchShotResult result;
+
+    // Биток после прошлого удара в лузе — на исходную точку
+    if (IsPocketed(balls[0]))
+        balls[0] = Ball(glm::vec3(-0.8f, Match::kBallRadius, 0.0f), Match::kBallRadius, Match::kBallMass);
+
+    physics.ResetContacts();
+    ShotSimulator::ApplyShot(balls[0], shot, maxForce);
+
+    const int maxTicks = static_cast<int>(ShotSimulator::kMaxDuration / ShotSimulator::kTickSeconds);
+    int tick = 0;
+    for (; tick < maxTicks; ++tick)
+    {
+        physics.Update(balls, ShotSimulator::kTickSeconds);
+        result.pocketedMask |= CollectPocketed(balls, table);
+
+        bool moving = false;
+        for (size_t i = 0; i < balls.size(); ++i)
+        {
+            if (!balls[i].isMoving())
+                continue;
+            moving = true;
+            if (i > 0 && result.firstContact < 0)
+                result.firstContact = static_cast<int32_t>(i);
+        }
+        if (!moving)
+            break;
+    }
+    result.simulatedSeconds = tick * ShotSimulator::kTickSeconds;
+
+    // Авторитетная остановка: остаточные скорости ниже порога обнуляются
+    for (Ball &ball : balls)
+        ball.setVelocity(glm::vec3(0.0f));
+
+    // Все прицельные шары забиты — новая партия к следующему удару
+    bool cleared = true;
+    for (size_t i = 1; i < balls.size(); ++i)
+        cleared &= IsPocketed(balls[i]);
+    if (cleared)
+        balls = RackBalls(Match::kBallRadius, Match::kBallMass);
+    return result;
+}
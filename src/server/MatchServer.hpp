@@ -0,0 +1,620 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "Match.hpp"
+#include "Protocol.hpp"
+#include "WorkerPool.hpp"
+
+// Авторитетный сервер матчей. Один поток с epoll принимает соединения, разбирает команды
+// и отвечает клиентам; удары считаются в пуле рабочих потоков, а готовые результаты
+// возвращаются в поток epoll через eventfd. Матч без удара не занимает ни поток, ни таймер.
+class MatchServer
+{
+public:
+    struct Options
+    {
+        int tcpPort = 0;        // 0 — без TCP; слушает только 127.0.0.1
+        std::string unixPath;   // Пусто — без Unix-сокета
+        size_t workers = 0;     // 0 — по числу ядер
+        double statsInterval = 5.0;
+    };
+
+    MatchServer() = default;
+    ~MatchServer();
+
+    MatchServer(const MatchServer &) = delete;
+    MatchServer &operator=(const MatchServer &) = delete;
+
+    bool Init(const Options &options);
+
+    // Цикл событий до Stop() (можно вызывать из обработчика сигнала)
+    void Run();
+    void Stop() { stopping.store(true); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // За один проход читается не больше kMaxInputBytes, остальное ждёт разбора уже прочитанного.
+    // Клиент, который не забирает ответы, закрывается, когда неотправленное превысит kMaxOutputBytes
+    static constexpr size_t kMaxInputBytes = 4 * (sizeof(Protocol::Header) + Protocol::kMaxMessageSize);
+    static constexpr size_t kMaxOutputBytes = 4 * 1024 * 1024;
+
+    struct Connection
+    {
+        uint64_t id = 0;
+        int fd = -1;
+        std::vector<uint8_t> input;
+        std::vector<uint8_t> output;
+        size_t outputSent = 0;
+        bool writeArmed = false; // Ждём EPOLLOUT
+        std::vector<uint32_t> matches;
+    };
+
+    struct Job
+    {
+        Match *match = nullptr;
+        uint64_t connection = 0;
+        uint32_t requestId = 0;
+        ShotParams shot;
+        Clock::time_point received;
+    };
+
+    struct Completion
+    {
+        Job job;
+        MatchShotResult result;
+    };
+
+    Options options;
+    TableGeometry table;
+    float friction = 0.1f;
+    float maxForce = 5.0f;
+
+    int epollFd = -1;
+    int tcpFd = -1;
+    int unixFd = -1;
+    int wakeFd = -1; // eventfd: рабочие потоки сообщают о готовых ударах
+    std::atomic<bool> stopping{false};
+
+    std::unordered_map<int, std::unique_ptr<Connection>> connections; // По дескриптору
+    std::unordered_map<uint64_t, Connection *> connectionsById;
+    uint64_t nextConnectionId = 1;
+
+    std::unordered_map<uint32_t, std::unique_ptr<Match>> matches;
+    uint32_t nextMatchId = 1;
+    size_t matchBytes = 0; // Суммарная память матчей
+
+    WorkerPool<Job> pool;
+    std::vector<std::unique_ptr<Physics>> workerPhysics; // Своя физика у каждого рабочего потока
+
+    std::mutex completedMutex;
+    std::vector<Completion> completed;
+    std::vector<Completion> completedLocal;
+
+    // Статистика за интервал
+    Clock::time_point statsStart;
+    size_t shotsResolved = 0;
+    std::vector<float> latenciesMs;
+
+    bool Listen();
+    void Accept(int listenFd);
+    void CloseConnection(Connection &connection);
+    void OnReadable(Connection &connection);
+    void HandleMessage(Connection &connection, const Protocol::Header &header, const uint8_t *body);
+    // false — соединение закрыто (ссылка больше недействительна)
+    bool Flush(Connection &connection);
+    bool AddToEpoll(int fd, uint32_t events);
+    void DrainCompleted();
+    void ReleaseMatch(uint32_t matchId);
+    void ReportStats();
+
+    // Удаляет файл, только если это сокет: путь из командной строки может указывать на что угодно
+    static bool UnlinkSocket(const std::string &path);
+
+    void Resolve(size_t worker, Job &job);
+};
+
+inline MatchServer::~MatchServer()
+{
+    pool.Stop();
+    for (auto &entry : connections)
+        ::close(entry.first);
+    for (int fd : {tcpFd, unixFd, wakeFd, epollFd})
+    {
+        if (fd >= 0)
+            ::close(fd);
+    }
+    if (unixFd >= 0)
+        UnlinkSocket(options.unixPath);
+}
+
+inline bool MatchServer::Init(const Options &serverOptions)
+{
+    options = serverOptions;
+    maxForce = Cue().getMaxForce();
+
+    epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    wakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epollFd < 0 || wakeFd < 0)
+        return false;
+
+    if (!AddToEpoll(wakeFd, EPOLLIN) || !Listen())
+        return false;
+
+    size_t workers = options.workers ? options.workers : std::max(1u, std::thread::hardware_concurrency());
+    for (size_t i = 0; i < workers; ++i)
+        workerPhysics.push_back(std::make_unique<Physics>(table.width, table.height, friction));
+    pool.Start(workers, [this](size_t worker, Job &job)
+               { Resolve(worker, job); });
+
+    statsStart = Clock::now();
+    std::cout << "[Server] " << workers << " workers";
+    if (tcpFd >= 0)
+        std::cout << ", tcp 127.0.0.1:" << options.tcpPort;
+    if (unixFd >= 0)
+        std::cout << ", unix " << options.unixPath;
+    std::cout << std::endl;
+    return true;
+}
+
+inline bool MatchServer::Listen()
+{
+    if (options.tcpPort > 0)
+    {
+        tcpFd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        const int one = 1;
+        ::setsockopt(tcpFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(options.tcpPort));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::bind(tcpFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || ::listen(tcpFd, SOMAXCONN) < 0)
+        {
+            std::cerr << "[Server] tcp listen failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (!AddToEpoll(tcpFd, EPOLLIN))
+            return false;
+    }
+
+    if (!options.unixPath.empty())
+    {
+        unixFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, options.unixPath.c_str(), sizeof(address.sun_path) - 1);
+        // Старый сокет от прошлого запуска убираем; любой другой файл по этому пути не трогаем
+        if (!UnlinkSocket(options.unixPath))
+        {
+            std::cerr << "[Server] " << options.unixPath << " exists and is not a socket" << std::endl;
+            return false;
+        }
+        if (::bind(unixFd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0 || ::listen(unixFd, SOMAXCONN) < 0)
+        {
+            std::cerr << "[Server] unix listen failed: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (!AddToEpoll(unixFd, EPOLLIN))
+            return false;
+    }
+
+    return tcpFd >= 0 || unixFd >= 0;
+}
+
+inline bool MatchServer::AddToEpoll(int fd, uint32_t events)
+{
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = fd;
+    if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) == 0)
+        return true;
+    std::cerr << "[Server] epoll_ctl add failed: " << std::strerror(errno) << std::endl;
+    return false;
+}
+
+inline bool MatchServer::UnlinkSocket(const std::string &path)
+{
+    struct stat status;
+    if (::lstat(path.c_str(), &status) != 0)
+        return errno == ENOENT;
+    if (!S_ISSOCK(status.st_mode))
+        return false;
+    return ::unlink(path.c_str()) == 0 || errno == ENOENT;
+}
+
+inline void MatchServer::Run()
+{
+    std::vector<epoll_event> events(256);
+    while (!stopping.load())
+    {
+        const int count = ::epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), 1000);
+        if (count < 0 && errno != EINTR)
+            break;
+
+        for (int i = 0; i < count; ++i)
+        {
+            const int fd = events[i].data.fd;
+            if (fd == tcpFd || fd == unixFd)
+            {
+                Accept(fd);
+                continue;
+            }
+            if (fd == wakeFd)
+            {
+                uint64_t value;
+                while (::read(wakeFd, &value, sizeof(value)) > 0)
+                {
+                }
+                DrainCompleted();
+                continue;
+            }
+
+            auto it = connections.find(fd);
+            if (it == connections.end())
+                continue;
+            Connection &connection = *it->second;
+            if (events[i].events & (EPOLLHUP | EPOLLERR))
+            {
+                CloseConnection(connection);
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && !Flush(connection))
+                continue;
+            if (events[i].events & EPOLLIN)
+                OnReadable(connection);
+        }
+
+        if (std::chrono::duration<double>(Clock::now() - statsStart).count() >= options.statsInterval)
+            ReportStats();
+    }
+}
+
+inline void MatchServer::Accept(int listenFd)
+{
+    for (;;)
+    {
+        const int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0)
+            return;
+        if (listenFd == tcpFd)
+        {
+            const int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        if (!AddToEpoll(fd, EPOLLIN | EPOLLRDHUP))
+        {
+            ::close(fd);
+            continue;
+        }
+
+        auto connection = std::make_unique<Connection>();
+        connection->id = nextConnectionId++;
+        connection->fd = fd;
+        connectionsById[connection->id] = connection.get();
+        connections[fd] = std::move(connection);
+    }
+}
+
+inline void MatchServer::CloseConnection(Connection &connection)
+{
+    // Матчи владельца удаляются; считающиеся сейчас — после завершения удара
+    for (uint32_t matchId : connection.matches)
+    {
+        auto it = matches.find(matchId);
+        if (it == matches.end())
+            continue;
+        if (it->second->busy)
+            it->second->closing = true;
+        else
+            ReleaseMatch(matchId);
+    }
+
+    const int fd = connection.fd;
+    // Ошибка здесь не важна: close ниже всё равно снимает дескриптор с epoll
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+    connectionsById.erase(connection.id);
+    connections.erase(fd);
+}
+
+inline void MatchServer::OnReadable(Connection &connection)
+{
+    uint8_t buffer[16 * 1024];
+    // Остаток сокета прочитается в следующий раз: epoll снова сообщит о готовности
+    while (connection.input.size() < kMaxInputBytes)
+    {
+        const ssize_t received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+        if (received > 0)
+        {
+            connection.input.insert(connection.input.end(), buffer, buffer + received);
+            continue;
+        }
+        if (received == 0 || (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR))
+        {
+            CloseConnection(connection);
+            return;
+        }
+        if (errno != EINTR)
+            break;
+    }
+
+    size_t offset = 0;
+    Protocol::Header header;
+    const uint8_t *body = nullptr;
+    size_t consumed = 0;
+    for (;;)
+    {
+        const uint8_t *data = connection.input.data() + offset;
+        const size_t available = connection.input.size() - offset;
+        // Заведомо неверный размер кадра — не ждать его, а закрыть соединение
+        if (available >= sizeof(Protocol::Header))
+        {
+            std::memcpy(&header, data, sizeof(header));
+            if (header.size > Protocol::kMaxMessageSize)
+            {
+                CloseConnection(connection);
+                return;
+            }
+        }
+        if (!Protocol::Next(data, available, header, body, consumed))
+            break;
+        HandleMessage(connection, header, body);
+        offset += consumed;
+    }
+    connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+    Flush(connection);
+}
+
+inline void MatchServer::HandleMessage(Connection &connection, const Protocol::Header &header, const uint8_t *body)
+{
+    switch (header.type)
+    {
+    case Protocol::MessageType::CreateMatch:
+    {
+        Protocol::CreateMatch request;
+        if (!Protocol::Read(body, header.size, request))
+            return;
+        auto match = std::make_unique<Match>();
+        match->id = nextMatchId++;
+        match->owner = connection.id;
+        match->balls = RackBalls(Match::kBallRadius, Match::kBallMass);
+        matchBytes += match->MemoryBytes();
+        connection.matches.push_back(match->id);
+
+        const Protocol::MatchCreated reply{request.requestId, match->id};
+        matches[match->id] = std::move(match);
+        Protocol::Append(connection.output, Protocol::MessageType::MatchCreated, reply);
+        break;
+    }
+    case Protocol::MessageType::Shot:
+    {
+        Protocol::Shot request;
+        if (!Protocol::Read(body, header.size, request))
+            return;
+        auto it = matches.find(request.matchId);
+        Protocol::ShotStatus status = Protocol::ShotStatus::Ok;
+        if (it == matches.end() || it->second->closing)
+            status = Protocol::ShotStatus::UnknownMatch;
+        else if (it->second->owner != connection.id)
+            status = Protocol::ShotStatus::NotOwner; // Бить может только создатель матча
+        else if (it->second->busy)
+            status = Protocol::ShotStatus::MatchBusy;
+        if (status != Protocol::ShotStatus::Ok)
+        {
+            Protocol::ShotResult reply{};
+            reply.matchId = request.matchId;
+            reply.requestId = request.requestId;
+            reply.status = status;
+            reply.firstContact = -1;
+            Protocol::Append(connection.output, Protocol::MessageType::ShotResult, reply);
+            return;
+        }
+
+        Job job;
+        job.match = it->second.get();
+        job.connection = connection.id;
+        job.requestId = request.requestId;
+        job.shot.angle = request.angle;
+        job.shot.power = request.power;
+        job.shot.offsetX = request.offsetX;
+        job.shot.offsetY = request.offsetY;
+        job.received = Clock::now();
+        job.match->busy = true;
+        pool.Push(job);
+        break;
+    }
+    case Protocol::MessageType::CloseMatch:
+    {
+        Protocol::CloseMatch request;
+        if (!Protocol::Read(body, header.size, request))
+            return;
+        auto it = matches.find(request.matchId);
+        if (it == matches.end() || it->second->owner != connection.id)
+            return;
+        auto &owned = connection.matches;
+        owned.erase(std::remove(owned.begin(), owned.end(), request.matchId), owned.end());
+        if (it->second->busy)
+            it->second->closing = true;
+        else
+            ReleaseMatch(request.matchId);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+inline bool MatchServer::Flush(Connection &connection)
+{
+    while (connection.outputSent < connection.output.size())
+    {
+        const ssize_t sent = ::send(connection.fd, connection.output.data() + connection.outputSent,
+                                    connection.output.size() - connection.outputSent, MSG_NOSIGNAL);
+        if (sent > 0)
+        {
+            connection.outputSent += static_cast<size_t>(sent);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR)
+            continue;
+        break;
+    }
+
+    const bool pending = connection.outputSent < connection.output.size();
+    if (!pending)
+    {
+        connection.output.clear();
+        connection.outputSent = 0;
+    }
+    else if (connection.output.size() - connection.outputSent > kMaxOutputBytes)
+    {
+        std::cerr << "[Server] connection " << connection.id << " does not read replies, closing" << std::endl;
+        CloseConnection(connection);
+        return false;
+    }
+
+    // EPOLLOUT нужен, только пока сокет не принимает весь ответ
+    if (pending != connection.writeArmed)
+    {
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLRDHUP | (pending ? static_cast<uint32_t>(EPOLLOUT) : 0u);
+        event.data.fd = connection.fd;
+        if (::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event) != 0)
+        {
+            // Без EPOLLOUT остаток ответа не уйдёт никогда
+            std::cerr << "[Server] epoll_ctl mod failed: " << std::strerror(errno) << std::endl;
+            CloseConnection(connection);
+            return false;
+        }
+        connection.writeArmed = pending;
+    }
+    return true;
+}
+
+inline void MatchServer::Resolve(size_t worker, Job &job)
+{
+    Completion completion;
+    completion.job = job;
+    // Владелец ушёл, пока удар стоял в очереди, — считать незачем
+    if (!job.match->closing.load(std::memory_order_relaxed))
+        completion.result = ResolveShot(*job.match, *workerPhysics[worker], table, job.shot, maxForce);
+
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        wake = completed.empty();
+        completed.push_back(completion);
+    }
+    // Пока поток epoll не забрал предыдущие результаты, будить его повторно не нужно
+    if (wake)
+    {
+        const uint64_t one = 1;
+        [[maybe_unused]] ssize_t written = ::write(wakeFd, &one, sizeof(one));
+    }
+}
+
+inline void MatchServer::DrainCompleted()
+{
+    {
+        std::lock_guard<std::mutex> lock(completedMutex);
+        completedLocal.swap(completed);
+    }
+
+    const Clock::time_point now = Clock::now();
+    std::vector<float> positions;
+    for (const Completion &completion : completedLocal)
+    {
+        Match &match = *completion.job.match;
+        match.busy = false;
+        if (match.closing)
+        {
+            ReleaseMatch(match.id);
+            continue;
+        }
+        ++shotsResolved;
+        latenciesMs.push_back(std::chrono::duration<float, std::milli>(now - completion.job.received).count());
+
+        auto it = connectionsById.find(completion.job.connection);
+        if (it != connectionsById.end())
+        {
+            Connection &connection = *it->second;
+            positions.clear();
+            for (const Ball &ball : match.balls)
+            {
+                const glm::vec3 &position = ball.getPosition();
+                positions.insert(positions.end(), {position.x, position.y, position.z});
+            }
+
+            Protocol::ShotResult reply{};
+            reply.matchId = match.id;
+            reply.requestId = completion.job.requestId;
+            reply.status = Protocol::ShotStatus::Ok;
+            reply.pocketedMask = completion.result.pocketedMask;
+            reply.firstContact = completion.result.firstContact;
+            reply.simulatedSeconds = completion.result.simulatedSeconds;
+            reply.ballCount = static_cast<uint32_t>(match.balls.size());
+            Protocol::Append(connection.output, Protocol::MessageType::ShotResult, &reply, sizeof(reply),
+                             positions.data(), positions.size() * sizeof(float));
+            Flush(connection);
+        }
+    }
+    completedLocal.clear();
+}
+
+inline void MatchServer::ReleaseMatch(uint32_t matchId)
+{
+    auto it = matches.find(matchId);
+    if (it == matches.end())
+        return;
+    matchBytes -= it->second->MemoryBytes();
+    matches.erase(it);
+}
+
+inline void MatchServer::ReportStats()
+{
+    const double seconds = std::chrono::duration<double>(Clock::now() - statsStart).count();
+    float p50 = 0.0f, p99 = 0.0f;
+    if (!latenciesMs.empty())
+    {
+        auto percentile = [this](float p)
+        {
+            const size_t index = std::min(latenciesMs.size() - 1, static_cast<size_t>(p * latenciesMs.size()));
+            std::nth_element(latenciesMs.begin(), latenciesMs.begin() + index, latenciesMs.end());
+            return latenciesMs[index];
+        };
+        p50 = percentile(0.50f);
+        p99 = percentile(0.99f);
+    }
+
+    const double shotsPerSecond = shotsResolved / seconds;
+    std::cout << "[Server] connections " << connections.size() << ", matches " << matches.size()
+              << " (" << matchBytes / 1024 << " KB, " << (matches.empty() ? 0 : matchBytes / matches.size())
+              << " B/match), shots " << shotsPerSecond << "/s (" << shotsPerSecond / pool.ThreadCount()
+              << "/s per worker), queue " << pool.QueueDepth() << ", latency p50 " << p50
+              << " ms p99 " << p99 << " ms" << std::endl;
+
+    statsStart = Clock::now();
+    shotsResolved = 0;
+    latenciesMs.clear();
+}
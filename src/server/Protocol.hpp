@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+// Протокол сервера матчей: поток кадров «заголовок + тело» поверх TCP или Unix-сокета.
+// Структуры передаются как есть (порядок байт хоста) — сервер и клиенты на одной машине.
+namespace Protocol
+{
+    enum class MessageType : uint16_t
+    {
+        CreateMatch = 1, // Клиент → сервер: новый матч со стандартной расстановкой
+        MatchCreated,    // Сервер → клиент
+        Shot,            // Клиент → сервер: удар в матче
+        ShotResult,      // Сервер → клиент: итог удара и положения шаров
+        CloseMatch,      // Клиент → сервер
+    };
+
+    enum class ShotStatus : int32_t
+    {
+        Ok = 0,
+        UnknownMatch,
+        MatchBusy, // Предыдущий удар ещё считается
+        NotOwner,  // Матч создан другим соединением
+    };
+
+    struct Header
+    {
+        uint32_t size; // Размер тела без заголовка
+        MessageType type;
+        uint16_t reserved;
+    };
+
+    struct CreateMatch
+    {
+        uint32_t requestId;
+    };
+
+    struct MatchCreated
+    {
+        uint32_t requestId;
+        uint32_t matchId;
+    };
+
+    // Параметры как в ShotParams: угол в 1/100 градуса, сила и смещения в 1/256
+    struct Shot
+    {
+        uint32_t matchId;
+        uint32_t requestId;
+        int32_t angle;
+        int32_t power;
+        int32_t offsetX;
+        int32_t offsetY;
+    };
+
+    // За ним следует ballCount * 3 float — положения шаров после остановки
+    struct ShotResult
+    {
+        uint32_t matchId;
+        uint32_t requestId;
+        ShotStatus status;
+        uint32_t pocketedMask;
+        int32_t firstContact;
+        float simulatedSeconds;
+        uint32_t ballCount;
+    };
+
+    struct CloseMatch
+    {
+        uint32_t matchId;
+    };
+
+    constexpr uint32_t kMaxMessageSize = 64 * 1024;
+
+    // Дописывает кадр в исходящий буфер
+    inline void Append(std::vector<uint8_t> &out, MessageType type, const void *body, size_t size,
+                       const void *tail = nullptr, size_t tailSize = 0)
+    {
+        const Header header{static_cast<uint32_t>(size + tailSize), type, 0};
+        const size_t offset = out.size();
+        out.resize(offset + sizeof(Header) + size + tailSize);
+        std::memcpy(out.data() + offset, &header, sizeof(Header));
+        std::memcpy(out.data() + offset + sizeof(Header), body, size);
+        if (tailSize)
+            std::memcpy(out.data() + offset + sizeof(Header) + size, tail, tailSize);
+    }
+
+    template <typename T>
+    void Append(std::vector<uint8_t> &out, MessageType type, const T &body)
+    {
+        Append(out, type, &body, sizeof(T));
+    }
+
+    // Очередной полный кадр из входящего буфера: тело и его размер; false — кадр ещё не дочитан.
+    // consumed — сколько байт занимает кадр целиком.
+    inline bool Next(const uint8_t *data, size_t size, Header &header, const uint8_t *&body, size_t &consumed)
+    {
+        if (size < sizeof(Header))
+            return false;
+        std::memcpy(&header, data, sizeof(Header));
+        if (size < sizeof(Header) + header.size)
+            return false;
+        body = data + sizeof(Header);
+        consumed = sizeof(Header) + header.size;
+        return true;
+    }
+
+    template <typename T>
+    bool Read(const uint8_t *body, size_t size, T &out)
+    {
+        if (size < sizeof(T))
+            return false;
+        std::memcpy(&out, body, sizeof(T));
+        return true;
+    }
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Пул рабочих потоков с общей очередью задач. Задача — значение типа Job;
+// обработчик получает номер потока, чтобы пользоваться его собственным состоянием.
+template <typename Job>
+class WorkerPool
+{
+public:
+    using Handler = std::function<void(size_t worker, Job &job)>;
+
+    WorkerPool() = default;
+    ~WorkerPool() { Stop(); }
+
+    WorkerPool(const WorkerPool &) = delete;
+    WorkerPool &operator=(const WorkerPool &) = delete;
+
+    void Start(size_t threadCount, Handler handler);
+    void Stop();
+
+    void Push(const Job &job);
+
+    size_t ThreadCount() const { return threads.size(); }
+    size_t QueueDepth() const;
+
+private:
+    Handler handler;
+    std::vector<std::thread> threads;
+    std::deque<Job> jobs;
+    mutable std::mutex mutex;
+    std::condition_variable available;
+    bool stopping = false;
+
+    void Run(size_t worker);
+};
+
+template <typename Job>
+void WorkerPool<Job>::Start(size_t threadCount, Handler jobHandler)
+{
+    handler = std::move(jobHandler);
+    stopping = false;
+    for (size_t i = 0; i < threadCount; ++i)
+        threads.emplace_back(&WorkerPool::Run, this, i);
+}
+
+template <typename Job>
+void WorkerPool<Job>::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    available.notify_all();
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+}
+
+template <typename Job>
+void WorkerPool<Job>::Push(const Job &job)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        jobs.push_back(job);
+    }
+    available.notify_one();
+}
+
+template <typename Job>
+size_t WorkerPool<Job>::QueueDepth() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return jobs.size();
+}
+
+template <typename Job>
+void WorkerPool<Job>::Run(size_t worker)
+{
+    for (;;)
+    {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            available.wait(lock, [this]
+                           { return stopping || !jobs.empty(); });
+            if (jobs.empty())
+                return;
+            job = jobs.front();
+            jobs.pop_front();
+        }
+        handler(worker, job);
+    }
+}
@@ -0,0 +1,310 @@
+// Генератор нагрузки для сервера матчей: открывает соединения на localhost, создаёт матчи
+// и бьёт в каждом по одному удару за раз. Меряет задержку удара (отправка → результат)
+// и пропускную способность, по которой оценивается число матчей на ядро.
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <queue>
+#include <random>
+#include <string>
+#include <vector>
+#include "Protocol.hpp"
+
+using Clock = std::chrono::steady_clock;
+
+// Параметры командной строки
+//   --port <N> | --unix <path>   адрес сервера
+//   --connections <N>            число соединений
+//   --matches <N>                число матчей (распределяются по соединениям)
+//   --duration <sec>             длительность замера
+//   --think <ms>                 пауза между ударами в матче (0 — сразу следующий)
+//   --shot-interval <sec>        темп реальной партии для оценки матчей на ядро
+//   --cores <N>                  сколько ядер отдано рабочим потокам сервера
+struct LoadOptions
+{
+    int tcpPort = 0;
+    std::string unixPath;
+    int connections = 4;
+    int matches = 1000;
+    double duration = 10.0;
+    double thinkMs = 0.0;
+    double shotInterval = 15.0;
+    int cores = 1;
+};
+
+struct Client
+{
+    int fd = -1;
+    std::vector<uint8_t> input;
+    std::vector<uint8_t> output;
+};
+
+struct MatchState
+{
+    uint32_t id = 0;
+    int client = 0;
+    Clock::time_point sentAt;
+};
+
+static bool ParseOptions(int argc, char **argv, LoadOptions &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+            options.tcpPort = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--unix") == 0 && i + 1 < argc)
+            options.unixPath = argv[++i];
+        else if (std::strcmp(argv[i], "--connections") == 0 && i + 1 < argc)
+            options.connections = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc)
+            options.matches = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "--duration") == 0 && i + 1 < argc)
+            options.duration = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--think") == 0 && i + 1 < argc)
+            options.thinkMs = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--shot-interval") == 0 && i + 1 < argc)
+            options.shotInterval = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--cores") == 0 && i + 1 < argc)
+            options.cores = std::atoi(argv[++i]);
+        else
+            return false;
+    }
+    return (options.tcpPort > 0 || !options.unixPath.empty()) && options.connections > 0 &&
+           options.matches > 0 && options.duration > 0.0 && options.cores > 0;
+}
+
+static int Connect(const LoadOptions &options)
+{
+    int fd = -1;
+    if (!options.unixPath.empty())
+    {
+        fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_un address{};
+        address.sun_family = AF_UNIX;
+        std::strncpy(address.sun_path, options.unixPath.c_str(), sizeof(address.sun_path) - 1);
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+    }
+    else
+    {
+        fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(static_cast<uint16_t>(options.tcpPort));
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (::connect(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) < 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        const int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+// Запросов в полёте не больше, чем матчей, так что блокирующая запись не упрётся в сервер
+static bool Flush(Client &client)
+{
+    size_t sent = 0;
+    while (sent < client.output.size())
+    {
+        const ssize_t written = ::send(client.fd, client.output.data() + sent, client.output.size() - sent, MSG_NOSIGNAL);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written <= 0)
+            return false;
+        sent += static_cast<size_t>(written);
+    }
+    client.output.clear();
+    return true;
+}
+
+static float Percentile(std::vector<float> &values, float p)
+{
+    if (values.empty())
+        return 0.0f;
+    const size_t index = std::min(values.size() - 1, static_cast<size_t>(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char **argv)
+{
+    LoadOptions options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr,
+                     "Usage: %s (--port <N> | --unix <path>) [--connections <N>] [--matches <N>] [--duration <sec>]\n"
+                     "          [--think <ms>] [--shot-interval <sec>] [--cores <N>]\n",
+                     argv[0]);
+        return 1;
+    }
+
+    const int epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+    std::vector<Client> clients(options.connections);
+    for (int i = 0; i < options.connections; ++i)
+    {
+        clients[i].fd = Connect(options);
+        if (clients[i].fd < 0)
+        {
+            std::fprintf(stderr, "connect failed: %s\n", std::strerror(errno));
+            return 1;
+        }
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = static_cast<uint32_t>(i);
+        ::epoll_ctl(epollFd, EPOLL_CTL_ADD, clients[i].fd, &event);
+    }
+
+    // Номер запроса — индекс матча у генератора
+    std::vector<MatchState> matches(options.matches);
+    for (int i = 0; i < options.matches; ++i)
+    {
+        matches[i].client = i % options.connections;
+        const Protocol::CreateMatch request{static_cast<uint32_t>(i)};
+        Protocol::Append(clients[matches[i].client].output, Protocol::MessageType::CreateMatch, request);
+    }
+    for (Client &client : clients)
+        Flush(client);
+
+    std::mt19937 rng(12345);
+    std::uniform_int_distribution<int32_t> angle(0, 36000 - 1);
+    std::uniform_int_distribution<int32_t> power(64, 256);
+    std::uniform_int_distribution<int32_t> offset(-96, 96);
+
+    auto sendShot = [&](uint32_t index)
+    {
+        MatchState &match = matches[index];
+        Protocol::Shot shot{match.id, index, angle(rng), power(rng), offset(rng), offset(rng)};
+        Protocol::Append(clients[match.client].output, Protocol::MessageType::Shot, shot);
+        match.sentAt = Clock::now();
+    };
+
+    // Отложенные удары при --think: (время, матч), ближайший сверху
+    using Pending = std::pair<Clock::time_point, uint32_t>;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>> pending;
+    const auto think = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(options.thinkMs));
+    auto scheduleShot = [&](uint32_t index)
+    {
+        if (options.thinkMs > 0.0)
+            pending.emplace(Clock::now() + think, index);
+        else
+            sendShot(index);
+    };
+
+    int created = 0;
+    size_t shots = 0;
+    size_t rejected = 0;
+    std::vector<float> latenciesMs;
+    Clock::time_point start = Clock::now();
+    Clock::time_point end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+    bool measuring = false;
+
+    std::vector<epoll_event> events(64);
+    uint8_t buffer[64 * 1024];
+    while (!measuring || Clock::now() < end)
+    {
+        int timeoutMs = 100;
+        if (!pending.empty())
+        {
+            const auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(pending.top().first - Clock::now()).count();
+            timeoutMs = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(wait, timeoutMs)));
+        }
+
+        const int count = ::epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), timeoutMs);
+        for (int e = 0; e < count; ++e)
+        {
+            Client &client = clients[events[e].data.u32];
+            const ssize_t received = ::recv(client.fd, buffer, sizeof(buffer), 0);
+            if (received <= 0)
+            {
+                std::fprintf(stderr, "server closed the connection\n");
+                return 1;
+            }
+            client.input.insert(client.input.end(), buffer, buffer + received);
+
+            size_t offsetBytes = 0;
+            Protocol::Header header;
+            const uint8_t *body = nullptr;
+            size_t consumed = 0;
+            while (Protocol::Next(client.input.data() + offsetBytes, client.input.size() - offsetBytes, header, body, consumed))
+            {
+                offsetBytes += consumed;
+                if (header.type == Protocol::MessageType::MatchCreated)
+                {
+                    Protocol::MatchCreated reply;
+                    Protocol::Read(body, header.size, reply);
+                    matches[reply.requestId].id = reply.matchId;
+                    scheduleShot(reply.requestId);
+                    // Замер начинается, когда созданы все матчи
+                    if (++created == options.matches)
+                    {
+                        measuring = true;
+                        start = Clock::now();
+                        end = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(options.duration));
+                    }
+                }
+                else if (header.type == Protocol::MessageType::ShotResult)
+                {
+                    Protocol::ShotResult reply;
+                    Protocol::Read(body, header.size, reply);
+                    if (reply.status != Protocol::ShotStatus::Ok)
+                        ++rejected;
+                    else if (measuring)
+                    {
+                        ++shots;
+                        latenciesMs.push_back(std::chrono::duration<float, std::milli>(Clock::now() - matches[reply.requestId].sentAt).count());
+                    }
+                    scheduleShot(reply.requestId);
+                }
+            }
+            client.input.erase(client.input.begin(), client.input.begin() + offsetBytes);
+        }
+
+        const Clock::time_point now = Clock::now();
+        while (!pending.empty() && pending.top().first <= now)
+        {
+            sendShot(pending.top().second);
+            pending.pop();
+        }
+        for (Client &client : clients)
+        {
+            if (!client.output.empty() && !Flush(client))
+            {
+                std::fprintf(stderr, "send failed: %s\n", std::strerror(errno));
+                return 1;
+            }
+        }
+    }
+
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    const double shotsPerSecond = shots / seconds;
+    const float p50 = Percentile(latenciesMs, 0.50f);
+    const float p99 = Percentile(latenciesMs, 0.99f);
+    std::printf("matches %d over %d connections, %.1f s\n", options.matches, options.connections, seconds);
+    std::printf("shots %zu (%.0f/s, %.0f/s per core), rejected %zu\n", shots, shotsPerSecond,
+                shotsPerSecond / options.cores, rejected);
+    std::printf("shot latency p50 %.2f ms, p99 %.2f ms\n", p50, p99);
+    // Матч с ударом раз в shotInterval секунд тратит 1/shotInterval ударов в секунду
+    std::printf("capacity at one shot per %.0f s: %.0f matches per core\n", options.shotInterval,
+                shotsPerSecond * options.shotInterval / options.cores);
+
+    for (Client &client : clients)
+        ::close(client.fd);
+    ::close(epollFd);
+    return 0;
+}
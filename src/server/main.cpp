@@ -0,0 +1,77 @@
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include "MatchServer.hpp"
+
+// Параметры командной строки
+//   --port <N>       слушать 127.0.0.1:N
+//   --unix <path>    слушать Unix-сокет
+//   --workers <N>    число рабочих потоков (по умолчанию — по числу ядер)
+//   --stats <sec>    интервал вывода статистики
+static bool ParseOptions(int argc, char **argv, MatchServer::Options &options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc)
+        {
+            options.tcpPort = std::atoi(argv[++i]);
+            if (options.tcpPort <= 0 || options.tcpPort > 65535)
+                return false;
+        }
+        else if (std::strcmp(argv[i], "--unix") == 0 && i + 1 < argc)
+        {
+            options.unixPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc)
+        {
+            const int workers = std::atoi(argv[++i]);
+            if (workers <= 0)
+                return false;
+            options.workers = static_cast<size_t>(workers);
+        }
+        else if (std::strcmp(argv[i], "--stats") == 0 && i + 1 < argc)
+        {
+            options.statsInterval = std::atof(argv[++i]);
+            if (options.statsInterval <= 0.0)
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return options.tcpPort > 0 || !options.unixPath.empty();
+}
+
+static MatchServer *runningServer = nullptr;
+
+static void OnSignal(int)
+{
+    if (runningServer)
+        runningServer->Stop();
+}
+
+int main(int argc, char **argv)
+{
+    MatchServer::Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr, "Usage: %s [--port <N>] [--unix <path>] [--workers <N>] [--stats <sec>]\n", argv[0]);
+        return 1;
+    }
+
+    MatchServer server;
+    if (!server.Init(options))
+        return 1;
+
+    runningServer = &server;
+    std::signal(SIGINT, OnSignal);
+    std::signal(SIGTERM, OnSignal);
+    server.Run();
+    runningServer = nullptr;
+
+    std::cout << "[Server] Stopped" << std::endl;
+    return 0;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+// Проверка для тестов: печатает место и условие, тест завершается с кодом 1 в конце main
+inline int &CheckFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(condition)                                                                             \
+    do                                                                                               \
+    {                                                                                                \
+        if (!(condition))                                                                            \
+        {                                                                                            \
+            std::cerr << __FILE__ << ':' << __LINE__ << ": CHECK(" #condition ") failed" << std::endl; \
+            ++CheckFailures();                                                                       \
+        }                                                                                            \
+    } while (false)
+
+inline int TestResult(const char *name)
+{
+    if (CheckFailures() == 0)
+        std::cout << "[" << name << "] passed" << std::endl;
+    else
+        std::cerr << "[" << name << "] " << CheckFailures() << " checks failed" << std::endl;
+    return CheckFailures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,120 @@
+// Установившийся кадр не обращается к куче: те же вызовы, что делает кадр игры при неподвижных
+// шарах (арена кадра, вектор удара Cue::computeImpactPoint, Shader::Set*, команды луз в очереди
+// отрисовки), без окна — функции GL, которые они вызывают, заменены заглушками.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <core/AllocationTracker.hpp>
+#include <core/FrameArena.hpp>
+#include <game/Cue.hpp>
+#include <render/RenderQueue.hpp>
+#include <render/Shader.hpp>
+#include "Check.hpp"
+
+namespace
+{
+    constexpr int kWarmupFrames = 3;
+    constexpr int kFrames = 200;
+
+    // Расположение uniform — по первой букве имени: достаточно, чтобы кэш Shader был непустым
+    GLint APIENTRY StubGetUniformLocation(GLuint, const GLchar *name) { return static_cast<GLint>(name[0]); }
+    void APIENTRY StubUniform1i(GLint, GLint) {}
+    void APIENTRY StubUniform1f(GLint, GLfloat) {}
+    void APIENTRY StubUniform2fv(GLint, GLsizei, const GLfloat *) {}
+    void APIENTRY StubUniform3fv(GLint, GLsizei, const GLfloat *) {}
+    void APIENTRY StubUniformMatrix4fv(GLint, GLsizei, GLboolean, const GLfloat *) {}
+    void APIENTRY StubDeleteProgram(GLuint) {}
+
+    void StubGL()
+    {
+        glad_glGetUniformLocation = StubGetUniformLocation;
+        glad_glUniform1i = StubUniform1i;
+        glad_glUniform1f = StubUniform1f;
+        glad_glUniform2fv = StubUniform2fv;
+        glad_glUniform3fv = StubUniform3fv;
+        glad_glUniformMatrix4fv = StubUniformMatrix4fv;
+        glad_glDeleteProgram = StubDeleteProgram;
+    }
+
+    // Один кадр прицеливания: как в main.cpp, только без исполнения команд
+    void Frame(FrameArena &arena, const Cue &cue, const Shader &shader, RenderQueue &queue,
+               const glm::vec3 *balls, size_t ballCount, const glm::vec3 *pockets, size_t pocketCount)
+    {
+        arena.Reset();
+
+        const glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 3.0f, 2.0f), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        const glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+        queue.Begin(view, projection);
+
+        ArenaVector<glm::vec3> positions{ArenaAllocator<glm::vec3>(arena)};
+        positions.reserve(ballCount);
+        for (size_t i = 0; i < ballCount; ++i)
+            positions.push_back(balls[i]);
+        const float radius = 0.028575f;
+        const glm::vec3 hitPoint = cue.getHitPoint(balls[0], radius);
+        const glm::vec3 impact = cue.computeImpactPoint(hitPoint, positions.data(), positions.size(), radius, 2.54f, 1.27f);
+
+        shader.SetMat4("view", view);
+        shader.SetMat4("projection", projection);
+        shader.SetVec3("lightPos", impact);
+        shader.SetVec2("uvScale", glm::vec2(1.0f));
+        shader.SetFloat("ambient", 0.2f);
+        shader.SetInt("useTexture", 0);
+        shader.SetBool("uHighlight", false);
+
+        // Лузы — как Renderer::DrawPocket
+        for (size_t i = 0; i < pocketCount; ++i)
+        {
+            DrawCommand command;
+            command.program = shader.GetID();
+            command.vao = 1;
+            command.count = 96;
+            command.model = glm::scale(glm::translate(glm::mat4(1.0f), pockets[i]), glm::vec3(0.06f, 1.0f, 0.06f));
+            command.color = glm::vec3(0.0f);
+            command.boundsCenter = pockets[i];
+            command.boundsRadius = 0.06f;
+            queue.Submit(command);
+        }
+        queue.Sort();
+    }
+}
+
+int main()
+{
+    StubGL();
+
+    // Счётчик действительно подменяет operator new — иначе проверка ниже ничего не значит
+    const uint64_t before = AllocationTracker::Allocations();
+    delete new int(1);
+    CHECK(AllocationTracker::Allocations() == before + 1);
+
+    glm::vec3 balls[16];
+    for (int i = 0; i < 16; ++i)
+        balls[i] = glm::vec3(-0.6f + 0.07f * (i % 5), 0.028575f, -0.3f + 0.07f * (i / 5));
+    const glm::vec3 pockets[6] = {{-1.27f, 0.0f, -0.635f}, {0.0f, 0.0f, -0.635f}, {1.27f, 0.0f, -0.635f},
+                                  {-1.27f, 0.0f, 0.635f},  {0.0f, 0.0f, 0.635f},  {1.27f, 0.0f, 0.635f}};
+
+    FrameArena arena;
+    Cue cue;
+    Shader shader;
+    RenderQueue queue;
+
+    uint64_t steadyAllocations = 0;
+    for (int frame = 0; frame < kWarmupFrames + kFrames; ++frame)
+    {
+        const uint64_t start = AllocationTracker::Allocations();
+        Frame(arena, cue, shader, queue, balls, 16, pockets, 6);
+        const uint64_t allocations = AllocationTracker::Allocations() - start;
+        if (frame >= kWarmupFrames)
+            steadyAllocations += allocations;
+        else
+            CHECK(queue.Commands().size() > 0); // Кадр действительно что-то отправил
+    }
+    std::cout << "[FrameAllocationTest] " << steadyAllocations << " heap allocations in " << kFrames
+              << " steady-state frames" << std::endl;
+    CHECK(steadyAllocations == 0);
+
+    return TestResult("FrameAllocationTest");
+}
@@ -0,0 +1,116 @@
+// Несколько потоков дописывают строки в ShotDatasetWriter, пока запись на диск стоит:
+// файл — FIFO, из которого читают только после того, как писатель исчерпал свободные блоки.
+// Все добавленные строки должны оказаться в файле.
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <game/ShotDataset.hpp>
+#include "Check.hpp"
+
+namespace
+{
+    constexpr int kProducers = 4;
+    constexpr int kRowsPerProducer = ShotDataset::kChunkRows + 1000; // Больше, чем вмещают два блока вместе
+
+    // Разные от строки к строке значения, чтобы блок сжимался хуже, чем вмещает буфер канала
+    uint32_t NextRandom(uint32_t &state)
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+
+    void Produce(ShotDatasetWriter &writer, int producer, std::atomic<uint64_t> &angleSum)
+    {
+        uint32_t state = 12345u + static_cast<uint32_t>(producer);
+        std::vector<Ball> initial;
+        ShotOutcome outcome;
+        outcome.finalPositions.resize(ShotDataset::kMaxBalls);
+        uint64_t sum = 0;
+        for (int i = 0; i < kRowsPerProducer; ++i)
+        {
+            ShotParams shot;
+            shot.angle = static_cast<int32_t>(NextRandom(state) % 36000);
+            shot.power = static_cast<int32_t>(NextRandom(state) % 4096);
+            for (glm::vec3 &position : outcome.finalPositions)
+                position = glm::vec3(NextRandom(state) / 65536.0f, 0.0f, NextRandom(state) / 65536.0f);
+            outcome.duration = NextRandom(state) / 4096.0f;
+            writer.Append(initial, shot, outcome);
+            sum += static_cast<uint64_t>(shot.angle);
+        }
+        angleSum += sum;
+    }
+}
+
+int main()
+{
+    const std::string base = "/tmp/billiards_dataset_test_" + std::to_string(getpid());
+    const std::string fifoPath = base + ".fifo";
+    const std::string copyPath = base + ".bsds";
+    std::remove(fifoPath.c_str());
+    if (mkfifo(fifoPath.c_str(), 0600) != 0)
+    {
+        std::cerr << "mkfifo failed: " << fifoPath << std::endl;
+        return 1;
+    }
+
+    // Читатель открывает канал сразу (иначе Open писателя не вернётся), но читает только по сигналу
+    std::atomic<bool> release{false};
+    std::thread reader([&]
+                       {
+        std::ifstream in(fifoPath, std::ios::binary);
+        while (!release.load())
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::ofstream out(copyPath, std::ios::binary | std::ios::trunc);
+        out << in.rdbuf(); });
+
+    ShotDatasetWriter writer;
+    // Один блок в очереди: всего два, третий заполненный блок ждёт записи первого
+    CHECK(writer.Open(fifoPath, 1));
+
+    std::atomic<uint64_t> angleSum{0};
+    std::vector<std::thread> producers;
+    for (int i = 0; i < kProducers; ++i)
+        producers.emplace_back(Produce, std::ref(writer), i, std::ref(angleSum));
+
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (writer.Stalls() == 0 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    // Пока писатель стоит, остальные потоки успевают упереться в отсутствие текущего блока
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    CHECK(writer.Stalls() > 0);
+
+    release = true;
+    for (std::thread &producer : producers)
+        producer.join();
+    CHECK(writer.Close());
+    reader.join();
+
+    const uint64_t appended = static_cast<uint64_t>(kProducers) * kRowsPerProducer;
+    CHECK(writer.Rows() == appended);
+
+    ShotDatasetReader datasetReader;
+    CHECK(datasetReader.Open(copyPath));
+    std::vector<uint32_t> values;
+    uint32_t chunkRows = 0;
+    uint64_t rowsRead = 0;
+    uint64_t angleRead = 0;
+    while (datasetReader.NextChunk(values, chunkRows))
+    {
+        for (uint32_t row = 0; row < chunkRows; ++row)
+            angleRead += values[ShotDataset::ShotAngle * chunkRows + row];
+        rowsRead += chunkRows;
+    }
+    CHECK(rowsRead == appended);
+    CHECK(angleRead == angleSum.load());
+
+    std::remove(fifoPath.c_str());
+    std::remove(copyPath.c_str());
+    return TestResult("ShotDatasetTest");
+}
@@ -0,0 +1,141 @@
+// Прогон с отменой (флаг не взведён) совпадает с обычным Simulate: итоговые положения, забитые
+// шары, первое касание и обе траектории — с точками поворота и точкой у устья лузы.
+// ShotPreview в фоне публикует тот же результат (с новой ревизией и вызовом onPublished)
+// и прячет его, если расстановка изменилась.
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <game/ShotPreview.hpp>
+#include "Check.hpp"
+
+namespace
+{
+    constexpr float kBallRadius = 0.05f;
+    constexpr float kBallMass = 1.0f;
+    constexpr float kFriction = 0.1f;
+
+    bool SameOutcome(const ShotOutcome &a, const ShotOutcome &b)
+    {
+        return a.finalPositions == b.finalPositions && a.pocketedMask == b.pocketedMask &&
+               a.firstContact == b.firstContact && a.collisions == b.collisions && a.duration == b.duration &&
+               a.cuePath == b.cuePath && a.objectPath == b.objectPath;
+    }
+
+    // Прогон через перегрузку с отменой, флаг не взведён
+    bool SimulateCancellable(const ShotSimulator &simulator, const std::vector<Ball> &balls, const ShotParams &shot,
+                             ShotOutcome &outcome)
+    {
+        std::atomic<bool> cancel{false};
+        return simulator.Simulate(balls, shot, outcome, &cancel);
+    }
+
+    // Прицельный шар стоит на диагонали к правой верхней лузе, биток — за ним на той же линии
+    std::vector<Ball> CornerShotBalls()
+    {
+        std::vector<Ball> balls;
+        balls.emplace_back(glm::vec3(0.45f, kBallRadius, -0.05f), kBallRadius, kBallMass);
+        balls.emplace_back(glm::vec3(0.65f, kBallRadius, 0.15f), kBallRadius, kBallMass);
+        return balls;
+    }
+}
+
+int main()
+{
+    const TableGeometry table;
+    const ShotSimulator simulator(table, kFriction, Cue().getMaxForce());
+
+    // Разбой и удары под разными углами: каждый прогон с отменой равен обычному
+    const std::vector<Ball> rack = RackBalls(kBallRadius, kBallMass);
+    bool objectMoved = false;
+    for (int32_t angle = -1500; angle <= 1500; angle += 500)
+    {
+        for (int32_t power = 64; power <= 256; power += 96)
+        {
+            ShotParams shot;
+            shot.angle = angle;
+            shot.power = power;
+            const ShotOutcome plain = simulator.Simulate(rack, shot);
+            ShotOutcome cancellable;
+            CHECK(SimulateCancellable(simulator, rack, shot, cancellable));
+            CHECK(SameOutcome(plain, cancellable));
+            CHECK(plain.cuePath.size() <= ShotOutcome::kMaxPathPoints);
+            CHECK(plain.objectPath.size() <= ShotOutcome::kMaxPathPoints);
+            objectMoved = objectMoved || plain.objectPath.size() > 2;
+        }
+    }
+    CHECK(objectMoved);
+
+    // Прямой удар в угловую лузу: траектория прицельного шара кончается у устья, а не на kPocketedPosition
+    const std::vector<Ball> corner = CornerShotBalls();
+    ShotParams cornerShot;
+    cornerShot.angle = 4500;
+    cornerShot.power = 128;
+    const ShotOutcome plain = simulator.Simulate(corner, cornerShot);
+    ShotOutcome cancellable;
+    CHECK(SimulateCancellable(simulator, corner, cornerShot, cancellable));
+    CHECK(SameOutcome(plain, cancellable));
+    CHECK(plain.firstContact == 1);
+    CHECK((plain.pocketedMask & 2u) != 0);
+    CHECK(plain.objectPath.size() >= 2);
+    if (!plain.objectPath.empty())
+    {
+        const glm::vec3 mouth = plain.objectPath.back();
+        const glm::vec3 pocket(0.95f, 0.01f, 0.45f);
+        CHECK(glm::length(glm::vec2(mouth.x - pocket.x, mouth.z - pocket.z)) < table.pocketRadius + kBallRadius);
+    }
+
+    // Взведённый флаг прерывает прогон
+    {
+        std::atomic<bool> cancel{true};
+        ShotOutcome outcome;
+        CHECK(!simulator.Simulate(rack, cornerShot, outcome, &cancel));
+    }
+
+    // Фоновый предпросмотр: в конце концов тот же результат, что у обычного прогона
+    ShotOutcomeCache cache;
+    std::atomic<int> wakeups{0};
+    ShotPreview preview(simulator, cache, [&wakeups] { ++wakeups; });
+    CHECK(preview.Revision() == 0);
+    preview.Start();
+    for (int32_t angle = 0; angle < 3000; angle += 10)
+    {
+        ShotParams aim;
+        aim.angle = angle;
+        aim.power = 200;
+        preview.Request(rack, aim);
+    }
+    ShotParams aim;
+    aim.angle = 0;
+    aim.power = 200;
+    preview.Request(rack, aim);
+    const ShotOutcome expected = simulator.Simulate(rack, aim);
+
+    std::shared_ptr<const ShotOutcome> latest;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        latest = preview.Latest();
+        // Вызов onPublished идёт сразу после публикации — ждём и его
+        if (latest && SameOutcome(*latest, expected) && wakeups.load() > 0)
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(latest != nullptr);
+    CHECK(latest && SameOutcome(*latest, expected));
+    // Каждая публикация будит поток интерфейса и меняет ревизию
+    CHECK(preview.Revision() > 0);
+    CHECK(wakeups.load() > 0);
+
+    // Шар сдвинут — прежний результат не показывается
+    std::vector<Ball> moved = rack;
+    moved[5].setPosition(moved[5].getPosition() + glm::vec3(0.1f, 0.0f, 0.0f));
+    preview.Request(moved, aim);
+    CHECK(preview.Latest() == nullptr);
+    preview.Stop();
+
+    return TestResult("ShotPreviewTest");
+}